@@ -12,6 +12,10 @@
 #include "scheduler.h"
 #include "timer_manager.h"
 
+#if !RTOS_USE_TIMERS
+#error "led_blink_example.c needs RTOS_USE_TIMERS (full profile)"
+#endif
+
 /* Example GPIO definitions (simulated) */
 #define LED1_PIN        (1 << 0)
 #define LED2_PIN        (1 << 1)
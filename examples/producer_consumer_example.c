@@ -12,6 +12,11 @@
 #include "task_manager.h"
 #include "queue_manager.h"
 #include "scheduler.h"
+#include "timer_manager.h"
+
+#if !RTOS_USE_SEMAPHORES
+#error "producer_consumer_example.c needs RTOS_USE_SEMAPHORES (full profile)"
+#endif
 
 /* Example data structure */
 typedef struct {
@@ -29,9 +34,9 @@ void producer_task(void);
 void consumer_task(void);
 void monitor_task(void);
 
-/* Semaphore IDs */
-#define MUTEX_SEMAPHORE     0
+/* Semaphore and mutex IDs */
 #define COUNT_SEMAPHORE     1
+#define STATS_MUTEX         0
 
 /**
  * @brief Initialize producer-consumer example
@@ -39,11 +44,11 @@ void monitor_task(void);
 void producer_consumer_example_init(void)
 {
     /* Create message queue for data packets */
-    queue_create(QUEUE_1, 8);  /* Queue with 8 slots */
+    queue_create_sized(QUEUE_1, 8, sizeof(data_packet_t));  /* Queue with 8 packet slots */
     
-    /* Create semaphores */
-    semaphore_create(MUTEX_SEMAPHORE, 1, 1);       /* Mutex semaphore */
+    /* Create semaphore and mutex */
     semaphore_create(COUNT_SEMAPHORE, 0, 10);      /* Counting semaphore */
+    mutex_create(STATS_MUTEX);                     /* Guards the shared counters */
     
     /* Create tasks */
     task_create(producer_task, "Producer", PRIORITY_MEDIUM, 512);
@@ -58,20 +63,25 @@ void producer_consumer_example_init(void)
  */
 void producer_task(void)
 {
-    data_packet_t packet;
+    data_packet_t* packet;
+    uint32_t data_value;
     
     while(1)
     {
-        /* Prepare data packet */
-        packet.sequence_number = ++producer_sequence;
-        packet.data_value = producer_sequence * 100 + (producer_sequence % 50);
-        packet.timestamp = timer_get_uptime_ms();
+        ++producer_sequence;
+        data_value = producer_sequence * 100 + (producer_sequence % 50);
         
-        /* Try to send packet to queue */
-        if(queue_send(QUEUE_1, &packet, 100) == QUEUE_SUCCESS)
+        /* Build the packet directly in a queue slot (zero-copy) */
+        if(queue_send_reserve(QUEUE_1, (void**)&packet) == QUEUE_SUCCESS)
         {
+            packet->sequence_number = producer_sequence;
+            packet->data_value = data_value;
+            packet->timestamp = timer_get_uptime_ms();
+            
+            queue_send_commit(QUEUE_1);
+            
             DEBUG_PRINT("Producer: Sent packet #%ld (value: %ld)\n", 
-                       packet.sequence_number, packet.data_value);
+                       producer_sequence, data_value);
             
             /* Signal counting semaphore */
             semaphore_give(COUNT_SEMAPHORE);
@@ -79,7 +89,7 @@ void producer_task(void)
         else
         {
             DEBUG_PRINT("Producer: Queue full, dropping packet #%ld\n", 
-                       packet.sequence_number);
+                       producer_sequence);
         }
         
         /* Produce at different rates based on sequence number */
@@ -99,7 +109,8 @@ void producer_task(void)
  */
 void consumer_task(void)
 {
-    data_packet_t packet;
+    data_packet_t* packet;
+    uint32_t sequence_number;
     uint32_t processing_time;
     
     while(1)
@@ -108,31 +119,35 @@ void consumer_task(void)
         if(semaphore_take(COUNT_SEMAPHORE, 1000) == RTOS_SUCCESS)
         {
             /* Take mutex before accessing shared resources */
-            if(semaphore_take(MUTEX_SEMAPHORE, 100) == RTOS_SUCCESS)
+            if(mutex_lock(STATS_MUTEX, 100) == RTOS_SUCCESS)
             {
-                /* Receive packet from queue */
-                if(queue_receive(QUEUE_1, &packet, 0) == QUEUE_SUCCESS)
+                /* Read packet in place from the queue */
+                if(queue_receive_borrow(QUEUE_1, (void**)&packet) == QUEUE_SUCCESS)
                 {
                     consumer_count++;
                     
                     /* Simulate processing time based on data value */
-                    processing_time = 20 + (packet.data_value % 30);
+                    sequence_number = packet->sequence_number;
+                    processing_time = 20 + (packet->data_value % 30);
                     
                     DEBUG_PRINT("Consumer: Processing packet #%ld (value: %ld, delay: %ld ms)\n",
-                               packet.sequence_number, packet.data_value, processing_time);
+                               sequence_number, packet->data_value, processing_time);
+                    
+                    /* Done with the slot */
+                    queue_receive_release(QUEUE_1);
                     
                     /* Release mutex */
-                    semaphore_give(MUTEX_SEMAPHORE);
+                    mutex_unlock(STATS_MUTEX);
                     
                     /* Simulate processing */
                     task_delay(processing_time);
                     
-                    DEBUG_PRINT("Consumer: Completed packet #%ld\n", packet.sequence_number);
+                    DEBUG_PRINT("Consumer: Completed packet #%ld\n", sequence_number);
                 }
                 else
                 {
                     /* Release mutex on error */
-                    semaphore_give(MUTEX_SEMAPHORE);
+                    mutex_unlock(STATS_MUTEX);
                     DEBUG_PRINT("Consumer: Error receiving packet\n");
                 }
             }
@@ -159,7 +174,7 @@ void monitor_task(void)
     while(1)
     {
         /* Take mutex for safe reading */
-        if(semaphore_take(MUTEX_SEMAPHORE, 500) == RTOS_SUCCESS)
+        if(mutex_lock(STATS_MUTEX, 500) == RTOS_SUCCESS)
         {
             DEBUG_PRINT("=== Producer-Consumer Statistics ===\n");
             DEBUG_PRINT("Produced: %ld packets (+%ld)\n", 
@@ -195,7 +210,7 @@ void monitor_task(void)
             last_consumer_count = consumer_count;
             
             /* Release mutex */
-            semaphore_give(MUTEX_SEMAPHORE);
+            mutex_unlock(STATS_MUTEX);
         }
         else
         {
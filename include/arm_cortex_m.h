@@ -17,21 +17,67 @@
  * ARM CORTEX-M SPECIFIC DEFINITIONS
  * ============================================================================ */
 
+/* Every core register goes through CORTEX_M_REG, so the host port
+ * (RTOS_PORT_POSIX) can back them with a simulated register file */
+#if RTOS_PORT_POSIX
+#define CORTEX_M_REG(addr)      (*cortex_m_host_reg(addr))
+#else
+#define CORTEX_M_REG(addr)      (*((volatile uint32_t*)(addr)))
+#endif
+
 /* Interrupt control and state register */
-#define NVIC_INT_CTRL_REG       (*((volatile uint32_t*)0xE000ED04))
+#define NVIC_INT_CTRL_REG       CORTEX_M_REG(0xE000ED04)
 #define NVIC_PENDSVSET          0x10000000
+#define NVIC_VECTACTIVE_MASK    0x000001FF
 
 /* System control block registers */
-#define NVIC_SYSPRI2_REG        (*((volatile uint32_t*)0xE000ED20))
-#define NVIC_SYSPRI3_REG        (*((volatile uint32_t*)0xE000ED24))
-#define NVIC_PENDSV_PRI         (0xFF << 16)
-#define NVIC_SYSTICK_PRI        (0xFF << 24)
+#define NVIC_SYSPRI2_REG        CORTEX_M_REG(0xE000ED1C)    /* SHPR2 */
+#define NVIC_SYSPRI3_REG        CORTEX_M_REG(0xE000ED20)    /* SHPR3 */
+#define SCB_SHCSR_REG           CORTEX_M_REG(0xE000ED24)
+#define SCB_SHCSR_MEMFAULTENA   (1UL << 16)
+#define NVIC_PENDSV_PRI         (0xFFUL << 16)
+#define NVIC_SYSTICK_PRI        (0xFFUL << 24)
 
 /* SysTick timer registers */
-#define SYSTICK_CTRL_REG        (*((volatile uint32_t*)0xE000E010))
-#define SYSTICK_LOAD_REG        (*((volatile uint32_t*)0xE000E014))
-#define SYSTICK_VAL_REG         (*((volatile uint32_t*)0xE000E018))
-#define SYSTICK_CALIB_REG       (*((volatile uint32_t*)0xE000E01C))
+#define SYSTICK_CTRL_REG        CORTEX_M_REG(0xE000E010)
+#define SYSTICK_LOAD_REG        CORTEX_M_REG(0xE000E014)
+#define SYSTICK_VAL_REG         CORTEX_M_REG(0xE000E018)
+#define SYSTICK_CALIB_REG       CORTEX_M_REG(0xE000E01C)
+
+/* Debug exception and monitor control register */
+#define COREDEBUG_DEMCR_REG     CORTEX_M_REG(0xE000EDFC)
+#define COREDEBUG_DEMCR_TRCENA  (1UL << 24)     /* Enable DWT/ITM */
+
+/* Data watchpoint and trace unit */
+#define DWT_CTRL_REG            CORTEX_M_REG(0xE0001000)
+#define DWT_CYCCNT_REG          CORTEX_M_REG(0xE0001004)
+#define DWT_CTRL_CYCCNTENA      (1UL << 0)      /* Enable the cycle counter */
+
+/* Memory protection unit */
+#define MPU_TYPE_REG            CORTEX_M_REG(0xE000ED90)
+#define MPU_CTRL_REG            CORTEX_M_REG(0xE000ED94)
+#define MPU_RNR_REG             CORTEX_M_REG(0xE000ED98)
+#define MPU_RBAR_REG            CORTEX_M_REG(0xE000ED9C)
+#define MPU_RASR_REG            CORTEX_M_REG(0xE000EDA0)
+#define MPU_TYPE_DREGION(type)  (((type) >> 8) & 0xFF)  /* Number of regions */
+#define MPU_CTRL_ENABLE         (1UL << 0)
+#define MPU_CTRL_PRIVDEFENA     (1UL << 2)      /* Default map for everything else */
+#define MPU_RASR_ENABLE         (1UL << 0)
+#define MPU_RASR_SIZE(log2)     (((log2) - 1) << 1)
+#define MPU_RASR_AP_NONE        (0UL << 24)     /* AP = 000: no access at all */
+#define MPU_RASR_XN             (1UL << 28)     /* Execute never */
+#define MPU_STACK_GUARD_LOG2    5
+#define MPU_STACK_GUARD_SIZE    (1UL << MPU_STACK_GUARD_LOG2)   /* Smallest region: 32 bytes */
+
+/* Instrumentation trace macrocell (SWO stimulus ports) */
+#define ITM_PORT_REG(n)         CORTEX_M_REG(0xE0000000 + 4 * (n))   /* Reads 1 when ready */
+#define ITM_TER_REG             CORTEX_M_REG(0xE0000E00)
+#define ITM_TCR_REG             CORTEX_M_REG(0xE0000E80)
+#define ITM_TCR_ITMENA          (1UL << 0)
+
+/* Initial exception frame values for a new task */
+#define CORTEX_M_INITIAL_XPSR   0x01000000      /* Thumb state bit */
+#define CORTEX_M_START_ADDR_MASK 0xFFFFFFFE     /* PC must have bit 0 clear */
 
 /* SysTick control bits */
 #define SYSTICK_ENABLE          (1 << 0)
@@ -39,12 +85,91 @@
 #define SYSTICK_CLKSOURCE       (1 << 2)
 #define SYSTICK_COUNTFLAG       (1 << 16)
 
+/* Frequency DWT_CYCCNT_REG counts at (the host port counts nanoseconds) */
+#if RTOS_PORT_POSIX
+#define CORTEX_M_CYCLE_HZ       1000000000UL
+#else
+#define CORTEX_M_CYCLE_HZ       SYSTEM_CLOCK_HZ
+#endif
+
+#if RTOS_PORT_POSIX
+/* ============================================================================
+ * HOST (POSIX) PORT
+ * ============================================================================ */
+/* Tasks run on ucontext stacks of this size; the kernel-allocated stack is
+ * still painted and checked, but only the host stack is executed on */
+#define CORTEX_M_HOST_STACK_SIZE    (256 * 1024)
+
+/* PRIMASK and BASEPRI as seen by the simulated core */
+extern volatile uint32_t cortex_m_host_primask;
+extern volatile uint32_t cortex_m_host_basepri;
+
+/**
+ * @brief Get the simulated register at a core peripheral address
+ * @param addr Register address (SCS, DWT or ITM)
+ * @return volatile uint32_t* Register storage; reading DWT CYCCNT through it
+ *         returns the host monotonic clock in nanoseconds
+ */
+volatile uint32_t* cortex_m_host_reg(uint32_t addr);
+
+/**
+ * @brief Take pending SysTick/PendSV exceptions if nothing masks them
+ * @note Called whenever PRIMASK or BASEPRI drops, like the core would
+ */
+void cortex_m_host_service(void);
+
+/**
+ * @brief Sleep until the SysTick period ends
+ * @note Time is virtual: the counter runs straight to zero and pends the
+ *       SysTick exception. Returns at once if SysTick is stopped.
+ */
+void cortex_m_host_wfi(void);
+
+/**
+ * @brief Give a task its host execution context
+ * @param task_id Task ID (indexes the context table)
+ * @param entry Function first run when the task is switched in
+ * @param arg Argument for entry
+ */
+void cortex_m_host_task_init(uint8_t task_id, void (*entry)(void*), void* arg);
+
+/**
+ * @brief End the host process (e.g. when a benchmark run completes)
+ * @param status Process exit status
+ */
+void cortex_m_host_exit(int status);
+#endif /* RTOS_PORT_POSIX */
+
 /* ============================================================================
  * INLINE ASSEMBLY FUNCTIONS
  * ============================================================================ */
 
+#if RTOS_PORT_POSIX
+/* Host port: interrupt masking and sleep act on the simulated core */
+static inline uint32_t __disable_irq(void)
+{
+    uint32_t result = cortex_m_host_primask;
+    cortex_m_host_primask = 1;
+    return result;
+}
+
+static inline void __enable_irq(void)
+{
+    cortex_m_host_primask = 0;
+    cortex_m_host_service();
+}
+
+static inline void __WFI(void) { cortex_m_host_wfi(); }
+static inline void __WFE(void) { cortex_m_host_wfi(); }
+static inline void __SEV(void) { }
+static inline void __NOP(void) { }
+static inline uint32_t __CLZ(uint32_t value) { return (value != 0) ? (uint32_t)__builtin_clz(value) : 32; }
+static inline void __DMB(void) { __sync_synchronize(); }
+#define __CLZ __CLZ
+#define __DMB __DMB
+
 /* Only define these functions if they're not already provided by the compiler */
-#ifndef __ARMCC_VERSION
+#elif !defined(__ARMCC_VERSION)
 
 /**
  * @brief Disable interrupts and return previous state
@@ -100,6 +225,110 @@ static inline void __NOP(void)
 
 #endif /* __ARMCC_VERSION */
 
+#ifndef __CLZ
+/**
+ * @brief Count leading zeros (single CLZ instruction on Cortex-M3)
+ * @param value Value to scan
+ * @return uint32_t Number of leading zero bits (32 if value is 0)
+ */
+static inline uint32_t __CLZ(uint32_t value)
+{
+    uint32_t result;
+    __asm volatile ("CLZ %0, %1" : "=r" (result) : "r" (value));
+    return result;
+}
+#endif /* __CLZ */
+
+#ifndef __DMB
+/**
+ * @brief Data memory barrier (orders memory accesses, also a compiler barrier)
+ */
+static inline void __DMB(void)
+{
+    __asm volatile ("DMB 0xF" : : : "memory");
+}
+#endif /* __DMB */
+
+/* ============================================================================
+ * CRITICAL SECTIONS (BASEPRI)
+ * ============================================================================ */
+
+/* Critical-section depth, shared by tasks and ISRs. Only changed with
+ * BASEPRI raised, so no kernel-aware interrupt can observe it mid-update. */
+extern volatile uint32_t cortex_m_critical_nesting;
+
+/* RTOS_MAX_SYSCALL_BASEPRI as data, for PendSV_Handler (startup_ARMCM3.s) */
+extern const uint32_t cortex_m_syscall_basepri;
+
+/**
+ * @brief Read BASEPRI
+ * @return uint32_t Current BASEPRI (0 = nothing masked)
+ */
+static inline uint32_t cortex_m_get_basepri(void)
+{
+#if RTOS_PORT_POSIX
+    return cortex_m_host_basepri;
+#else
+    uint32_t result;
+    __asm volatile ("MRS %0, BASEPRI" : "=r" (result));
+    return result;
+#endif
+}
+
+/**
+ * @brief Write BASEPRI
+ * @param basepri New value (0 = nothing masked)
+ */
+static inline void cortex_m_set_basepri(uint32_t basepri)
+{
+#if RTOS_PORT_POSIX
+    cortex_m_host_basepri = basepri;
+    if(basepri == 0)
+    {
+        cortex_m_host_service();
+    }
+#else
+    __asm volatile ("MSR BASEPRI, %0\n\tDSB\n\tISB" : : "r" (basepri) : "memory");
+#endif
+}
+
+/**
+ * @brief Mask kernel-aware interrupts and return the previous BASEPRI
+ * @return uint32_t Value to pass back to cortex_m_set_basepri()
+ * @note For code that must not touch the nesting count (e.g. inside PendSV)
+ */
+static inline uint32_t cortex_m_raise_basepri(void)
+{
+    uint32_t previous = cortex_m_get_basepri();
+    cortex_m_set_basepri(RTOS_MAX_SYSCALL_BASEPRI);
+    return previous;
+}
+
+/**
+ * @brief Enter a (nestable) critical section
+ */
+static inline void cortex_m_critical_enter(void)
+{
+    cortex_m_set_basepri(RTOS_MAX_SYSCALL_BASEPRI);
+    cortex_m_critical_nesting++;
+}
+
+/**
+ * @brief Leave a critical section; unmasks only when the outermost one ends
+ */
+static inline void cortex_m_critical_exit(void)
+{
+    if(cortex_m_critical_nesting == 0)
+    {
+        return; /* Unbalanced exit */
+    }
+    
+    if(--cortex_m_critical_nesting == 0)
+    {
+        cortex_m_set_basepri(0);
+    }
+}
+
 /* ============================================================================
  * FUNCTION PROTOTYPES
  * ============================================================================ */
@@ -132,11 +361,46 @@ void cortex_m_systick_stop(void);
  */
 void cortex_m_trigger_pendsv(void);
 
+/**
+ * @brief Check whether the CPU is executing an exception handler
+ * @return bool True in handler mode (ISR), false in thread mode
+ */
+bool cortex_m_in_interrupt(void);
+
 /**
  * @brief Set priority for PendSV and SysTick interrupts
  */
 void cortex_m_set_interrupt_priorities(void);
 
+/**
+ * @brief Turn on the MPU with the default memory map as background
+ * @return rtos_result_t Success, or RTOS_ERROR if the core has no MPU
+ * @note Also enables the MemManage fault so guard hits do not escalate
+ *       to HardFault
+ */
+rtos_result_t cortex_m_mpu_init(void);
+
+/**
+ * @brief Program a no-access guard region
+ * @param region MPU region number
+ * @param base Guard start (MPU_STACK_GUARD_SIZE aligned)
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t cortex_m_mpu_set_guard(uint8_t region, const void* base);
+
+/**
+ * @brief Disable an MPU region
+ * @param region MPU region number
+ */
+void cortex_m_mpu_clear_region(uint8_t region);
+
+/**
+ * @brief Enable the DWT cycle counter
+ * @note CYCCNT counts core clock cycles and wraps every 2^32 cycles. Safe to
+ *       call again: the count is never reset, so earlier stamps stay valid.
+ */
+void cortex_m_cycle_counter_init(void);
+
 /**
  * @brief Get current stack pointer
  * @return uint32_t Current stack pointer value
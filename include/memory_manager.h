@@ -16,11 +16,72 @@
 /* ============================================================================
  * MEMORY CONFIGURATION
  * ============================================================================ */
-#define MEMORY_ALIGNMENT            4       /* Memory alignment in bytes */
+#if RTOS_PORT_POSIX
+/* Host port: block headers and pool free links hold 64-bit pointers */
+#define MEMORY_ALIGNMENT_LOG2       3
+#define MIN_BLOCK_SIZE              32      /* Minimum block size (>= sizeof(memory_block_t)) */
+#else
+#define MEMORY_ALIGNMENT_LOG2       2
 #define MIN_BLOCK_SIZE              16      /* Minimum allocation size */
+#endif
+#define MEMORY_ALIGNMENT            (1 << MEMORY_ALIGNMENT_LOG2)    /* Memory alignment in bytes */
 #define MEMORY_MAGIC_FREE           0xDEAD  /* Magic number for free blocks */
 #define MEMORY_MAGIC_USED           0xBEEF  /* Magic number for used blocks */
 
+/* Allocator selection */
+#define MEMORY_ALLOCATOR_FIRST_FIT  0       /* Single free list, first fit */
+#define MEMORY_ALLOCATOR_TLSF       1       /* Two-level segregated fit, O(1) */
+#define MEMORY_ALLOCATOR            MEMORY_ALLOCATOR_TLSF
+
+/* TLSF size classes: first level by power of two, second level splits each
+ * power of two into MEMORY_TLSF_SL_COUNT linear ranges */
+#define MEMORY_TLSF_SL_LOG2         2       /* 4 second-level lists per class */
+#define MEMORY_TLSF_SL_COUNT        (1UL << MEMORY_TLSF_SL_LOG2)
+#define MEMORY_TLSF_FL_SHIFT        (MEMORY_TLSF_SL_LOG2 + MEMORY_ALIGNMENT_LOG2)
+#define MEMORY_TLSF_SMALL_BLOCK     (1UL << MEMORY_TLSF_FL_SHIFT)
+#define MEMORY_TLSF_FL_MAX          12      /* Largest block class: 2^12 bytes */
+#define MEMORY_TLSF_FL_COUNT        (MEMORY_TLSF_FL_MAX - MEMORY_TLSF_FL_SHIFT + 2)
+
+/* First-fit size classes (statistics bitmap only): class n holds free blocks
+ * of 2^n to 2^(n+1)-1 bytes */
+#define MEMORY_FF_CLASS_COUNT       16      /* memory_block_t.size is 16 bits */
+
+/* Heap regions: the built-in heap[] is always region MEMORY_REGION_HEAP,
+ * further address ranges (CCM/TCM, external RAM) join via memory_add_region() */
+#define MAX_MEMORY_REGIONS          3       /* Maximum number of heap regions */
+#define MEMORY_REGION_INVALID_ID    0xFF    /* Invalid region ID */
+#define MEMORY_REGION_HEAP          0       /* Region ID of the built-in heap */
+
+/* Region attributes */
+#define MEMORY_REGION_ATTR_FAST     (1UL << 0)  /* Zero-wait-state (TCM, CCM, on-chip SRAM) */
+#define MEMORY_REGION_ATTR_DMA      (1UL << 1)  /* Reachable by DMA masters */
+#define MEMORY_REGION_ATTR_EXTERNAL (1UL << 2)  /* Off-chip RAM behind the memory controller */
+#define MEMORY_HEAP_ATTRS           (MEMORY_REGION_ATTR_FAST | MEMORY_REGION_ATTR_DMA)
+
+/* Largest region a single memory_block_t can describe */
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+#define MEMORY_REGION_MAX_SIZE      ((1UL << (MEMORY_TLSF_FL_MAX + 1)) - MEMORY_ALIGNMENT)
+#else
+#define MEMORY_REGION_MAX_SIZE      (0x10000UL - MEMORY_ALIGNMENT)
+#endif
+
+/* Fixed-size block pools */
+#define MAX_MEMORY_POOLS            8       /* Maximum number of block pools (object tables use one each) */
+#define POOL_INVALID_ID             0xFF    /* Invalid pool ID */
+
+/* Block size actually used by a pool: aligned and big enough for the free link */
+#define POOL_BLOCK_SIZE(size)       ((((size) < sizeof(void*) ? sizeof(void*) : (size)) + MEMORY_ALIGNMENT - 1) & ~(MEMORY_ALIGNMENT - 1))
+
+/* Bytes needed for a caller-provided pool region */
+#define POOL_REGION_SIZE(size, count) (POOL_BLOCK_SIZE(size) * (count))
+
+/* Object handle tables: handle = generation << 16 | slot index. A generation
+ * is odd while its slot is live, so stale and zero handles never resolve. */
+#define OBJECT_HANDLE_INVALID       0       /* Never a valid handle */
+#define OBJECT_HANDLE_INDEX_BITS    16
+#define OBJECT_HANDLE_INDEX_MASK    ((1UL << OBJECT_HANDLE_INDEX_BITS) - 1)
+#define OBJECT_TABLE_MAX_CAPACITY   OBJECT_HANDLE_INDEX_MASK
+
 /* ============================================================================
  * MEMORY BLOCK STRUCTURE
  * ============================================================================ */
@@ -29,13 +90,46 @@ typedef struct memory_block {
     uint16_t size;                          /* Block size including header */
     struct memory_block* next;              /* Next block in list */
     struct memory_block* prev;              /* Previous block in list */
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+    struct memory_block* prev_phys;         /* Physically preceding block (boundary tag) */
+#endif
 } memory_block_t;
 
+/* ============================================================================
+ * MEMORY REGION STRUCTURES
+ * ============================================================================ */
+typedef struct {
+    uint8_t region_id;                      /* Region identifier */
+    bool is_active;                         /* Region slot active */
+    uint32_t attrs;                         /* MEMORY_REGION_ATTR_* flags */
+    uint8_t* start;                         /* First byte of the region (aligned) */
+    uint32_t size;                          /* Region size in bytes (aligned) */
+    uint32_t used_size;                     /* Bytes in allocated blocks, headers included */
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+    uint32_t tlsf_fl_bitmap;                                             /* Non-empty first-level classes */
+    uint32_t tlsf_sl_bitmap[MEMORY_TLSF_FL_COUNT];                       /* Non-empty second-level lists */
+    memory_block_t* tlsf_free_lists[MEMORY_TLSF_FL_COUNT][MEMORY_TLSF_SL_COUNT]; /* Free list heads */
+#else
+    memory_block_t* free_list;              /* Head of free blocks list */
+    uint32_t ff_class_bitmap;               /* Bit n set = free blocks in size class n */
+    uint16_t ff_class_counts[MEMORY_FF_CLASS_COUNT]; /* Free blocks per size class */
+#endif
+} memory_region_t;
+
+typedef struct {
+    uint8_t* start;                         /* First byte of the region */
+    uint32_t size;                          /* Region size in bytes */
+    uint32_t attrs;                         /* MEMORY_REGION_ATTR_* flags */
+    uint32_t used_size;                     /* Bytes in allocated blocks, headers included */
+    uint32_t free_size;                     /* Bytes in free blocks, headers included */
+    uint32_t largest_free_block;            /* Largest allocation guaranteed to fit (size-class bound) */
+} memory_region_info_t;
+
 /* ============================================================================
  * MEMORY STATISTICS
  * ============================================================================ */
 typedef struct {
-    uint32_t total_heap_size;               /* Total heap size */
+    uint32_t total_heap_size;               /* Total heap size (all regions) */
     uint32_t free_heap_size;                /* Current free heap size */
     uint32_t used_heap_size;                /* Current used heap size */
     uint32_t min_free_heap_size;            /* Minimum free heap size reached */
@@ -43,10 +137,51 @@ typedef struct {
     uint32_t allocation_count;              /* Number of allocations */
     uint32_t free_count;                    /* Number of frees */
     uint32_t failed_allocations;            /* Number of failed allocations */
-    uint32_t largest_free_block;            /* Size of largest free block */
+    uint32_t largest_free_block;            /* Largest allocation guaranteed to fit (size-class bound) */
     uint32_t free_blocks_count;             /* Number of free blocks */
+    uint32_t fragmentation_index;           /* 0-100: share of free memory outside the largest block */
 } memory_stats_t;
 
+/* ============================================================================
+ * MEMORY POOL STRUCTURES
+ * ============================================================================ */
+typedef struct {
+    uint8_t pool_id;                        /* Pool identifier */
+    bool is_active;                         /* Pool slot active */
+    bool owns_region;                       /* Region was carved from the heap */
+    uint8_t* region;                        /* Start of block storage */
+    uint32_t block_size;                    /* Size of each block (aligned) */
+    uint32_t block_count;                   /* Number of blocks in the pool */
+    void* free_stack;                       /* Top of the intrusive free-block stack */
+    uint32_t free_blocks;                   /* Blocks currently free */
+    uint32_t min_free_blocks;               /* Lowest free count reached */
+    uint32_t allocation_count;              /* Number of allocations */
+    uint32_t free_count;                    /* Number of frees */
+    uint32_t failed_allocations;            /* Allocations on an empty pool */
+} memory_pool_t;
+
+typedef struct {
+    uint32_t block_size;                    /* Size of each block (aligned) */
+    uint32_t block_count;                   /* Number of blocks in the pool */
+    uint32_t free_blocks;                   /* Blocks currently free */
+    uint32_t min_free_blocks;               /* Lowest free count reached */
+    uint32_t allocation_count;              /* Number of allocations */
+    uint32_t free_count;                    /* Number of frees */
+    uint32_t failed_allocations;            /* Allocations on an empty pool */
+} memory_pool_stats_t;
+
+/* ============================================================================
+ * OBJECT HANDLE TABLE STRUCTURES
+ * ============================================================================ */
+typedef uint32_t object_handle_t;
+
+typedef struct {
+    uint8_t pool_id;                        /* Pool holding the objects (POOL_INVALID_ID if none) */
+    uint32_t capacity;                      /* Number of object slots */
+    uint16_t* generations;                  /* Per-slot generation counter */
+    bool owns_generations;                  /* generations came from memory_alloc() */
+} object_table_t;
+
 /* ============================================================================
  * FUNCTION PROTOTYPES
  * ============================================================================ */
@@ -54,16 +189,47 @@ typedef struct {
 /**
  * @brief Initialize the memory manager
  * @return rtos_result_t Success or error code
+ * @note Registers the built-in heap[] as region MEMORY_REGION_HEAP with
+ *       MEMORY_HEAP_ATTRS; add further RAM with memory_add_region()
  */
 rtos_result_t memory_init(void);
 
+/**
+ * @brief Add an address range to the heap as a new region
+ * @param start First byte of the range (rounded up to MEMORY_ALIGNMENT)
+ * @param size Size in bytes (at most MEMORY_REGION_MAX_SIZE after alignment)
+ * @param attrs MEMORY_REGION_ATTR_* flags describing the memory
+ * @return uint8_t Region ID (MEMORY_REGION_INVALID_ID if failed)
+ * @note Call after memory_init(); the range must not overlap another region
+ */
+uint8_t memory_add_region(void* start, uint32_t size, uint32_t attrs);
+
 /**
  * @brief Allocate memory block
  * @param size Size in bytes to allocate
  * @return void* Pointer to allocated memory or NULL if failed
+ * @note Served from regions without MEMORY_REGION_ATTR_FAST while any has
+ *       room, so fast memory is left for memory_alloc_prefer() callers
  */
 void* memory_alloc(uint32_t size);
 
+/**
+ * @brief Allocate memory block from one region only
+ * @param region_id Region ID
+ * @param size Size in bytes to allocate
+ * @return void* Pointer to allocated memory or NULL if that region is full
+ */
+void* memory_alloc_in(uint8_t region_id, uint32_t size);
+
+/**
+ * @brief Allocate memory block, preferring regions with given attributes
+ * @param attrs MEMORY_REGION_ATTR_* flags a preferred region must all have
+ * @param size Size in bytes to allocate
+ * @return void* Pointer to allocated memory or NULL if failed
+ * @note Falls back to any other region when no preferred region has room
+ */
+void* memory_alloc_prefer(uint32_t attrs, uint32_t size);
+
 /**
  * @brief Free previously allocated memory block
  * @param ptr Pointer to memory block to free
@@ -76,6 +242,9 @@ rtos_result_t memory_free(void* ptr);
  * @param ptr Pointer to existing memory block (NULL for new allocation)
  * @param new_size New size in bytes
  * @return void* Pointer to reallocated memory or NULL if failed
+ * @note Resizes in place when shrinking or when the physically next block is
+ *       free and large enough; only otherwise allocates, copies and frees,
+ *       preferring regions with the same attributes as the old block.
  */
 void* memory_realloc(void* ptr, uint32_t new_size);
 
@@ -91,6 +260,7 @@ void* memory_calloc(uint32_t num, uint32_t size);
  * @brief Get memory statistics
  * @param stats Pointer to statistics structure
  * @return rtos_result_t Success or error code
+ * @note Constant time, safe for periodic telemetry
  */
 rtos_result_t memory_get_stats(memory_stats_t* stats);
 
@@ -108,10 +278,19 @@ uint32_t memory_get_used_size(void);
 
 /**
  * @brief Get size of largest available free block
- * @return uint32_t Size of largest free block
+ * @return uint32_t Largest allocation guaranteed to succeed (lower bound of
+ *         the largest free block's size class), constant time
  */
 uint32_t memory_get_largest_free_block(void);
 
+/**
+ * @brief Get information about one heap region
+ * @param region_id Region ID
+ * @param info Pointer to information structure
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t memory_get_region_info(uint8_t region_id, memory_region_info_t* info);
+
 /**
  * @brief Check if pointer is valid allocated memory
  * @param ptr Pointer to check
@@ -153,4 +332,123 @@ void memory_print_heap_layout(void);
  */
 void memory_reset_stats(void);
 
+/* ============================================================================
+ * FUNCTION PROTOTYPES - MEMORY POOLS
+ * ============================================================================ */
+
+/**
+ * @brief Create a pool of fixed-size blocks
+ * @param region Storage for the blocks (POOL_REGION_SIZE bytes, MEMORY_ALIGNMENT
+ *               aligned), or NULL to carve it from the heap
+ * @param block_size Size of each block in bytes
+ * @param block_count Number of blocks
+ * @return uint8_t Pool ID (POOL_INVALID_ID if failed)
+ */
+uint8_t pool_create(void* region, uint32_t block_size, uint32_t block_count);
+
+/**
+ * @brief Delete a pool (returns a heap carve-out to the heap)
+ * @param pool_id Pool ID
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t pool_delete(uint8_t pool_id);
+
+/**
+ * @brief Allocate one block from a pool
+ * @param pool_id Pool ID
+ * @return void* Pointer to the block or NULL if the pool is empty
+ * @note O(1), safe to call from interrupts
+ */
+void* pool_alloc(uint8_t pool_id);
+
+/**
+ * @brief Return a block to its pool
+ * @param pool_id Pool ID
+ * @param block Block obtained from pool_alloc()
+ * @return rtos_result_t Success or error code
+ * @note O(1), safe to call from interrupts
+ */
+rtos_result_t pool_free(uint8_t pool_id, void* block);
+
+/**
+ * @brief Get pool statistics
+ * @param pool_id Pool ID
+ * @param stats Pointer to statistics structure
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t pool_get_stats(uint8_t pool_id, memory_pool_stats_t* stats);
+
+/* ============================================================================
+ * FUNCTION PROTOTYPES - OBJECT HANDLE TABLES
+ * ============================================================================ */
+
+/**
+ * @brief Create a table of fixed-size objects addressed by handles
+ * @param table Table to initialize
+ * @param object_size Size of each object in bytes
+ * @param capacity Number of objects (1 to OBJECT_TABLE_MAX_CAPACITY)
+ * @return rtos_result_t Success or error code
+ * @note Object storage is a heap-backed memory pool sized at run time,
+ *       so capacity is not a compile-time limit
+ */
+rtos_result_t object_table_create(object_table_t* table, uint32_t object_size, uint32_t capacity);
+
+/**
+ * @brief Create an object table on caller-provided storage
+ * @param table Table to initialize
+ * @param storage Object storage (POOL_REGION_SIZE(object_size, capacity) bytes,
+ *                MEMORY_ALIGNMENT aligned)
+ * @param generations Generation counters, one per slot
+ * @param object_size Size of each object in bytes
+ * @param capacity Number of objects (1 to OBJECT_TABLE_MAX_CAPACITY)
+ * @return rtos_result_t Success or error code
+ * @note No heap traffic; both buffers must outlive the table
+ */
+rtos_result_t object_table_create_static(object_table_t* table, void* storage, uint16_t* generations,
+                                         uint32_t object_size, uint32_t capacity);
+
+/**
+ * @brief Delete an object table and release its storage
+ * @param table Table to delete
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t object_table_delete(object_table_t* table);
+
+/**
+ * @brief Allocate an object
+ * @param table Object table
+ * @param handle Receives the object's handle
+ * @return void* Pointer to the (uninitialized) object, NULL if the table is full
+ * @note O(1): pops the pool's free stack and bumps the slot generation
+ */
+void* object_alloc(object_table_t* table, object_handle_t* handle);
+
+/**
+ * @brief Free an object
+ * @param table Object table
+ * @param handle Handle returned by object_alloc()
+ * @return rtos_result_t Success, or RTOS_ERROR for a stale/invalid handle
+ * @note O(1); every outstanding copy of the handle becomes stale
+ */
+rtos_result_t object_free(object_table_t* table, object_handle_t handle);
+
+/**
+ * @brief Resolve a handle to its object
+ * @param table Object table
+ * @param handle Object handle
+ * @return void* Pointer to the object, NULL if the handle is stale or invalid
+ * @note O(1), safe to call from interrupts
+ */
+void* object_get(const object_table_t* table, object_handle_t handle);
+
+/**
+ * @brief Resolve a slot index to its object
+ * @param table Object table
+ * @param index Slot index (handle & OBJECT_HANDLE_INDEX_MASK)
+ * @return void* Pointer to the object, NULL if the index is out of range or the slot is free
+ * @note O(1), safe to call from interrupts. For modules that expose the slot
+ *       index itself as a small ID; prefer object_get() where a stale ID matters.
+ */
+void* object_get_index(const object_table_t* table, uint32_t index);
+
 #endif /* MEMORY_MANAGER_H */
\ No newline at end of file
@@ -12,36 +12,91 @@
 #define QUEUE_MANAGER_H
 
 #include "rtos_config.h"
+#include "task_manager.h"
+#include "memory_manager.h"
 
 /* ============================================================================
  * QUEUE CONFIGURATION
  * ============================================================================ */
-#define QUEUE_ITEM_SIZE             sizeof(uint32_t)    /* Size of each queue item */
+#define QUEUE_ITEM_SIZE             sizeof(uint32_t)    /* Default item size (queue_create) */
+#define QUEUE_SLOT_ALIGNMENT        4                   /* Slots are aligned for in-place use */
 #define QUEUE_TIMEOUT_INFINITE      0xFFFFFFFF          /* Infinite timeout */
 
+/* Bytes of storage queue_create_static() needs (QUEUE_SLOT_ALIGNMENT aligned) */
+#define QUEUE_STATIC_BUFFER_SIZE(size, item_size) \
+    ((size) * (((item_size) + QUEUE_SLOT_ALIGNMENT - 1) & ~(QUEUE_SLOT_ALIGNMENT - 1)))
+
+/* Queues and semaphores created through handles live in run-time sized
+ * object tables (queue_manager_init_handles) rather than the fixed arrays */
+typedef object_handle_t queue_handle_t;
+typedef object_handle_t semaphore_handle_t;
+
 /* ============================================================================
  * SEMAPHORE CONFIGURATION
  * ============================================================================ */
 #define MAX_SEMAPHORES              4                   /* Maximum number of semaphores */
 #define SEMAPHORE_MAX_COUNT         255                 /* Maximum semaphore count */
 
+/* ============================================================================
+ * SPSC RING CONFIGURATION
+ * ============================================================================ */
+#define MAX_SPSC_RINGS              2                   /* Maximum number of SPSC rings */
+#define SPSC_MAX_SIZE               1024                /* Maximum items per ring (power of two) */
+
+/* ============================================================================
+ * MUTEX CONFIGURATION
+ * ============================================================================ */
+#define MAX_MUTEXES                 4                   /* Maximum number of mutexes */
+#define MUTEX_MAX_LOCK_COUNT        255                 /* Maximum recursive lock depth */
+
+/* ============================================================================
+ * EVENT GROUP CONFIGURATION
+ * ============================================================================ */
+#define MAX_EVENT_GROUPS            4                   /* Maximum number of event groups */
+
+/* event_group_wait() options */
+#define EVENT_WAIT_ANY              0x00                /* Any requested bit satisfies the wait */
+#define EVENT_WAIT_ALL              0x01                /* All requested bits must be set */
+#define EVENT_CLEAR_ON_EXIT         0x02                /* Clear the requested bits on success */
+
+/* ============================================================================
+ * QUEUE SET CONFIGURATION
+ * ============================================================================ */
+#define MAX_QUEUE_SETS              2                   /* Maximum number of queue sets */
+#define QUEUE_SET_INVALID_ID        0xFF                /* Queue/semaphore not in any set */
+
+/* Queue set member handles: a queue ID, or a semaphore ID tagged with
+ * QUEUE_SET_SEMAPHORE_FLAG */
+#define QUEUE_SET_SEMAPHORE_FLAG    0x80
+#define QUEUE_SET_MEMBER_NONE       0xFF                /* queue_set_select(): nothing became ready */
+#define QUEUE_SET_MEMBER_QUEUE(queue_id)        ((uint8_t)(queue_id))
+#define QUEUE_SET_MEMBER_SEMAPHORE(sem_id)      ((uint8_t)((sem_id) | QUEUE_SET_SEMAPHORE_FLAG))
+#define QUEUE_SET_MEMBER_IS_SEMAPHORE(member)   (((member) & QUEUE_SET_SEMAPHORE_FLAG) != 0)
+#define QUEUE_SET_MEMBER_ID(member)             ((uint8_t)((member) & ~QUEUE_SET_SEMAPHORE_FLAG))
+
 /* ============================================================================
  * QUEUE STRUCTURE
  * ============================================================================ */
 typedef struct {
     uint8_t queue_id;                   /* Queue identifier */
-    uint32_t* buffer;                   /* Queue buffer */
+    uint8_t* buffer;                    /* Queue buffer */
     uint32_t size;                      /* Queue size (number of items) */
+    uint32_t item_size;                 /* Bytes copied per item */
+    uint32_t slot_size;                 /* Bytes per slot (item_size, aligned) */
     uint32_t head;                      /* Head index */
     uint32_t tail;                      /* Tail index */
     uint32_t count;                     /* Current number of items */
     bool is_active;                     /* Queue active status */
+    bool owns_buffer;                   /* buffer came from memory_alloc() */
+    
+    /* Zero-copy slots handed out (one per direction at a time) */
+    bool send_reserved;                 /* Tail slot reserved, not yet committed */
+    bool receive_borrowed;              /* Head slot borrowed, not yet released */
+    uint8_t set_id;                     /* Queue set notified of items (QUEUE_SET_INVALID_ID if none) */
     
-    /* Waiting task lists */
-    uint8_t send_waiting_tasks[MAX_TASKS];      /* Tasks waiting to send */
-    uint8_t receive_waiting_tasks[MAX_TASKS];   /* Tasks waiting to receive */
-    uint8_t send_waiting_count;
-    uint8_t receive_waiting_count;
+    /* Waiting task lists (highest priority first) */
+    task_wait_list_t send_waiters;      /* Tasks waiting to send */
+    task_wait_list_t receive_waiters;   /* Tasks waiting to receive */
 } queue_t;
 
 /* ============================================================================
@@ -52,12 +107,68 @@ typedef struct {
     uint8_t count;                      /* Current count */
     uint8_t max_count;                  /* Maximum count */
     bool is_active;                     /* Semaphore active status */
+    uint8_t set_id;                     /* Queue set notified of gives (QUEUE_SET_INVALID_ID if none) */
     
-    /* Waiting task list */
-    uint8_t waiting_tasks[MAX_TASKS];   /* Tasks waiting for semaphore */
-    uint8_t waiting_count;              /* Number of waiting tasks */
+    /* Waiting task list (highest priority first) */
+    task_wait_list_t waiters;           /* Tasks waiting for semaphore */
 } semaphore_t;
 
+/* ============================================================================
+ * SPSC RING STRUCTURE
+ * ============================================================================ */
+/* Lock-free ring for exactly one producer and one consumer (e.g. ISR -> task).
+ * head/tail run freely and wrap naturally; each side writes only its own index. */
+typedef struct {
+    uint8_t ring_id;                    /* Ring identifier */
+    uint8_t* buffer;                    /* Ring buffer */
+    uint32_t item_size;                 /* Bytes per item */
+    uint32_t mask;                      /* size - 1 (size is a power of two) */
+    volatile uint32_t head;             /* Next item to read (consumer only) */
+    volatile uint32_t tail;             /* Next slot to write (producer only) */
+    tcb_t* volatile waiting_task;       /* Consumer sleeping in spsc_receive_wait() */
+    bool is_active;                     /* Ring active status */
+    bool owns_buffer;                   /* buffer came from memory_alloc() */
+} spsc_ring_t;
+
+/* ============================================================================
+ * MUTEX STRUCTURE
+ * ============================================================================ */
+typedef struct mutex {
+    uint8_t mutex_id;                   /* Mutex identifier */
+    bool is_active;                     /* Mutex active status */
+    tcb_t* owner;                       /* Owning task (NULL if unlocked) */
+    uint8_t lock_count;                 /* Recursive lock depth of the owner */
+    struct mutex* next_held;            /* Next mutex held by the same owner */
+    
+    /* Waiting task list (highest priority first) */
+    task_wait_list_t waiters;           /* Tasks waiting for the mutex */
+} mutex_t;
+
+/* ============================================================================
+ * EVENT GROUP STRUCTURE
+ * ============================================================================ */
+typedef struct {
+    uint8_t group_id;                   /* Event group identifier */
+    bool is_active;                     /* Event group active status */
+    uint32_t bits;                      /* Current event bits */
+    
+    /* Waiting task list (highest priority first) */
+    task_wait_list_t waiters;           /* Tasks waiting for bit combinations */
+} event_group_t;
+
+/* ============================================================================
+ * QUEUE SET STRUCTURE
+ * ============================================================================ */
+/* Members point back at their set (set_id); the set only holds the tasks
+ * blocked in queue_set_select() */
+typedef struct {
+    uint8_t set_id;                     /* Queue set identifier */
+    bool is_active;                     /* Queue set active status */
+    
+    /* Waiting task list (highest priority first) */
+    task_wait_list_t waiters;           /* Tasks waiting for any member */
+} queue_set_t;
+
 /* ============================================================================
  * FUNCTION PROTOTYPES - QUEUE MANAGEMENT
  * ============================================================================ */
@@ -69,13 +180,34 @@ typedef struct {
 rtos_result_t queue_manager_init(void);
 
 /**
- * @brief Create a message queue
+ * @brief Create a message queue of uint32_t items
  * @param queue_id Queue identifier (0-3)
  * @param size Queue size (number of items)
  * @return queue_result_t Success or error code
  */
 queue_result_t queue_create(uint8_t queue_id, uint32_t size);
 
+/**
+ * @brief Create a message queue with a custom item size
+ * @param queue_id Queue identifier (0-3)
+ * @param size Queue size (number of items)
+ * @param item_size Size of each item in bytes
+ * @return queue_result_t Success or error code
+ */
+queue_result_t queue_create_sized(uint8_t queue_id, uint32_t size, uint32_t item_size);
+
+/**
+ * @brief Create a message queue on caller-provided storage
+ * @param queue_id Queue identifier (0-3)
+ * @param size Queue size (number of items)
+ * @param item_size Size of each item in bytes
+ * @param buffer Storage of QUEUE_STATIC_BUFFER_SIZE(size, item_size) bytes,
+ *        QUEUE_SLOT_ALIGNMENT aligned
+ * @return queue_result_t Success or error code
+ * @note No heap traffic. The buffer must stay valid until queue_delete().
+ */
+queue_result_t queue_create_static(uint8_t queue_id, uint32_t size, uint32_t item_size, void* buffer);
+
 /**
  * @brief Delete a message queue
  * @param queue_id Queue identifier
@@ -88,7 +220,10 @@ queue_result_t queue_delete(uint8_t queue_id);
  * @param queue_id Queue identifier
  * @param data Pointer to data to send
  * @param timeout_ms Timeout in milliseconds (0 = no wait, QUEUE_TIMEOUT_INFINITE = wait forever)
- * @return queue_result_t Success or error code
+ * @return queue_result_t Success, QUEUE_FULL (no wait), QUEUE_TIMEOUT or
+ *         QUEUE_ERROR (queue deleted while waiting)
+ * @note A full queue suspends the caller until a receiver frees a slot and
+ *       copies the item in. ISRs and a locked scheduler never block.
  */
 queue_result_t queue_send(uint8_t queue_id, const void* data, uint32_t timeout_ms);
 
@@ -96,11 +231,43 @@ queue_result_t queue_send(uint8_t queue_id, const void* data, uint32_t timeout_m
  * @brief Receive data from queue
  * @param queue_id Queue identifier
  * @param data Pointer to buffer for received data
- * @param timeout_ms Timeout in milliseconds
- * @return queue_result_t Success or error code
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, QUEUE_TIMEOUT_INFINITE = wait forever)
+ * @return queue_result_t Success, QUEUE_EMPTY (no wait), QUEUE_TIMEOUT or
+ *         QUEUE_ERROR (queue deleted while waiting)
+ * @note An empty queue suspends the caller until a sender copies an item
+ *       straight into data. ISRs and a locked scheduler never block.
  */
 queue_result_t queue_receive(uint8_t queue_id, void* data, uint32_t timeout_ms);
 
+/**
+ * @brief Send up to count items to queue in one critical section
+ * @param queue_id Queue identifier
+ * @param items Array of count items, item_size bytes apart
+ * @param count Number of items to send
+ * @param timeout_ms Timeout in milliseconds for the first item only
+ *                   (0 = no wait, QUEUE_TIMEOUT_INFINITE = wait forever)
+ * @return uint32_t Number of items sent, from the start of items (0 on
+ *         error, timeout or a full queue with no wait)
+ * @note Items are copied with at most two memcpy() calls around the ring
+ *       wrap, and waiting receivers are serviced once per batch. Only a
+ *       completely full queue blocks; a partly full one takes what fits.
+ */
+uint32_t queue_send_batch(uint8_t queue_id, const void* items, uint32_t count, uint32_t timeout_ms);
+
+/**
+ * @brief Receive up to count items from queue in one critical section
+ * @param queue_id Queue identifier
+ * @param items Buffer for count items, item_size bytes apart
+ * @param count Maximum number of items to receive
+ * @param timeout_ms Timeout in milliseconds for the first item only
+ *                   (0 = no wait, QUEUE_TIMEOUT_INFINITE = wait forever)
+ * @return uint32_t Number of items received (0 on error, timeout or an
+ *         empty queue with no wait)
+ * @note Mirror of queue_send_batch(): only an empty queue blocks, and
+ *       waiting senders are serviced once per batch.
+ */
+uint32_t queue_receive_batch(uint8_t queue_id, void* items, uint32_t count, uint32_t timeout_ms);
+
 /**
  * @brief Peek at queue data without removing it
  * @param queue_id Queue identifier
@@ -109,6 +276,38 @@ queue_result_t queue_receive(uint8_t queue_id, void* data, uint32_t timeout_ms);
  */
 queue_result_t queue_peek(uint8_t queue_id, void* data);
 
+/**
+ * @brief Reserve the next free slot for in-place filling (zero-copy send)
+ * @param queue_id Queue identifier
+ * @param slot Receives a pointer to item_size bytes inside the queue buffer
+ * @return queue_result_t QUEUE_FULL if no slot is free or one is already reserved
+ * @note Other senders see the queue as full until queue_send_commit()
+ */
+queue_result_t queue_send_reserve(uint8_t queue_id, void** slot);
+
+/**
+ * @brief Publish the slot obtained from queue_send_reserve()
+ * @param queue_id Queue identifier
+ * @return queue_result_t Success or error code
+ */
+queue_result_t queue_send_commit(uint8_t queue_id);
+
+/**
+ * @brief Borrow the oldest item in place (zero-copy receive)
+ * @param queue_id Queue identifier
+ * @param slot Receives a pointer to the item inside the queue buffer
+ * @return queue_result_t QUEUE_EMPTY if no item is available or one is already borrowed
+ * @note Other receivers see the queue as empty until queue_receive_release()
+ */
+queue_result_t queue_receive_borrow(uint8_t queue_id, void** slot);
+
+/**
+ * @brief Return the slot obtained from queue_receive_borrow() to the queue
+ * @param queue_id Queue identifier
+ * @return queue_result_t Success or error code
+ */
+queue_result_t queue_receive_release(uint8_t queue_id);
+
 /**
  * @brief Get number of items in queue
  * @param queue_id Queue identifier
@@ -137,6 +336,7 @@ bool queue_is_full(uint8_t queue_id);
  */
 bool queue_is_empty(uint8_t queue_id);
 
+#if RTOS_USE_SEMAPHORES
 /* ============================================================================
  * FUNCTION PROTOTYPES - SEMAPHORE MANAGEMENT
  * ============================================================================ */
@@ -160,8 +360,9 @@ rtos_result_t semaphore_delete(uint8_t semaphore_id);
 /**
  * @brief Take/acquire a semaphore
  * @param semaphore_id Semaphore identifier
- * @param timeout_ms Timeout in milliseconds
- * @return rtos_result_t Success or error code
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, QUEUE_TIMEOUT_INFINITE = wait forever)
+ * @return rtos_result_t Success, RTOS_TIMEOUT or RTOS_ERROR (deleted while waiting)
+ * @note The caller is suspended until semaphore_give() hands the count over
  */
 rtos_result_t semaphore_take(uint8_t semaphore_id, uint32_t timeout_ms);
 
@@ -178,6 +379,356 @@ rtos_result_t semaphore_give(uint8_t semaphore_id);
  * @return uint8_t Current count (0xFF if error)
  */
 uint8_t semaphore_get_count(uint8_t semaphore_id);
+#endif /* RTOS_USE_SEMAPHORES */
+
+/* ============================================================================
+ * FUNCTION PROTOTYPES - HANDLE-BASED QUEUES AND SEMAPHORES
+ * ============================================================================ */
+
+/**
+ * @brief Create the object tables backing handle-based queues and semaphores
+ * @param max_queues Maximum number of handle-based queues
+ * @param max_semaphores Maximum number of handle-based semaphores (ignored
+ *        without RTOS_USE_SEMAPHORES)
+ * @return rtos_result_t Success or error code
+ * @note Called once after memory_init() and queue_manager_init(); table sizes
+ *       are run-time parameters instead of MAX_QUEUES / MAX_SEMAPHORES
+ */
+rtos_result_t queue_manager_init_handles(uint16_t max_queues, uint16_t max_semaphores);
+
+/**
+ * @brief Create a queue and return its handle
+ * @param size Queue capacity in items
+ * @param item_size Bytes per item
+ * @return queue_handle_t Queue handle (OBJECT_HANDLE_INVALID if failed)
+ * @note O(1) apart from the buffer allocation
+ */
+queue_handle_t queue_create_handle(uint32_t size, uint32_t item_size);
+
+/**
+ * @brief Delete a handle-based queue
+ * @param handle Queue handle
+ * @return queue_result_t Success or QUEUE_ERROR (stale/invalid handle)
+ * @note Blocked senders and receivers are woken with QUEUE_ERROR
+ */
+queue_result_t queue_delete_handle(queue_handle_t handle);
+
+/**
+ * @brief Send data to a handle-based queue
+ * @param handle Queue handle
+ * @param data Item to send (item_size bytes)
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, QUEUE_TIMEOUT_INFINITE = wait forever)
+ * @return queue_result_t Same as queue_send()
+ */
+queue_result_t queue_send_handle(queue_handle_t handle, const void* data, uint32_t timeout_ms);
+
+/**
+ * @brief Receive data from a handle-based queue
+ * @param handle Queue handle
+ * @param data Buffer for the item (item_size bytes)
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, QUEUE_TIMEOUT_INFINITE = wait forever)
+ * @return queue_result_t Same as queue_receive()
+ */
+queue_result_t queue_receive_handle(queue_handle_t handle, void* data, uint32_t timeout_ms);
+
+#if RTOS_USE_SEMAPHORES
+/**
+ * @brief Create a semaphore and return its handle
+ * @param initial_count Initial count
+ * @param max_count Maximum count
+ * @return semaphore_handle_t Semaphore handle (OBJECT_HANDLE_INVALID if failed)
+ */
+semaphore_handle_t semaphore_create_handle(uint8_t initial_count, uint8_t max_count);
+
+/**
+ * @brief Delete a handle-based semaphore
+ * @param handle Semaphore handle
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t semaphore_delete_handle(semaphore_handle_t handle);
+
+/**
+ * @brief Take a handle-based semaphore
+ * @param handle Semaphore handle
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, QUEUE_TIMEOUT_INFINITE = wait forever)
+ * @return rtos_result_t Same as semaphore_take()
+ */
+rtos_result_t semaphore_take_handle(semaphore_handle_t handle, uint32_t timeout_ms);
+
+/**
+ * @brief Give a handle-based semaphore
+ * @param handle Semaphore handle
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t semaphore_give_handle(semaphore_handle_t handle);
+#endif
+
+/* ============================================================================
+ * FUNCTION PROTOTYPES - SPSC RINGS
+ * ============================================================================ */
+
+/**
+ * @brief Create a single-producer/single-consumer ring
+ * @param ring_id Ring identifier (0-1)
+ * @param size Number of items (power of two, up to SPSC_MAX_SIZE)
+ * @param item_size Size of each item in bytes
+ * @return queue_result_t Success or error code
+ */
+queue_result_t spsc_create(uint8_t ring_id, uint32_t size, uint32_t item_size);
+
+/**
+ * @brief Create an SPSC ring on caller-provided storage
+ * @param ring_id Ring identifier (0-1)
+ * @param size Number of items (power of two, up to SPSC_MAX_SIZE)
+ * @param item_size Size of each item in bytes
+ * @param buffer Storage of size * item_size bytes
+ * @return queue_result_t Success or error code
+ * @note No heap traffic. The buffer must stay valid until spsc_delete().
+ */
+queue_result_t spsc_create_static(uint8_t ring_id, uint32_t size, uint32_t item_size, void* buffer);
+
+/**
+ * @brief Delete an SPSC ring
+ * @param ring_id Ring identifier
+ * @return queue_result_t Success or error code
+ * @note A consumer sleeping in spsc_receive_wait() is woken with QUEUE_ERROR
+ */
+queue_result_t spsc_delete(uint8_t ring_id);
+
+/**
+ * @brief Push an item from task context
+ * @param ring_id Ring identifier
+ * @param data Pointer to data to send
+ * @return queue_result_t Success, QUEUE_FULL or QUEUE_ERROR
+ * @note Never blocks and never masks interrupts, unless it has to wake a
+ *       consumer sleeping in spsc_receive_wait() (then reschedules at once)
+ */
+queue_result_t spsc_send(uint8_t ring_id, const void* data);
+
+/**
+ * @brief Push an item from an ISR
+ * @param ring_id Ring identifier
+ * @param data Pointer to data to send
+ * @param task_woken Set to true if a sleeping consumer was woken (may be NULL);
+ *        the ISR should then call scheduler_switch_context() before returning
+ * @return queue_result_t Success, QUEUE_FULL or QUEUE_ERROR
+ */
+queue_result_t spsc_send_from_isr(uint8_t ring_id, const void* data, bool* task_woken);
+
+/**
+ * @brief Pop an item without waiting (task context)
+ * @param ring_id Ring identifier
+ * @param data Pointer to buffer for received data
+ * @return queue_result_t Success, QUEUE_EMPTY or QUEUE_ERROR
+ */
+queue_result_t spsc_receive(uint8_t ring_id, void* data);
+
+/**
+ * @brief Pop an item from an ISR (e.g. a task -> UART TX ring)
+ * @param ring_id Ring identifier
+ * @param data Pointer to buffer for received data
+ * @return queue_result_t Success, QUEUE_EMPTY or QUEUE_ERROR
+ */
+queue_result_t spsc_receive_from_isr(uint8_t ring_id, void* data);
+
+/**
+ * @brief Pop an item, sleeping until the producer publishes one
+ * @param ring_id Ring identifier
+ * @param data Pointer to buffer for received data
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, QUEUE_TIMEOUT_INFINITE = wait forever)
+ * @return queue_result_t Success, QUEUE_EMPTY (no wait), QUEUE_TIMEOUT or QUEUE_ERROR
+ * @note Opt-in notification: the producer only pays for a wakeup when the
+ *       consumer is actually asleep on an empty ring. Task context only.
+ */
+queue_result_t spsc_receive_wait(uint8_t ring_id, void* data, uint32_t timeout_ms);
+
+/**
+ * @brief Get number of items in an SPSC ring
+ * @param ring_id Ring identifier
+ * @return uint32_t Number of items (0xFFFFFFFF if error)
+ */
+uint32_t spsc_get_count(uint8_t ring_id);
+
+/* ============================================================================
+ * FUNCTION PROTOTYPES - MUTEX MANAGEMENT
+ * ============================================================================ */
+
+/**
+ * @brief Create a mutex
+ * @param mutex_id Mutex identifier (0-3)
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t mutex_create(uint8_t mutex_id);
+
+/**
+ * @brief Delete a mutex
+ * @param mutex_id Mutex identifier
+ * @return rtos_result_t Success or error code
+ * @note Waiting tasks are woken with RTOS_ERROR
+ */
+rtos_result_t mutex_delete(uint8_t mutex_id);
+
+/**
+ * @brief Lock a mutex
+ * @param mutex_id Mutex identifier
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, QUEUE_TIMEOUT_INFINITE = wait forever)
+ * @return rtos_result_t Success, RTOS_TIMEOUT or RTOS_ERROR (deleted while waiting)
+ * @note Recursive: the owner may lock again and must unlock as many times.
+ *       While the caller waits, the owner (and whatever the owner itself
+ *       waits on) inherits the caller's priority. Task context only.
+ */
+rtos_result_t mutex_lock(uint8_t mutex_id, uint32_t timeout_ms);
+
+/**
+ * @brief Unlock a mutex
+ * @param mutex_id Mutex identifier
+ * @return rtos_result_t Success, or RTOS_ERROR if the caller is not the owner
+ * @note The final unlock hands the mutex to the highest-priority waiter and
+ *       drops the caller back to the highest priority it still inherits
+ */
+rtos_result_t mutex_unlock(uint8_t mutex_id);
+
+/**
+ * @brief Get the task that owns a mutex
+ * @param mutex_id Mutex identifier
+ * @return uint8_t Owner task ID (0xFF if unlocked or error)
+ */
+uint8_t mutex_get_owner(uint8_t mutex_id);
+
+/**
+ * @brief Withdraw the priority a task lent while waiting on a mutex
+ * @param tcb Task whose mutex wait ended without getting the mutex
+ * @note Kernel-internal: the task manager calls this in a critical section
+ *       once the task is off the wait list (timeout, suspend or delete), so
+ *       the owner drops the boost at once rather than when the task runs
+ */
+void mutex_abandon_wait(tcb_t* tcb);
+
+/**
+ * @brief Hand every mutex a task holds to its best waiter
+ * @param tcb Task being deleted
+ * @note Kernel-internal: task_delete() calls this in a critical section.
+ *       Mutexes nobody waits for are left unlocked.
+ */
+void mutex_release_all(tcb_t* tcb);
+
+/* ============================================================================
+ * FUNCTION PROTOTYPES - EVENT GROUPS
+ * ============================================================================ */
+
+/**
+ * @brief Create an event group (all bits clear)
+ * @param group_id Event group identifier (0-3)
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t event_group_create(uint8_t group_id);
+
+/**
+ * @brief Delete an event group
+ * @param group_id Event group identifier
+ * @return rtos_result_t Success or error code
+ * @note Waiting tasks are woken with RTOS_ERROR
+ */
+rtos_result_t event_group_delete(uint8_t group_id);
+
+/**
+ * @brief Set bits and wake every waiter whose condition now holds
+ * @param group_id Event group identifier
+ * @param bits Bits to set
+ * @return rtos_result_t Success or error code
+ * @note All matching waiters are released in one pass; bits they asked to
+ *       clear on exit are cleared only after the pass
+ */
+rtos_result_t event_group_set_bits(uint8_t group_id, uint32_t bits);
+
+/**
+ * @brief Set bits from an ISR
+ * @param group_id Event group identifier
+ * @param bits Bits to set
+ * @param task_woken Set to true if a waiting task was woken (may be NULL);
+ *        the ISR should then call scheduler_switch_context() before returning
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t event_group_set_bits_from_isr(uint8_t group_id, uint32_t bits, bool* task_woken);
+
+/**
+ * @brief Clear bits
+ * @param group_id Event group identifier
+ * @param bits Bits to clear
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t event_group_clear_bits(uint8_t group_id, uint32_t bits);
+
+/**
+ * @brief Get the current bits
+ * @param group_id Event group identifier
+ * @return uint32_t Current bits (0 if error)
+ */
+uint32_t event_group_get_bits(uint8_t group_id);
+
+/**
+ * @brief Wait for any or all of a set of bits
+ * @param group_id Event group identifier
+ * @param bits Bits to wait for (non-zero)
+ * @param options EVENT_WAIT_ANY or EVENT_WAIT_ALL, optionally | EVENT_CLEAR_ON_EXIT
+ * @param bits_out Receives the group bits that satisfied the wait, or the
+ *        current bits on timeout (may be NULL)
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, QUEUE_TIMEOUT_INFINITE = wait forever)
+ * @return rtos_result_t Success, RTOS_TIMEOUT or RTOS_ERROR (deleted while waiting)
+ */
+rtos_result_t event_group_wait(uint8_t group_id, uint32_t bits, uint8_t options,
+                               uint32_t* bits_out, uint32_t timeout_ms);
+
+/* ============================================================================
+ * FUNCTION PROTOTYPES - QUEUE SETS
+ * ============================================================================ */
+
+/**
+ * @brief Create an empty queue set
+ * @param set_id Queue set identifier (0-1)
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t queue_set_create(uint8_t set_id);
+
+/**
+ * @brief Delete a queue set
+ * @param set_id Queue set identifier
+ * @return rtos_result_t Success or error code
+ * @note Members are released (queues and semaphores stay usable) and
+ *       waiting tasks are woken with QUEUE_SET_MEMBER_NONE
+ */
+rtos_result_t queue_set_delete(uint8_t set_id);
+
+/**
+ * @brief Add a queue or semaphore to a set
+ * @param set_id Queue set identifier
+ * @param member QUEUE_SET_MEMBER_QUEUE(id) or QUEUE_SET_MEMBER_SEMAPHORE(id)
+ * @return rtos_result_t Success, RTOS_INVALID_PARAM or RTOS_ERROR (member
+ *         inactive or already in a set)
+ * @note Only queues and semaphores from the fixed ID tables can join a set
+ */
+rtos_result_t queue_set_add(uint8_t set_id, uint8_t member);
+
+/**
+ * @brief Remove a queue or semaphore from a set
+ * @param set_id Queue set identifier
+ * @param member Member handle given to queue_set_add()
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t queue_set_remove(uint8_t set_id, uint8_t member);
+
+/**
+ * @brief Wait until any member of a set has an item or count available
+ * @param set_id Queue set identifier
+ * @param timeout_ms Timeout in milliseconds (0 = no wait, QUEUE_TIMEOUT_INFINITE = wait forever)
+ * @return uint8_t Member handle that is ready (QUEUE_SET_MEMBER_NONE on
+ *         timeout, error or deletion)
+ * @note Nothing is consumed: read the member with queue_receive() or
+ *       semaphore_take() and a zero timeout. A producer with no direct
+ *       receiver wakes one selecting task per item, so another reader may
+ *       still win the race and leave the zero-timeout read empty.
+ */
+uint8_t queue_set_select(uint8_t set_id, uint32_t timeout_ms);
 
 /* ============================================================================
  * FUNCTION PROTOTYPES - UTILITY
@@ -189,14 +740,17 @@ uint8_t semaphore_get_count(uint8_t semaphore_id);
  */
 void queue_print_info(uint8_t queue_id);
 
+#if RTOS_USE_SEMAPHORES
 /**
  * @brief Print semaphore information (for debugging)
  * @param semaphore_id Semaphore identifier (0xFF for all semaphores)
  */
 void semaphore_print_info(uint8_t semaphore_id);
+#endif
 
 /**
  * @brief Handle timeouts for waiting tasks (called by timer)
+ * @note No-op: blocking timeouts are tracked on the task delay list
  */
 void queue_manager_handle_timeouts(void);
 
@@ -0,0 +1,95 @@
+/**
+ * @file rtos_benchmark.h
+ * @brief Kernel Micro-Benchmark Interface
+ * @author Team Member 6 - System Integration
+ * @date 2024
+ *
+ * Times the kernel hot paths with the DWT cycle counter: context switch,
+ * scheduler tick, heap alloc/free under fragmentation, queue round trip,
+ * semaphore ping-pong and the tick with every software timer armed. Runs
+ * unchanged on target and on the host port (RTOS_PORT_POSIX), where the
+ * counter ticks in nanoseconds.
+ */
+
+#ifndef RTOS_BENCHMARK_H
+#define RTOS_BENCHMARK_H
+
+#include "rtos_config.h"
+
+/* ============================================================================
+ * BENCHMARK CONFIGURATION
+ * ============================================================================ */
+#define BENCHMARK_ITERATIONS        1000                /* Timed samples per benchmark */
+#define BENCHMARK_PRIORITY          PRIORITY_CRITICAL   /* Benchmark and partner tasks */
+#define BENCHMARK_STACK_SIZE        DEFAULT_STACK_SIZE  /* Benchmark and partner stacks */
+#define BENCHMARK_QUEUE_ID          QUEUE_4             /* Queue used for the round trip */
+#define BENCHMARK_PING_SEMAPHORE    (MAX_SEMAPHORES - 2)    /* Benchmark -> partner */
+#define BENCHMARK_PONG_SEMAPHORE    (MAX_SEMAPHORES - 1)    /* Partner -> benchmark */
+#define BENCHMARK_HEAP_BLOCKS       12                  /* Live blocks while timing alloc/free */
+#define BENCHMARK_HEAP_MIN_SIZE     8                   /* Random block size range (bytes) */
+#define BENCHMARK_HEAP_MAX_SIZE     72
+#define BENCHMARK_TIMER_PERIOD_MS   60000               /* Armed timers never expire mid-run */
+
+/* ============================================================================
+ * BENCHMARK TYPES
+ * ============================================================================ */
+typedef enum {
+    BENCHMARK_CONTEXT_SWITCH,               /* One switch between equal-priority tasks */
+    BENCHMARK_SCHEDULER_TICK,               /* scheduler_tick() */
+    BENCHMARK_MEMORY_ALLOC,                 /* memory_alloc() on a fragmented heap */
+    BENCHMARK_MEMORY_FREE,                  /* memory_free() on a fragmented heap */
+    BENCHMARK_QUEUE_ROUND_TRIP,             /* queue_send() + queue_receive(), no wait */
+    BENCHMARK_SEMAPHORE_PING_PONG,          /* give/take round trip through a partner task */
+    BENCHMARK_TIMER_TICK,                   /* Tick handler with software timers armed */
+    BENCHMARK_COUNT
+} benchmark_id_t;
+
+typedef struct {
+    const char* name;                       /* Benchmark name */
+    uint32_t load;                          /* Objects in play (live blocks, armed timers) */
+    uint32_t iterations;                    /* Samples taken (0 = not run) */
+    uint32_t min_cycles;                    /* Fastest sample */
+    uint32_t max_cycles;                    /* Slowest sample */
+    uint64_t total_cycles;                  /* Sum of samples (for the mean) */
+} benchmark_result_t;
+
+/* Results by benchmark_id_t, visible in the watch window */
+extern benchmark_result_t rtos_benchmark_results[BENCHMARK_COUNT];
+
+/* Set once the benchmark task has finished every run */
+extern volatile bool rtos_benchmark_done;
+
+/* ============================================================================
+ * FUNCTION PROTOTYPES
+ * ============================================================================ */
+
+/**
+ * @brief Create the benchmark task
+ * @return rtos_result_t Success or error code
+ * @note Call before scheduler_start(). The task runs at BENCHMARK_PRIORITY,
+ *       records every benchmark once, prints the report and deletes itself;
+ *       on the host port it ends the process instead.
+ */
+rtos_result_t rtos_benchmark_start(void);
+
+/**
+ * @brief Get one benchmark's result
+ * @param id Benchmark identifier
+ * @return const benchmark_result_t* Result (NULL if id is invalid)
+ */
+const benchmark_result_t* rtos_benchmark_get_result(benchmark_id_t id);
+
+/**
+ * @brief Convert cycle counter ticks to nanoseconds
+ * @param cycles Cycles counted by DWT CYCCNT
+ * @return uint32_t Nanoseconds (saturates at 0xFFFFFFFF)
+ */
+uint32_t rtos_benchmark_cycles_to_ns(uint32_t cycles);
+
+/**
+ * @brief Print every result (min/mean/max cycles and mean ns)
+ * @note Goes to stdout on the host port, DEBUG_PRINT on target
+ */
+void rtos_benchmark_print(void);
+
+#endif /* RTOS_BENCHMARK_H */
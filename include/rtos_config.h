@@ -23,11 +23,31 @@
     #include <arm_compat.h>
 #endif
 
+/* ============================================================================
+ * BUILD PROFILES
+ * ============================================================================ */
+/* Each target in ARM_RTOS_Scheduler.uvprojx selects a profile through its
+ * C/C++ Define list (e.g. RTOS_PROFILE=RTOS_PROFILE_MINIMAL). The profile only
+ * picks defaults: any RTOS_USE_* flag below may itself be defined there too. */
+#define RTOS_PROFILE_FULL           0       /* Every kernel feature, statistics and debug hooks */
+#define RTOS_PROFILE_MINIMAL        1       /* Tasks, queues and tickless idle only (sensor builds) */
+
+#ifndef RTOS_PROFILE
+#define RTOS_PROFILE                RTOS_PROFILE_FULL
+#endif
+
+#if RTOS_PROFILE == RTOS_PROFILE_MINIMAL
+#define RTOS_FEATURE_DEFAULT        0
+#else
+#define RTOS_FEATURE_DEFAULT        1
+#endif
+
 /* ============================================================================
  * RTOS CONFIGURATION PARAMETERS
  * ============================================================================ */
 
-/* Maximum number of tasks */
+/* Tasks in the default (static) task table; task_manager_init_capacity()
+ * sizes the table at run time instead */
 #define MAX_TASKS                   8
 
 /* Maximum task name length */
@@ -38,6 +58,19 @@
 #define DEFAULT_STACK_SIZE          256
 #define MAX_STACK_SIZE              1024
 
+/* Paint stacks at creation for high-water marks and idle-time overflow checks (1 = on) */
+#ifndef RTOS_USE_STACK_CHECK
+#define RTOS_USE_STACK_CHECK        RTOS_FEATURE_DEFAULT
+#endif
+#define TASK_STACK_FILL_PATTERN     0xA5A5A5A5
+
+/* No-access MPU region below every task stack, so an overflow faults at once
+ * (1 = on; one MPU region per task while regions last, costs 2 x
+ * MPU_STACK_GUARD_SIZE per stack) */
+#ifndef RTOS_USE_MPU_STACK_GUARD
+#define RTOS_USE_MPU_STACK_GUARD    0
+#endif
+
 /* Time slice for round-robin scheduling (in ms) */
 #define TIME_SLICE_MS               10
 
@@ -47,12 +80,87 @@
 /* Maximum queue size */
 #define MAX_QUEUE_SIZE              16
 
-/* System clock frequency (Hz) - for simulation */
-#define SYSTEM_CLOCK_HZ             48000000
+/* System clock frequency (Hz) - matches SystemCoreClock in system_ARMCM3.c */
+#define SYSTEM_CLOCK_HZ             25000000
 
 /* Timer tick frequency (Hz) */
 #define TICK_RATE_HZ                1000
 
+/* Interrupt priority bits implemented by the NVIC (__NVIC_PRIO_BITS, ARMCM3: 3) */
+#define RTOS_NVIC_PRIO_BITS         3
+
+/* Most urgent interrupt priority (0 = highest) allowed to call RTOS APIs.
+ * Critical sections raise BASEPRI to this level, so more urgent interrupts
+ * are never masked by the kernel - and must never call into it. */
+#define RTOS_MAX_SYSCALL_PRIORITY   5
+#define RTOS_MAX_SYSCALL_BASEPRI    (RTOS_MAX_SYSCALL_PRIORITY << (8 - RTOS_NVIC_PRIO_BITS))
+
+/* Tickless idle: stop the periodic tick while every task is blocked (1 = on) */
+#ifndef RTOS_USE_TICKLESS_IDLE
+#define RTOS_USE_TICKLESS_IDLE      1
+#endif
+
+/* Shortest idle period (in ticks) worth reprogramming SysTick for */
+#define TICKLESS_MIN_IDLE_TICKS     2
+
+/* Software timers (timer_create() and friends); the system tick is always built (1 = on) */
+#ifndef RTOS_USE_TIMERS
+#define RTOS_USE_TIMERS             RTOS_FEATURE_DEFAULT
+#endif
+
+/* Run software timer callbacks in a daemon task instead of the tick ISR (1 = on) */
+#ifndef RTOS_USE_TIMER_DAEMON
+#define RTOS_USE_TIMER_DAEMON       RTOS_USE_TIMERS
+#endif
+
+/* Counting semaphores, by ID and by handle (1 = on) */
+#ifndef RTOS_USE_SEMAPHORES
+#define RTOS_USE_SEMAPHORES         RTOS_FEATURE_DEFAULT
+#endif
+
+/* Scheduler, timer and heap statistics counters (1 = on). Off, the hot paths
+ * skip all bookkeeping and the heap summary is computed on request instead. */
+#ifndef RTOS_USE_STATS
+#define RTOS_USE_STATS              RTOS_FEATURE_DEFAULT
+#endif
+
+/* Per-task CPU cycle accounting from the DWT cycle counter (1 = on) */
+#ifndef RTOS_USE_RUNTIME_STATS
+#define RTOS_USE_RUNTIME_STATS      RTOS_FEATURE_DEFAULT
+#endif
+
+/* Binary event trace into a RAM ring, see rtos_trace.h (1 = on) */
+#ifndef RTOS_USE_TRACE
+#define RTOS_USE_TRACE              RTOS_FEATURE_DEFAULT
+#endif
+
+/* Also stream trace records over ITM/SWO (1 = on, needs RTOS_USE_TRACE) */
+#ifndef RTOS_TRACE_USE_ITM
+#define RTOS_TRACE_USE_ITM          0
+#endif
+
+/* Cycle histograms for SysTick, PendSV and every critical section, see
+ * rtos_latency.h (1 = on; costs RAM per ENTER_CRITICAL call site) */
+#ifndef RTOS_USE_LATENCY_STATS
+#define RTOS_USE_LATENCY_STATS      0
+#endif
+
+/* Kernel micro-benchmark suite, see rtos_benchmark.h (1 = on; main() runs
+ * it before the demo tasks) */
+#ifndef RTOS_USE_BENCHMARKS
+#define RTOS_USE_BENCHMARKS         0
+#endif
+
+/* Build for a POSIX host instead of the Cortex-M3: arm_cortex_m_posix.c
+ * simulates the core registers, PendSV and SysTick (1 = on) */
+#ifndef RTOS_PORT_POSIX
+#define RTOS_PORT_POSIX             0
+#endif
+
+#if RTOS_USE_TIMER_DAEMON && !RTOS_USE_TIMERS
+#error "RTOS_USE_TIMER_DAEMON needs RTOS_USE_TIMERS"
+#endif
+
 /* ============================================================================
  * TASK PRIORITIES
  * ============================================================================ */
@@ -111,7 +219,7 @@ typedef enum {
  * DEBUG CONFIGURATION
  * ============================================================================ */
 #ifndef DEBUG
-#define DEBUG  1
+#define DEBUG  RTOS_FEATURE_DEFAULT
 #endif
 
 /* Debug variables for watching execution (no printf needed) */
@@ -119,7 +227,7 @@ extern volatile char debug_buffer[32];  /* Smaller buffer */
 extern volatile int debug_counter;
 extern void debug_log(int step, const char* message);
 
-#ifdef DEBUG
+#if DEBUG
     #define DEBUG_LOG(step, msg)    debug_log(step, msg)
     #define DEBUG_VAR(var)          debug_counter = (int)(var)
     #define DEBUG_PRINT(...)        do { /* Disabled for simulator */ } while(0)
@@ -135,13 +243,23 @@ extern void debug_log(int step, const char* message);
 #define UNUSED(x)                   ((void)(x))
 #define ARRAY_SIZE(arr)             (sizeof(arr) / sizeof((arr)[0]))
 
-/* Critical section macros (for ARM Cortex-M) */
-#define ENTER_CRITICAL()            __disable_irq()
-#define EXIT_CRITICAL()             __enable_irq()
+/* Critical section macros (for ARM Cortex-M): nest, and mask through
+ * BASEPRI only the interrupts at or below RTOS_MAX_SYSCALL_PRIORITY */
+#if RTOS_USE_LATENCY_STATS
+#define ENTER_CRITICAL()            RTOS_LATENCY_ENTER_CRITICAL()
+#define EXIT_CRITICAL()             RTOS_LATENCY_EXIT_CRITICAL()
+#else
+#define ENTER_CRITICAL()            cortex_m_critical_enter()
+#define EXIT_CRITICAL()             cortex_m_critical_exit()
+#endif
 
 /* ============================================================================
  * FUNCTION PROTOTYPES
  * ============================================================================ */
 void system_init(void);
 
+#if RTOS_USE_LATENCY_STATS
+#include "rtos_latency.h"
+#endif
+
 #endif /* RTOS_CONFIG_H */
\ No newline at end of file
@@ -0,0 +1,131 @@
+/**
+ * @file rtos_latency.h
+ * @brief Interrupt and Critical-Section Latency Instrumentation Interface
+ * @author Team Member 6 - System Integration
+ * @date 2024
+ * 
+ * Builds cycle-count histograms (DWT CYCCNT) for the SysTick and PendSV
+ * handlers and for every ENTER_CRITICAL() call site, so the kernel paths
+ * that hold interrupts off longest can be found.
+ */
+
+#ifndef RTOS_LATENCY_H
+#define RTOS_LATENCY_H
+
+#include "rtos_config.h"
+
+/* ============================================================================
+ * LATENCY CONFIGURATION
+ * ============================================================================ */
+/* Bucket n counts durations in [2^n, 2^(n+1)) cycles; the last bucket is
+ * open-ended (2^15 cycles = 1.3 ms at 25 MHz) */
+#define LATENCY_HISTOGRAM_BUCKETS   16
+
+/* ============================================================================
+ * LATENCY SITE STRUCTURE
+ * ============================================================================ */
+typedef struct latency_site {
+    const char* name;                       /* Function containing the site */
+    uint16_t line;                          /* Source line (0 for handlers) */
+    bool registered;                        /* Linked into the site list */
+    uint32_t start_cycles;                  /* CYCCNT when the current measurement began */
+    uint32_t count;                         /* Measurements taken */
+    uint32_t min_cycles;                    /* Shortest duration */
+    uint32_t max_cycles;                    /* Longest duration */
+    uint64_t total_cycles;                  /* Sum of durations (for the mean) */
+    uint32_t histogram[LATENCY_HISTOGRAM_BUCKETS];
+    struct latency_site* next;              /* Next registered site */
+} latency_site_t;
+
+#define LATENCY_SITE_INIT(name, line)   { (name), (line), false, 0, 0, 0xFFFFFFFF, 0, 0, { 0 }, NULL }
+
+/* Handler sites, always first in the site list */
+extern latency_site_t rtos_latency_systick;
+extern latency_site_t rtos_latency_pendsv;
+
+/* ============================================================================
+ * LATENCY MACROS
+ * ============================================================================ */
+#if RTOS_USE_LATENCY_STATS
+    /* One static site per ENTER_CRITICAL() expansion, registered on first use */
+    #define RTOS_LATENCY_ENTER_CRITICAL() \
+        do { \
+            static latency_site_t latency_site_ = LATENCY_SITE_INIT(__func__, __LINE__); \
+            cortex_m_critical_enter(); \
+            rtos_latency_critical_enter(&latency_site_, cortex_m_critical_nesting == 1); \
+        } while(0)
+    
+    #define RTOS_LATENCY_EXIT_CRITICAL() \
+        do { \
+            rtos_latency_critical_exit(cortex_m_critical_nesting == 1); \
+            cortex_m_critical_exit(); \
+        } while(0)
+    
+    #define RTOS_LATENCY_ISR_ENTER(site)    rtos_latency_isr_enter(site)
+    #define RTOS_LATENCY_ISR_EXIT(site)     rtos_latency_isr_exit(site)
+#else
+    #define RTOS_LATENCY_ISR_ENTER(site)    do { } while(0)
+    #define RTOS_LATENCY_ISR_EXIT(site)     do { } while(0)
+#endif
+
+/* ============================================================================
+ * FUNCTION PROTOTYPES
+ * ============================================================================ */
+
+/**
+ * @brief Register the handler sites (scheduler_init() has started the cycle counter)
+ */
+void rtos_latency_init(void);
+
+/**
+ * @brief Start timing a critical section
+ * @param site Call site of the ENTER_CRITICAL()
+ * @param outermost True if this ENTER_CRITICAL() raised BASEPRI
+ * @note Called inside the section. Only the outermost section is timed,
+ *       since an inner one does not change the masked period.
+ */
+void rtos_latency_critical_enter(latency_site_t* site, bool outermost);
+
+/**
+ * @brief Stop timing the active critical section
+ * @param outermost True if the matching EXIT_CRITICAL() will lower BASEPRI
+ * @note Called while still inside the section
+ */
+void rtos_latency_critical_exit(bool outermost);
+
+/**
+ * @brief Start timing a handler
+ * @param site Handler site
+ */
+void rtos_latency_isr_enter(latency_site_t* site);
+
+/**
+ * @brief Stop timing a handler and record the duration
+ * @param site Handler site
+ */
+void rtos_latency_isr_exit(latency_site_t* site);
+
+/**
+ * @brief Close the PendSV measurement
+ * @note Called by PendSV_Handler just before it returns; the measurement is
+ *       opened in scheduler_runtime_switch(). Empty if RTOS_USE_LATENCY_STATS is off.
+ */
+void rtos_latency_pendsv_exit(void);
+
+/**
+ * @brief Get the registered sites
+ * @return const latency_site_t* First site; follow ->next for the rest
+ */
+const latency_site_t* rtos_latency_get_sites(void);
+
+/**
+ * @brief Clear the counters and histograms of every registered site
+ */
+void rtos_latency_reset(void);
+
+/**
+ * @brief Print every site's histogram (for debugging)
+ */
+void rtos_latency_print_info(void);
+
+#endif /* RTOS_LATENCY_H */
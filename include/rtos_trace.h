@@ -0,0 +1,106 @@
+/**
+ * @file rtos_trace.h
+ * @brief Binary Event Trace Interface
+ * @author Team Member 6 - System Integration
+ * @date 2024
+ * 
+ * Records fixed-size, cycle-stamped kernel events into a RAM ring buffer
+ * (and optionally the ITM stimulus port) in place of formatted debug output.
+ * The ring is decoded in the uVision Component Viewer by EventRecorderStub.scvd.
+ */
+
+#ifndef RTOS_TRACE_H
+#define RTOS_TRACE_H
+
+#include "rtos_config.h"
+
+/* ============================================================================
+ * TRACE CONFIGURATION
+ * ============================================================================ */
+#define RTOS_TRACE_BUFFER_SIZE      128     /* Events kept (power of two, matches the .scvd) */
+#define RTOS_TRACE_ITM_PORT         1       /* ITM stimulus port used when streaming */
+
+#if (RTOS_TRACE_BUFFER_SIZE & (RTOS_TRACE_BUFFER_SIZE - 1)) != 0
+#error "RTOS_TRACE_BUFFER_SIZE must be a power of two"
+#endif
+
+/* ============================================================================
+ * TRACE EVENT IDS
+ * ============================================================================ */
+typedef enum {
+    TRACE_EVENT_NONE = 0,                   /* Unused slot */
+    TRACE_EVENT_TASK_SWITCH_OUT,            /* arg: task switched out */
+    TRACE_EVENT_TASK_SWITCH_IN,             /* arg: task switched in */
+    TRACE_EVENT_QUEUE_SEND,                 /* arg: queue ID */
+    TRACE_EVENT_QUEUE_RECEIVE,              /* arg: queue ID */
+    TRACE_EVENT_QUEUE_BLOCK_SEND,           /* arg: queue ID */
+    TRACE_EVENT_QUEUE_BLOCK_RECEIVE,        /* arg: queue ID */
+    TRACE_EVENT_SEMAPHORE_TAKE,             /* arg: semaphore ID */
+    TRACE_EVENT_SEMAPHORE_GIVE,             /* arg: semaphore ID */
+    TRACE_EVENT_SEMAPHORE_BLOCK,            /* arg: semaphore ID */
+    TRACE_EVENT_TIMER_FIRE,                 /* arg: software timer ID */
+    TRACE_EVENT_ISR_ENTER,                  /* arg: exception number */
+    TRACE_EVENT_ISR_EXIT,                   /* arg: exception number */
+    TRACE_EVENT_USER                        /* First ID free for application events */
+} trace_event_id_t;
+
+/* ============================================================================
+ * TRACE RECORD STRUCTURE
+ * ============================================================================ */
+typedef struct {
+    uint32_t timestamp;                     /* DWT CYCCNT when recorded */
+    uint8_t event;                          /* trace_event_id_t */
+    uint8_t task_id;                        /* Running task (0xFF before the scheduler starts) */
+    uint16_t arg;                           /* Event argument */
+} trace_record_t;
+
+/* Ring storage - global so the Component Viewer can read it by symbol */
+extern trace_record_t rtos_trace_buffer[RTOS_TRACE_BUFFER_SIZE];
+extern volatile uint32_t rtos_trace_count;  /* Events recorded (slot = count % size) */
+
+/* ============================================================================
+ * TRACE MACROS
+ * ============================================================================ */
+#if RTOS_USE_TRACE
+    #define RTOS_TRACE(event, arg)      rtos_trace_record((event), (uint16_t)(arg))
+    #define RTOS_TRACE_ISR_ENTER()      rtos_trace_isr(TRACE_EVENT_ISR_ENTER)
+    #define RTOS_TRACE_ISR_EXIT()       rtos_trace_isr(TRACE_EVENT_ISR_EXIT)
+#else
+    #define RTOS_TRACE(event, arg)      do { } while(0)
+    #define RTOS_TRACE_ISR_ENTER()      do { } while(0)
+    #define RTOS_TRACE_ISR_EXIT()       do { } while(0)
+#endif
+
+/* ============================================================================
+ * FUNCTION PROTOTYPES
+ * ============================================================================ */
+
+/**
+ * @brief Clear the trace ring (scheduler_init() has started the cycle counter)
+ */
+void rtos_trace_init(void);
+
+/**
+ * @brief Record one event
+ * @param event Event ID (trace_event_id_t or TRACE_EVENT_USER and up)
+ * @param arg Event argument
+ * @note Safe from tasks, ISRs and inside critical sections. The oldest
+ *       event is overwritten once the ring is full.
+ */
+void rtos_trace_record(uint8_t event, uint16_t arg);
+
+/**
+ * @brief Record an ISR enter/exit event for the active exception
+ * @param event TRACE_EVENT_ISR_ENTER or TRACE_EVENT_ISR_EXIT
+ */
+void rtos_trace_isr(uint8_t event);
+
+/**
+ * @brief Copy recorded events out, oldest first
+ * @param records Destination array
+ * @param max_records Capacity of the destination array
+ * @return uint32_t Number of records copied
+ */
+uint32_t rtos_trace_read(trace_record_t* records, uint32_t max_records);
+
+#endif /* RTOS_TRACE_H */
@@ -20,6 +20,11 @@
  * ============================================================================ */
 #define SCHEDULER_PRIORITY_LEVELS   5   /* 0-4 priority levels */
 
+/* Idle task stack: exception frame + R4-R11, then stack reclaim (memory_free),
+ * stack scans and tickless idle. Check task_get_stack_high_water() on the idle
+ * task (scheduler_get_idle_task_id()) before shrinking it. */
+#define IDLE_STACK_SIZE             DEFAULT_STACK_SIZE
+
 /* ============================================================================
  * SCHEDULER STATISTICS
  * ============================================================================ */
@@ -28,8 +33,23 @@ typedef struct {
     uint32_t total_scheduler_calls;
     uint32_t idle_time_percentage;
     uint32_t cpu_utilization;
+    uint64_t total_run_cycles;              /* Cycles accounted to tasks (RTOS_USE_RUNTIME_STATS) */
 } scheduler_stats_t;
 
+/* Per-task CPU usage since the last scheduler_reset_stats() */
+typedef struct {
+    uint64_t run_cycles;                    /* Cycles run, including the current slice */
+    uint32_t cpu_percent_x100;              /* Share of all accounted cycles, in 0.01 % */
+    uint32_t slice_count;                   /* Completed run slices */
+    uint32_t min_slice_cycles;              /* Shortest slice (0 if none yet) */
+    uint32_t max_slice_cycles;              /* Longest slice */
+    uint32_t avg_slice_cycles;              /* Mean slice length */
+} task_runtime_stats_t;
+
+/* Context switch handoff, shared with PendSV_Handler (startup_ARMCM3.s) */
+extern tcb_t* volatile scheduler_current_tcb;   /* Task whose registers are live */
+extern tcb_t* volatile scheduler_next_tcb;      /* Task PendSV switches to */
+
 /* ============================================================================
  * FUNCTION PROTOTYPES
  * ============================================================================ */
@@ -54,7 +74,8 @@ tcb_t* scheduler_get_next_task(void);
 
 /**
  * @brief Perform context switch to next ready task
- * @note Called by timer interrupt or yield
+ * @note Called by timer interrupt or yield. Picks the next task and pends
+ *       PendSV, which does the actual register save/restore.
  */
 void scheduler_switch_context(void);
 
@@ -97,11 +118,31 @@ bool scheduler_is_running(void);
  */
 rtos_result_t scheduler_get_stats(scheduler_stats_t* stats);
 
+/**
+ * @brief Get a task's CPU usage and run-slice lengths
+ * @param task_id Task identifier
+ * @param stats Pointer to statistics structure
+ * @return rtos_result_t Success or error code (RTOS_ERROR if
+ *         RTOS_USE_RUNTIME_STATS is off)
+ * @note A slice runs from PendSV switching a task in to switching it out,
+ *       so interrupt time is charged to the task it interrupted
+ */
+rtos_result_t scheduler_get_task_runtime(uint8_t task_id, task_runtime_stats_t* stats);
+
 /**
  * @brief Reset scheduler statistics
+ * @note Also clears every task's runtime counters
  */
 void scheduler_reset_stats(void);
 
+/**
+ * @brief Close the outgoing task's run slice and open the incoming one
+ * @note Called by PendSV_Handler with BASEPRI raised, before
+ *       scheduler_current_tcb is updated. Also records the switch-out/in
+ *       trace events. Empty if RTOS_USE_RUNTIME_STATS and RTOS_USE_TRACE are off.
+ */
+void scheduler_runtime_switch(void);
+
 /**
  * @brief Lock scheduler (disable preemption)
  * @note Use carefully to avoid deadlocks
@@ -125,14 +166,15 @@ bool scheduler_is_locked(void);
 void scheduler_print_info(void);
 
 /**
- * @brief Idle task function (runs when no other tasks are ready)
+ * @brief Get the idle task's ID
+ * @return uint8_t Idle task ID (0xFF before scheduler_init())
+ * @note Pass it to task_get_stack_high_water() to size IDLE_STACK_SIZE
  */
-void scheduler_idle_task(void);
+uint8_t scheduler_get_idle_task_id(void);
 
 /**
- * @brief Run the next ready task for one iteration
- * @note Simplified scheduler that executes one task iteration per call
+ * @brief Idle task function (runs when no other tasks are ready)
  */
-void scheduler_run_next_task(void);
+void scheduler_idle_task(void);
 
 #endif /* SCHEDULER_H */
\ No newline at end of file
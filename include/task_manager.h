@@ -12,13 +12,74 @@
 #define TASK_MANAGER_H
 
 #include "rtos_config.h"
+#include "memory_manager.h"
+
+/* ============================================================================
+ * TASK TABLE CONFIGURATION
+ * ============================================================================ */
+/* TCBs live in an object table (task_manager_init_capacity). The slot index
+ * is the uint8_t task ID, so 0xFF stays free as the invalid ID. */
+#define TASK_MAX_CAPACITY           255         /* Largest task table */
+
+/* Hardware stack guards (RTOS_USE_MPU_STACK_GUARD) are handed out while MPU
+ * regions last; later tasks rely on the RTOS_USE_STACK_CHECK scan alone */
+#define TASK_MPU_GUARD_REGIONS      8           /* Regions on Cortex-M3 */
+#define TASK_MPU_REGION_NONE        0xFF        /* tcb_t.mpu_region: no guard */
+
+typedef object_handle_t task_handle_t;
+
+/* ============================================================================
+ * BLOCKING CONFIGURATION
+ * ============================================================================ */
+#define TASK_WAIT_FOREVER           0xFFFFFFFF  /* task_block_current(): no timeout */
+#define TASK_WAIT_PENDING           1           /* wait_result while still waiting */
+
+/* Notification state (tcb_t.notify_state) */
+#define TASK_NOTIFY_NONE            0           /* Nothing received, not waiting */
+#define TASK_NOTIFY_WAITING         1           /* Blocked in task_notify_wait/take */
+#define TASK_NOTIFY_RECEIVED        2           /* Notification arrived, not yet consumed */
+
+/* Stack storage for task_create_static(): the MPU guard is carved from the
+ * bottom of the buffer, so it needs room for the guard plus alignment slack */
+#if RTOS_USE_MPU_STACK_GUARD
+#define TASK_STACK_GUARD_OVERHEAD   64          /* 2 x MPU_STACK_GUARD_SIZE */
+#else
+#define TASK_STACK_GUARD_OVERHEAD   0
+#endif
+#define TASK_STACK_WORDS(stack_size) (((stack_size) + TASK_STACK_GUARD_OVERHEAD) / sizeof(uint32_t))
+
+struct mutex;                           /* Defined in queue_manager.h */
+
+/* ============================================================================
+ * TASK NOTIFICATION TYPES
+ * ============================================================================ */
+typedef enum {
+    TASK_NOTIFY_SET_BITS,               /* notify_value |= value (event flags) */
+    TASK_NOTIFY_INCREMENT,              /* notify_value++ (counting semaphore) */
+    TASK_NOTIFY_OVERWRITE               /* notify_value = value (mailbox) */
+} task_notify_action_t;
+
+/* ============================================================================
+ * WAIT LIST STRUCTURE
+ * ============================================================================ */
+/* Tasks blocked on one object, linked through the TCB, highest priority
+ * first (FIFO among equal priorities) */
+typedef struct task_wait_list {
+    struct task_control_block* head;    /* Highest-priority waiter */
+    uint8_t count;                      /* Number of waiting tasks */
+} task_wait_list_t;
 
 /* ============================================================================
  * TASK CONTROL BLOCK (TCB) STRUCTURE
  * ============================================================================ */
 typedef struct task_control_block {
+    /* Saved process stack pointer - MUST stay the first member,
+     * PendSV_Handler in startup_ARMCM3.s loads/stores it at offset 0 */
+    uint32_t* stack_pointer;
+    
     /* Task identification */
-    uint8_t task_id;
+    uint8_t task_id;                    /* Slot index in the task table */
+    task_handle_t handle;               /* Generation-checked handle for the slot */
     char task_name[MAX_TASK_NAME_LENGTH];
     
     /* Task function and parameters */
@@ -26,25 +87,51 @@ typedef struct task_control_block {
     void* task_parameter;
     
     /* Task priority and state */
-    uint8_t priority;
+    uint8_t priority;                   /* Effective priority (may be inherited) */
+    uint8_t base_priority;              /* Priority assigned at creation */
     task_state_t state;
     
     /* Stack management */
-    uint32_t* stack_pointer;
-    uint32_t* stack_base;
+    uint32_t* stack_base;               /* Allocation or caller buffer */
     uint32_t stack_size;
+    bool owns_stack;                    /* stack_base came from memory_alloc() */
+    uint32_t* stack_limit;              /* Lowest usable word, above any MPU guard */
+    uint32_t stack_min_free;            /* Least free stack seen, bytes (RTOS_USE_STACK_CHECK) */
+    uint8_t mpu_region;                 /* Guard region, TASK_MPU_REGION_NONE if none (RTOS_USE_MPU_STACK_GUARD) */
     
     /* Timing information */
     uint32_t time_slice_remaining;
-    uint32_t delay_ticks;
+    uint32_t delay_ticks;               /* Ticks after the previous delay list entry */
+    
+    /* Delay list links (sorted by wakeup time, delta-encoded) */
+    struct task_control_block* delay_next;
+    struct task_control_block* delay_prev;
+    
+    /* Blocking on a queue/semaphore */
+    task_wait_list_t* wait_list;        /* List the task is queued on (NULL if none) */
+    struct task_control_block* wait_next;
+    struct task_control_block* wait_prev;
+    void* wait_data;                    /* Item buffer the waker copies to/from */
+    int8_t wait_result;                 /* TASK_WAIT_PENDING, then the waker's result code */
+    
+    /* Direct-to-task notification */
+    uint32_t notify_value;              /* Notification word */
+    uint8_t notify_state;               /* TASK_NOTIFY_NONE/WAITING/RECEIVED */
+    
+    /* Mutex ownership (priority inheritance) */
+    struct mutex* held_mutexes;         /* Mutexes owned by the task (chained) */
+    struct mutex* waiting_mutex;        /* Mutex the task is blocked on (NULL if none) */
     
     /* Linked list pointers for scheduler */
     struct task_control_block* next;
     struct task_control_block* prev;
     
     /* Task statistics */
-    uint32_t execution_time;
+    uint64_t execution_time;            /* CPU cycles run (RTOS_USE_RUNTIME_STATS) */
     uint32_t context_switches;
+    uint32_t slice_count;               /* Completed run slices */
+    uint32_t slice_min_cycles;          /* Shortest run slice (cycles) */
+    uint32_t slice_max_cycles;          /* Longest run slice (cycles) */
     
 } tcb_t;
 
@@ -55,9 +142,20 @@ typedef struct task_control_block {
 /**
  * @brief Initialize the task manager
  * @return rtos_result_t Success or error code
+ * @note Room for MAX_TASKS tasks in static storage; call after memory_init()
  */
 rtos_result_t task_manager_init(void);
 
+/**
+ * @brief Initialize the task manager with a run-time task limit
+ * @param max_tasks Task table size (1 to TASK_MAX_CAPACITY)
+ * @return rtos_result_t Success or error code
+ * @note Call after memory_init(), instead of task_manager_init(). Up to
+ *       MAX_TASKS uses the static table, larger tables are carved from the
+ *       heap. Creating and deleting a task is O(1) either way.
+ */
+rtos_result_t task_manager_init_capacity(uint8_t max_tasks);
+
 /**
  * @brief Create a new task
  * @param task_function Pointer to task function
@@ -71,13 +169,61 @@ uint8_t task_create(void (*task_function)(void),
                    uint8_t priority, 
                    uint32_t stack_size);
 
+/**
+ * @brief Create a new task on caller-provided stack storage
+ * @param task_function Pointer to task function
+ * @param task_name Task name (max 15 characters + null terminator)
+ * @param priority Task priority (0-4)
+ * @param stack_buffer Stack storage of at least TASK_STACK_WORDS(stack_size) words
+ * @param stack_size Usable stack size in bytes
+ * @return uint8_t Task ID (0xFF if failed)
+ * @note No heap traffic. The buffer must stay valid until task_delete().
+ */
+uint8_t task_create_static(void (*task_function)(void), 
+                          const char* task_name, 
+                          uint8_t priority, 
+                          uint32_t* stack_buffer,
+                          uint32_t stack_size);
+
 /**
  * @brief Delete a task
  * @param task_id Task ID to delete
  * @return rtos_result_t Success or error code
+ * @note Mutexes the task holds pass to their best waiters; a mutex wait it
+ *       was blocked in stops lending the owner its priority. A task deleting
+ *       itself keeps its stack until the idle task reclaims it.
  */
 rtos_result_t task_delete(uint8_t task_id);
 
+/**
+ * @brief Create a new task and return its handle
+ * @param task_function Pointer to task function
+ * @param task_name Task name (max 15 characters + null terminator)
+ * @param priority Task priority (0-4)
+ * @param stack_size Stack size in bytes
+ * @return task_handle_t Task handle (OBJECT_HANDLE_INVALID if failed)
+ * @note Unlike a task ID, a handle kept after task_delete_handle() never
+ *       resolves to a new task created in the same slot
+ */
+task_handle_t task_create_handle(void (*task_function)(void),
+                                 const char* task_name,
+                                 uint8_t priority,
+                                 uint32_t stack_size);
+
+/**
+ * @brief Delete a task by handle
+ * @param handle Task handle
+ * @return rtos_result_t Success, or RTOS_ERROR for a stale/invalid handle
+ */
+rtos_result_t task_delete_handle(task_handle_t handle);
+
+/**
+ * @brief Get the task ID behind a handle, for the ID-based task calls
+ * @param handle Task handle
+ * @return uint8_t Task ID (0xFF if the handle is stale or invalid)
+ */
+uint8_t task_handle_get_id(task_handle_t handle);
+
 /**
  * @brief Suspend a task
  * @param task_id Task ID to suspend
@@ -116,6 +262,7 @@ tcb_t* task_get_current(void);
  * @param task_id Task ID
  * @param new_state New task state
  * @return rtos_result_t Success or error code
+ * @note Adds/removes the task from the scheduler ready queue as needed
  */
 rtos_result_t task_set_state(uint8_t task_id, task_state_t new_state);
 
@@ -128,15 +275,144 @@ task_state_t task_get_state(uint8_t task_id);
 
 /**
  * @brief Update task delay counters (called by timer ISR)
+ * @note Only the head of the delta-ordered delay list is touched, so the
+ *       cost does not depend on MAX_TASKS or on the number of delayed tasks
  */
 void task_update_delays(void);
 
+/**
+ * @brief Get ticks until the earliest delayed task wakes up
+ * @return uint32_t Ticks to next wakeup (0xFFFFFFFF if no task is delayed)
+ */
+uint32_t task_get_next_wakeup(void);
+
+/**
+ * @brief Advance all task delays by several ticks at once (tickless idle)
+ * @param ticks Ticks elapsed, must be less than task_get_next_wakeup()
+ */
+void task_step_delays(uint32_t ticks);
+
+/**
+ * @brief Initialize an empty wait list
+ * @param wait_list Wait list to initialize
+ */
+void task_wait_list_init(task_wait_list_t* wait_list);
+
+/**
+ * @brief Block the current task until woken or the timeout expires
+ * @param wait_list Object wait list to queue on in priority order (may be NULL)
+ * @param timeout_ticks Ticks to wait (TASK_WAIT_FOREVER for no timeout)
+ * @param wait_data Item buffer handed to the waker (may be NULL)
+ * @note Caller holds a critical section. It then leaves the critical section
+ *       and calls scheduler_yield(); afterwards tcb->wait_result holds the
+ *       outcome (RTOS_TIMEOUT if the timeout expired or the task was
+ *       suspended). Leaving BLOCKED always takes the task off wait_list.
+ */
+void task_block_current(task_wait_list_t* wait_list, uint32_t timeout_ticks, void* wait_data);
+
+/**
+ * @brief Wake a task blocked by task_block_current()
+ * @param tcb Blocked task (usually wait_list->head, the highest priority waiter)
+ * @param result Result code handed to the task (stored in wait_result)
+ * @note Caller holds a critical section
+ */
+void task_wake_blocked(tcb_t* tcb, int8_t result);
+
+/**
+ * @brief Send a notification to a task
+ * @param task_id Task to notify
+ * @param value Value combined into the task's notification word
+ * @param action How value is applied (set bits, increment, overwrite)
+ * @return rtos_result_t Success or error code
+ * @note Wakes the task if it waits in task_notify_wait()/task_notify_take()
+ *       and reschedules at once if it outranks the caller
+ */
+rtos_result_t task_notify(uint8_t task_id, uint32_t value, task_notify_action_t action);
+
+/**
+ * @brief Send a notification to a task from an ISR
+ * @param task_id Task to notify
+ * @param value Value combined into the task's notification word
+ * @param action How value is applied (set bits, increment, overwrite)
+ * @param task_woken Set to true if a waiting task was woken (may be NULL);
+ *        the ISR should then call scheduler_switch_context() before returning
+ * @return rtos_result_t Success or error code
+ */
+rtos_result_t task_notify_from_isr(uint8_t task_id, uint32_t value, task_notify_action_t action, bool* task_woken);
+
+/**
+ * @brief Wait for a notification to the current task
+ * @param clear_on_entry Bits cleared from the notification word before waiting
+ * @param clear_on_exit Bits cleared after a notification is received
+ * @param value_out Receives the notification word (before clear_on_exit, may be NULL)
+ * @param timeout_ticks Ticks to wait (0 = no wait, TASK_WAIT_FOREVER = forever)
+ * @return rtos_result_t Success, or RTOS_TIMEOUT if nothing arrived
+ * @note A notification sent before the call is consumed without blocking
+ */
+rtos_result_t task_notify_wait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t* value_out, uint32_t timeout_ticks);
+
+/**
+ * @brief Take from the notification word used as a counting/binary semaphore
+ * @param clear_on_exit True to reset the count to 0 (binary), false to decrement
+ * @param timeout_ticks Ticks to wait while the count is 0 (0 = no wait, TASK_WAIT_FOREVER = forever)
+ * @return uint32_t Count before taking (0 on timeout)
+ */
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout_ticks);
+
+/**
+ * @brief Change a task's effective priority
+ * @param tcb Task control block
+ * @param priority New effective priority (base_priority is left unchanged)
+ * @note Caller holds a critical section. A ready/running task moves to the
+ *       tail of its new ready_queues[] level, a blocked task is re-sorted in
+ *       its wait list. The caller decides whether to reschedule.
+ */
+void task_change_priority(tcb_t* tcb, uint8_t priority);
+
+/**
+ * @brief Free the stacks of tasks that deleted themselves
+ * @note Called from the idle task. A self-deleting task runs on its stack
+ *       until switched out, so its slot stays taken until this runs.
+ */
+void task_reclaim_stacks(void);
+
+/**
+ * @brief Measure a task's stack high-water mark
+ * @param task_id Task identifier
+ * @return uint32_t Fewest bytes the task has ever left unused (0 means it
+ *         reached or overran its limit), 0xFFFFFFFF if invalid or
+ *         RTOS_USE_STACK_CHECK is off
+ * @note Scans the painted region, cost grows with unused stack. Not for hot paths.
+ */
+uint32_t task_get_stack_high_water(uint8_t task_id);
+
+/**
+ * @brief Check one task's stack for overflow, round-robin over all tasks
+ * @return uint8_t ID of a task whose stack limit was overwritten, 0xFF if none
+ * @note Called from the idle task so scanning never lands on a hot path
+ */
+uint8_t task_check_stacks(void);
+
+/**
+ * @brief Stack overflow hook, called from the idle task on every detection
+ * @param task_id Task whose stack limit was overwritten
+ * @note Weak: the default suspends the task (or halts if the idle task itself
+ *       overflowed). Define your own to log, reset or fault instead.
+ */
+void rtos_stack_overflow_hook(uint8_t task_id);
+
 /**
  * @brief Get number of active tasks
  * @return uint8_t Number of active tasks
  */
 uint8_t task_get_count(void);
 
+/**
+ * @brief Get the task table size
+ * @return uint8_t Number of task slots (task IDs run from 0 to this - 1)
+ */
+uint8_t task_get_capacity(void);
+
 /**
  * @brief Print task information (for debugging)
  * @param task_id Task ID (0xFF for all tasks)
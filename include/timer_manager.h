@@ -12,13 +12,31 @@
 #define TIMER_MANAGER_H
 
 #include "rtos_config.h"
+#include "memory_manager.h"
 
 /* ============================================================================
  * TIMER CONFIGURATION
  * ============================================================================ */
-#define MAX_SOFTWARE_TIMERS         8       /* Maximum number of software timers */
+#define MAX_SOFTWARE_TIMERS         8       /* Timers in the default (static) timer table */
 #define TIMER_INVALID_ID            0xFF    /* Invalid timer ID */
 
+/* Timers live in an object table (timer_init_capacity); the slot index is
+ * the uint8_t timer ID */
+typedef object_handle_t timer_handle_t;
+
+/* Hierarchical timer wheel: each level has TIMER_WHEEL_SLOTS buckets, and
+ * each slot of level n spans TIMER_WHEEL_SLOTS^n ticks. Longer timeouts are
+ * parked in the last level and re-placed as they cascade down. */
+#define TIMER_WHEEL_BITS            4       /* 16 slots per level */
+#define TIMER_WHEEL_LEVELS          4       /* 16^4 = 65536 ticks direct range */
+#define TIMER_WHEEL_SLOTS           (1UL << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK            (TIMER_WHEEL_SLOTS - 1)
+
+/* Timer daemon task (RTOS_USE_TIMER_DAEMON) */
+#define TIMER_DAEMON_PRIORITY       PRIORITY_HIGH       /* Priority callbacks run at */
+#define TIMER_DAEMON_STACK_SIZE     DEFAULT_STACK_SIZE  /* Daemon task stack size */
+#define TIMER_COMMAND_QUEUE_LENGTH  16                  /* Expirations buffered for the daemon */
+
 /* ============================================================================
  * TIMER TYPES
  * ============================================================================ */
@@ -41,15 +59,20 @@ typedef void (*timer_callback_t)(uint8_t timer_id, void* user_data);
 /* ============================================================================
  * SOFTWARE TIMER STRUCTURE
  * ============================================================================ */
-typedef struct {
-    uint8_t timer_id;                       /* Timer identifier */
+typedef struct software_timer {
+    uint8_t timer_id;                       /* Timer identifier (slot index) */
     timer_type_t type;                      /* Timer type */
     timer_state_t state;                    /* Timer state */
     uint32_t period_ms;                     /* Timer period in milliseconds */
-    uint32_t remaining_ms;                  /* Remaining time in milliseconds */
+    uint32_t expiry_tick;                   /* Wheel tick at which the timer fires */
     timer_callback_t callback;              /* Callback function */
     void* user_data;                        /* User data for callback */
     bool is_active;                         /* Timer slot active */
+    uint8_t generation;                     /* Bumped by stop/delete: drops stale daemon posts */
+    timer_handle_t handle;                  /* Generation-checked handle for the slot */
+    struct software_timer** wheel_slot;     /* Wheel bucket holding the timer (NULL if none) */
+    struct software_timer* wheel_next;      /* Next timer in the same bucket */
+    struct software_timer* wheel_prev;      /* Previous timer in the same bucket */
 } software_timer_t;
 
 /* ============================================================================
@@ -59,9 +82,10 @@ typedef struct {
     uint32_t system_ticks;                  /* Total system ticks */
     uint32_t timer_interrupts;              /* Number of timer interrupts */
     uint32_t missed_ticks;                  /* Number of missed ticks */
-    uint32_t max_interrupt_time;            /* Maximum interrupt processing time */
-    uint32_t total_interrupt_time;          /* Total interrupt processing time */
+    uint32_t max_interrupt_time;            /* Maximum tick interrupt processing time (cycles) */
+    uint32_t total_interrupt_time;          /* Total tick interrupt processing time (cycles, wraps) */
     uint32_t software_timer_expirations;   /* Software timer expirations */
+    uint32_t daemon_queue_overflows;        /* Expirations dropped (daemon queue full) */
 } timer_stats_t;
 
 /* ============================================================================
@@ -71,9 +95,20 @@ typedef struct {
 /**
  * @brief Initialize the timer manager
  * @return rtos_result_t Success or error code
+ * @note Room for MAX_SOFTWARE_TIMERS timers in static storage
  */
 rtos_result_t timer_init(void);
 
+/**
+ * @brief Initialize the timer manager with a run-time software timer limit
+ * @param max_timers Timer table size (1 to 255, ignored without RTOS_USE_TIMERS)
+ * @return rtos_result_t Success or error code
+ * @note Call after memory_init(), instead of timer_init(). Up to
+ *       MAX_SOFTWARE_TIMERS uses the static table, larger tables are carved
+ *       from the heap. Creating and deleting a timer is O(1) either way.
+ */
+rtos_result_t timer_init_capacity(uint8_t max_timers);
+
 /**
  * @brief Start the system timer
  * @return rtos_result_t Success or error code
@@ -118,6 +153,21 @@ uint32_t timer_ticks_to_ms(uint32_t ticks);
  */
 void timer_interrupt_handler(void);
 
+/**
+ * @brief SysTick exception handler
+ * @note Forwards to timer_interrupt_handler()
+ */
+void SysTick_Handler(void);
+
+/**
+ * @brief Sleep until the next task delay or software timer deadline
+ * @note Called from the idle task with interrupts disabled (PRIMASK) and
+ *       returns with them still disabled. Stretches the SysTick period over
+ *       the whole idle time, executes WFI and corrects the tick count on wake.
+ */
+void timer_tickless_idle(void);
+
+#if RTOS_USE_TIMERS
 /* ============================================================================
  * FUNCTION PROTOTYPES - SOFTWARE TIMERS
  * ============================================================================ */
@@ -135,10 +185,41 @@ uint8_t timer_create(timer_type_t type,
                     timer_callback_t callback, 
                     void* user_data);
 
+/**
+ * @brief Create a software timer and return its handle
+ * @param type Timer type (one-shot or periodic)
+ * @param period_ms Timer period in milliseconds
+ * @param callback Callback function to call when timer expires
+ * @param user_data User data to pass to callback
+ * @return timer_handle_t Timer handle (OBJECT_HANDLE_INVALID if failed)
+ * @note Unlike a timer ID, a handle kept after timer_delete_handle() never
+ *       resolves to a new timer created in the same slot
+ */
+timer_handle_t timer_create_handle(timer_type_t type,
+                                   uint32_t period_ms,
+                                   timer_callback_t callback,
+                                   void* user_data);
+
+/**
+ * @brief Delete a software timer by handle
+ * @param handle Timer handle
+ * @return rtos_result_t Success, or RTOS_ERROR for a stale/invalid handle
+ */
+rtos_result_t timer_delete_handle(timer_handle_t handle);
+
+/**
+ * @brief Get the timer ID behind a handle, for the ID-based timer calls
+ * @param handle Timer handle
+ * @return uint8_t Timer ID (TIMER_INVALID_ID if the handle is stale or invalid)
+ */
+uint8_t timer_handle_get_id(timer_handle_t handle);
+
 /**
  * @brief Delete a software timer
  * @param timer_id Timer ID
  * @return rtos_result_t Success or error code
+ * @note An expiry already queued for the timer daemon is dropped, so the
+ *       callback never runs after this returns
  */
 rtos_result_t timer_delete(uint8_t timer_id);
 
@@ -153,6 +234,8 @@ rtos_result_t timer_start_timer(uint8_t timer_id);
  * @brief Stop a software timer
  * @param timer_id Timer ID
  * @return rtos_result_t Success or error code
+ * @note An expiry already queued for the timer daemon is dropped, so the
+ *       callback never runs after this returns
  */
 rtos_result_t timer_stop_timer(uint8_t timer_id);
 
@@ -184,6 +267,7 @@ timer_state_t timer_get_state(uint8_t timer_id);
  * @return uint32_t Remaining time in milliseconds
  */
 uint32_t timer_get_remaining_time(uint8_t timer_id);
+#endif /* RTOS_USE_TIMERS */
 
 /* ============================================================================
  * FUNCTION PROTOTYPES - DELAY FUNCTIONS
@@ -244,9 +328,11 @@ void timer_reset_stats(void);
  */
 void timer_print_info(void);
 
+#if RTOS_USE_TIMERS
 /**
  * @brief Print software timers status (for debugging)
  */
 void timer_print_software_timers(void);
+#endif
 
 #endif /* TIMER_MANAGER_H */
\ No newline at end of file
@@ -9,11 +9,16 @@
 
 #include "arm_cortex_m.h"
 
+#if !RTOS_PORT_POSIX /* Host builds use arm_cortex_m_posix.c */
+
 /* ============================================================================
  * GLOBAL VARIABLES
  * ============================================================================ */
 static bool cortex_m_initialized = false;
 
+volatile uint32_t cortex_m_critical_nesting = 0;                 /* ENTER_CRITICAL depth */
+const uint32_t cortex_m_syscall_basepri = RTOS_MAX_SYSCALL_BASEPRI; /* Read by PendSV_Handler */
+
 /* ============================================================================
  * PUBLIC FUNCTIONS
  * ============================================================================ */
@@ -31,6 +36,11 @@ rtos_result_t cortex_m_init(void)
     /* Set interrupt priorities for PendSV and SysTick */
     cortex_m_set_interrupt_priorities();
     
+#if RTOS_USE_MPU_STACK_GUARD
+    /* Guard regions were programmed by task_create() */
+    cortex_m_mpu_init();
+#endif
+    
     cortex_m_initialized = true;
     
     DEBUG_PRINT("ARM Cortex-M initialized\n");
@@ -92,6 +102,14 @@ void cortex_m_trigger_pendsv(void)
     NVIC_INT_CTRL_REG |= NVIC_PENDSVSET;
 }
 
+/**
+ * @brief Check whether the CPU is executing an exception handler
+ */
+bool cortex_m_in_interrupt(void)
+{
+    return (NVIC_INT_CTRL_REG & NVIC_VECTACTIVE_MASK) != 0;
+}
+
 /**
  * @brief Set priority for PendSV and SysTick interrupts
  */
@@ -104,6 +122,67 @@ void cortex_m_set_interrupt_priorities(void)
     NVIC_SYSPRI3_REG |= NVIC_SYSTICK_PRI;
 }
 
+/**
+ * @brief Turn on the MPU with the default memory map as background
+ */
+rtos_result_t cortex_m_mpu_init(void)
+{
+    if(MPU_TYPE_DREGION(MPU_TYPE_REG) == 0)
+    {
+        return RTOS_ERROR;
+    }
+    
+    SCB_SHCSR_REG |= SCB_SHCSR_MEMFAULTENA;
+    MPU_CTRL_REG = MPU_CTRL_ENABLE | MPU_CTRL_PRIVDEFENA;
+    
+    __asm volatile ("DSB\n\tISB" : : : "memory");
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Program a no-access guard region
+ */
+rtos_result_t cortex_m_mpu_set_guard(uint8_t region, const void* base)
+{
+    if(region >= MPU_TYPE_DREGION(MPU_TYPE_REG) ||
+       ((uintptr_t)base & (MPU_STACK_GUARD_SIZE - 1)) != 0)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    MPU_RNR_REG = region;
+    MPU_RBAR_REG = (uint32_t)(uintptr_t)base;
+    MPU_RASR_REG = MPU_RASR_XN | MPU_RASR_AP_NONE | MPU_RASR_SIZE(MPU_STACK_GUARD_LOG2) | MPU_RASR_ENABLE;
+    
+    __asm volatile ("DSB\n\tISB" : : : "memory");
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Disable an MPU region
+ */
+void cortex_m_mpu_clear_region(uint8_t region)
+{
+    MPU_RNR_REG = region;
+    MPU_RASR_REG = 0;
+    
+    __asm volatile ("DSB\n\tISB" : : : "memory");
+}
+
+/**
+ * @brief Enable the DWT cycle counter (never resets it)
+ */
+void cortex_m_cycle_counter_init(void)
+{
+    /* DWT is gated by the trace enable bit */
+    COREDEBUG_DEMCR_REG |= COREDEBUG_DEMCR_TRCENA;
+    
+    /* CYCCNT keeps running: stamps already taken stay comparable */
+    DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA;
+}
+
 /**
  * @brief Get current stack pointer
  */
@@ -162,4 +241,6 @@ uint32_t cortex_m_get_msp(void)
 void cortex_m_set_msp(uint32_t msp)
 {
     __asm volatile ("msr msp, %0" : : "r" (msp));
-}
\ No newline at end of file
+}
+
+#endif /* !RTOS_PORT_POSIX */
@@ -0,0 +1,466 @@
+/**
+ * @file arm_cortex_m_posix.c
+ * @brief Host (POSIX) implementation of the ARM Cortex-M layer
+ * @author Team Member 6 - System Integration
+ * @date 2024
+ *
+ * Lets the unmodified kernel run as a host process (RTOS_PORT_POSIX=1):
+ * core registers live in a simulated register file, PendSV switches
+ * ucontext stacks, and SysTick fires when the idle task executes WFI.
+ * Everything is single threaded and synchronous - a pending exception is
+ * taken as soon as PRIMASK, BASEPRI and any active handler allow it, exactly
+ * where the core would take it. Time is virtual except for DWT CYCCNT,
+ * which reads the host monotonic clock in nanoseconds.
+ *
+ * Example host build (benchmarks, no demo output needed):
+ *   cc -std=gnu99 -O2 -DRTOS_PORT_POSIX=1 -DRTOS_USE_BENCHMARKS=1 -Iinclude src/[a-z]*.c
+ */
+
+#define _GNU_SOURCE                         /* ucontext, clock_gettime (host only) */
+
+#include "arm_cortex_m.h"
+
+#if RTOS_PORT_POSIX /* Cortex-M builds use arm_cortex_m.c */
+
+#include <stdlib.h>
+#include <time.h>
+#include <ucontext.h>
+#include "scheduler.h"
+#include "rtos_latency.h"
+
+/* timer_manager.h is left out: its timer_create() clashes with <time.h> */
+void SysTick_Handler(void);
+
+/* ============================================================================
+ * HOST PORT CONFIGURATION
+ * ============================================================================ */
+#define HOST_EXC_PENDSV             14      /* Exception numbers (VECTACTIVE) */
+#define HOST_EXC_SYSTICK            15
+
+#define HOST_REG_BLOCK_WORDS        1024    /* One 4 KB block per peripheral */
+#define HOST_SCS_BASE               0xE000E000  /* NVIC, SCB, SysTick, MPU, DEMCR */
+#define HOST_DWT_BASE               0xE0001000
+#define HOST_ITM_BASE               0xE0000000
+
+/* ============================================================================
+ * GLOBAL VARIABLES
+ * ============================================================================ */
+static bool cortex_m_initialized = false;
+
+volatile uint32_t cortex_m_critical_nesting = 0;                 /* ENTER_CRITICAL depth */
+const uint32_t cortex_m_syscall_basepri = RTOS_MAX_SYSCALL_BASEPRI;
+volatile uint32_t cortex_m_host_primask = 0;
+volatile uint32_t cortex_m_host_basepri = 0;
+
+/* Simulated register file */
+static volatile uint32_t host_scs[HOST_REG_BLOCK_WORDS];
+static volatile uint32_t host_dwt[HOST_REG_BLOCK_WORDS];
+static volatile uint32_t host_itm[HOST_REG_BLOCK_WORDS];
+static volatile uint32_t host_unmapped;                 /* Sink for any other address */
+
+/* Pending exceptions and cycle counter origin */
+static volatile bool host_pendsv_pending = false;
+static volatile bool host_systick_pending = false;
+static uint64_t host_cycle_base = 0;
+
+/* Execution contexts: one per task ID, plus main() until the first switch */
+static ucontext_t host_main_context;
+static ucontext_t host_task_context[TASK_MAX_CAPACITY];
+static void* host_task_stack[TASK_MAX_CAPACITY];
+static void (*host_task_entry[TASK_MAX_CAPACITY])(void*);
+static void* host_task_arg[TASK_MAX_CAPACITY];
+
+/* ============================================================================
+ * PRIVATE FUNCTION PROTOTYPES
+ * ============================================================================ */
+static uint64_t host_clock_ns(void);
+static bool host_exceptions_masked(void);
+static void host_take_exception(uint32_t exception);
+static void host_pendsv(void);
+static void host_task_start(int task_id);
+
+/* ============================================================================
+ * PUBLIC FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Initialize ARM Cortex-M specific features
+ */
+rtos_result_t cortex_m_init(void)
+{
+    if(cortex_m_initialized)
+    {
+        return RTOS_SUCCESS;
+    }
+
+    cortex_m_set_interrupt_priorities();
+
+#if RTOS_USE_MPU_STACK_GUARD
+    /* The simulated core has no MPU (MPU_TYPE reads 0) */
+    cortex_m_mpu_init();
+#endif
+
+    cortex_m_initialized = true;
+
+    DEBUG_PRINT("Host Cortex-M port initialized\n");
+
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Configure SysTick timer
+ */
+rtos_result_t cortex_m_systick_config(uint32_t ticks)
+{
+    if(ticks == 0 || ticks > 0x00FFFFFF)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+
+    SYSTICK_LOAD_REG = ticks - 1;
+    SYSTICK_VAL_REG = 0;
+    SYSTICK_CTRL_REG = SYSTICK_ENABLE | SYSTICK_TICKINT | SYSTICK_CLKSOURCE;
+
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Start SysTick timer
+ */
+void cortex_m_systick_start(void)
+{
+    SYSTICK_CTRL_REG |= SYSTICK_ENABLE;
+}
+
+/**
+ * @brief Stop SysTick timer
+ */
+void cortex_m_systick_stop(void)
+{
+    SYSTICK_CTRL_REG &= ~SYSTICK_ENABLE;
+}
+
+/**
+ * @brief Pend PendSV; taken at once unless something masks it
+ */
+void cortex_m_trigger_pendsv(void)
+{
+    host_pendsv_pending = true;
+    cortex_m_host_service();
+}
+
+/**
+ * @brief Check whether the simulated core is executing an exception handler
+ */
+bool cortex_m_in_interrupt(void)
+{
+    return (NVIC_INT_CTRL_REG & NVIC_VECTACTIVE_MASK) != 0;
+}
+
+/**
+ * @brief Set priority for PendSV and SysTick interrupts
+ */
+void cortex_m_set_interrupt_priorities(void)
+{
+    /* Recorded only: SysTick is always taken before PendSV here */
+    NVIC_SYSPRI3_REG |= NVIC_PENDSV_PRI;
+    NVIC_SYSPRI3_REG |= NVIC_SYSTICK_PRI;
+}
+
+/**
+ * @brief Turn on the MPU (the simulated core has none)
+ */
+rtos_result_t cortex_m_mpu_init(void)
+{
+    return (MPU_TYPE_DREGION(MPU_TYPE_REG) == 0) ? RTOS_ERROR : RTOS_SUCCESS;
+}
+
+/**
+ * @brief Program a no-access guard region (rejected: no MPU regions)
+ */
+rtos_result_t cortex_m_mpu_set_guard(uint8_t region, const void* base)
+{
+    UNUSED(base);
+
+    return (region >= MPU_TYPE_DREGION(MPU_TYPE_REG)) ? RTOS_INVALID_PARAM : RTOS_SUCCESS;
+}
+
+/**
+ * @brief Disable an MPU region
+ */
+void cortex_m_mpu_clear_region(uint8_t region)
+{
+    UNUSED(region);
+}
+
+/**
+ * @brief Enable the cycle counter (host nanoseconds, never resets it)
+ */
+void cortex_m_cycle_counter_init(void)
+{
+    COREDEBUG_DEMCR_REG |= COREDEBUG_DEMCR_TRCENA;
+
+    if((DWT_CTRL_REG & DWT_CTRL_CYCCNTENA) == 0)
+    {
+        host_cycle_base = host_clock_ns();
+        DWT_CTRL_REG |= DWT_CTRL_CYCCNTENA;
+    }
+}
+
+/**
+ * @brief Get current stack pointer (address of a local on the host)
+ */
+uint32_t cortex_m_get_sp(void)
+{
+    volatile uint32_t marker = 0;
+
+    return (uint32_t)(uintptr_t)&marker;
+}
+
+/**
+ * @brief Set stack pointer (no effect on the host)
+ */
+void cortex_m_set_sp(uint32_t sp)
+{
+    UNUSED(sp);
+}
+
+/**
+ * @brief Get PSP (Process Stack Pointer)
+ */
+uint32_t cortex_m_get_psp(void)
+{
+    return cortex_m_get_sp();
+}
+
+/**
+ * @brief Set PSP (Process Stack Pointer)
+ */
+void cortex_m_set_psp(uint32_t psp)
+{
+    UNUSED(psp);
+}
+
+/**
+ * @brief Get MSP (Main Stack Pointer)
+ */
+uint32_t cortex_m_get_msp(void)
+{
+    return cortex_m_get_sp();
+}
+
+/**
+ * @brief Set MSP (Main Stack Pointer)
+ */
+void cortex_m_set_msp(uint32_t msp)
+{
+    UNUSED(msp);
+}
+
+/* ============================================================================
+ * HOST PORT FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Get the simulated register at a core peripheral address
+ */
+volatile uint32_t* cortex_m_host_reg(uint32_t addr)
+{
+    uint32_t word = (addr & 0xFFF) / sizeof(uint32_t);
+
+    switch(addr & ~0xFFFUL)
+    {
+        case HOST_SCS_BASE:
+            return &host_scs[word];
+
+        case HOST_DWT_BASE:
+            /* CYCCNT counts host nanoseconds once enabled (wraps like the DWT) */
+            if(addr == HOST_DWT_BASE + 4 && (host_dwt[0] & DWT_CTRL_CYCCNTENA))
+            {
+                host_dwt[word] = (uint32_t)(host_clock_ns() - host_cycle_base);
+            }
+            return &host_dwt[word];
+
+        case HOST_ITM_BASE:
+            /* Stimulus ports always read ready; writes are discarded */
+            host_itm[word] = 1;
+            return &host_itm[word];
+
+        default:
+            return &host_unmapped;
+    }
+}
+
+/**
+ * @brief Take pending SysTick/PendSV exceptions if nothing masks them
+ */
+void cortex_m_host_service(void)
+{
+    while(!host_exceptions_masked() && (host_systick_pending || host_pendsv_pending))
+    {
+        /* SysTick outranks PendSV; PendSV tail-chains after it */
+        if(host_systick_pending)
+        {
+            host_systick_pending = false;
+            host_take_exception(HOST_EXC_SYSTICK);
+        }
+        else
+        {
+            host_pendsv_pending = false;
+            host_pendsv();
+        }
+    }
+}
+
+/**
+ * @brief Sleep until the SysTick period ends
+ */
+void cortex_m_host_wfi(void)
+{
+    if((SYSTICK_CTRL_REG & (SYSTICK_ENABLE | SYSTICK_TICKINT)) != (SYSTICK_ENABLE | SYSTICK_TICKINT))
+    {
+        return; /* Nothing would ever wake the core */
+    }
+
+    /* Counter reaches zero, reloads and pends the exception */
+    SYSTICK_VAL_REG = SYSTICK_LOAD_REG;
+    SYSTICK_CTRL_REG |= SYSTICK_COUNTFLAG;
+    host_systick_pending = true;
+
+    cortex_m_host_service();
+}
+
+/**
+ * @brief Give a task its host execution context
+ */
+void cortex_m_host_task_init(uint8_t task_id, void (*entry)(void*), void* arg)
+{
+    if(task_id >= TASK_MAX_CAPACITY)
+    {
+        return;
+    }
+
+    /* Host stacks are kept across delete/create of the same slot */
+    if(host_task_stack[task_id] == NULL)
+    {
+        host_task_stack[task_id] = malloc(CORTEX_M_HOST_STACK_SIZE);
+
+        if(host_task_stack[task_id] == NULL)
+        {
+            cortex_m_host_exit(EXIT_FAILURE);
+        }
+    }
+
+    host_task_entry[task_id] = entry;
+    host_task_arg[task_id] = arg;
+
+    ucontext_t* context = &host_task_context[task_id];
+    getcontext(context);
+    context->uc_stack.ss_sp = host_task_stack[task_id];
+    context->uc_stack.ss_size = CORTEX_M_HOST_STACK_SIZE;
+    context->uc_link = NULL;
+    makecontext(context, (void (*)(void))host_task_start, 1, (int)task_id);
+}
+
+/**
+ * @brief End the host process
+ */
+void cortex_m_host_exit(int status)
+{
+    fflush(stdout);
+    exit(status);
+}
+
+/* ============================================================================
+ * PRIVATE FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Read the host monotonic clock
+ */
+static uint64_t host_clock_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Check whether a pending exception has to wait
+ * @note Both kernel exceptions sit at the lowest priority, so any active
+ *       handler, PRIMASK or non-zero BASEPRI holds them off
+ */
+static bool host_exceptions_masked(void)
+{
+    return cortex_m_host_primask != 0 ||
+           cortex_m_host_basepri != 0 ||
+           cortex_m_in_interrupt();
+}
+
+/**
+ * @brief Run a handler with VECTACTIVE set, as exception entry would
+ */
+static void host_take_exception(uint32_t exception)
+{
+    uint32_t active = NVIC_INT_CTRL_REG & NVIC_VECTACTIVE_MASK;
+
+    NVIC_INT_CTRL_REG = (NVIC_INT_CTRL_REG & ~NVIC_VECTACTIVE_MASK) | exception;
+
+    if(exception == HOST_EXC_SYSTICK)
+    {
+        SysTick_Handler();
+    }
+
+    NVIC_INT_CTRL_REG = (NVIC_INT_CTRL_REG & ~NVIC_VECTACTIVE_MASK) | active;
+}
+
+/**
+ * @brief PendSV_Handler equivalent: hand the core to scheduler_next_tcb
+ * @note Mirrors startup_ARMCM3.s. The outgoing task resumes here, in thread
+ *       mode, when it is next switched in.
+ */
+static void host_pendsv(void)
+{
+    NVIC_INT_CTRL_REG = (NVIC_INT_CTRL_REG & ~NVIC_VECTACTIVE_MASK) | HOST_EXC_PENDSV;
+
+    scheduler_runtime_switch();
+
+    tcb_t* outgoing = scheduler_current_tcb;
+    tcb_t* incoming = scheduler_next_tcb;
+    scheduler_current_tcb = incoming;
+
+    rtos_latency_pendsv_exit();
+
+    NVIC_INT_CTRL_REG &= ~NVIC_VECTACTIVE_MASK;
+
+    if(incoming == NULL || incoming == outgoing)
+    {
+        return;
+    }
+
+    /* A deleted task never resumes (and its slot may be reused): drop it */
+    if(outgoing != NULL && outgoing->state == TASK_STATE_DELETED)
+    {
+        setcontext(&host_task_context[incoming->task_id]);
+    }
+
+    /* First switch leaves main() behind, as the PSP switch does on target */
+    ucontext_t* from = (outgoing != NULL) ? &host_task_context[outgoing->task_id] : &host_main_context;
+
+    swapcontext(from, &host_task_context[incoming->task_id]);
+}
+
+/**
+ * @brief First code run on a task's host stack
+ */
+static void host_task_start(int task_id)
+{
+    host_task_entry[task_id](host_task_arg[task_id]);
+
+    /* Task entry loops forever; returning would end the process */
+    cortex_m_host_exit(EXIT_FAILURE);
+}
+
+#endif /* RTOS_PORT_POSIX */
@@ -1,17 +1,18 @@
 /**
  * @file main.c
- * @brief ARM RTOS Scheduler - Main Application Entry Point (SIMPLIFIED VERSION)
+ * @brief ARM RTOS Scheduler - Main Application Entry Point
  * @author Team Member 6 - System Integration
  * @date 2024
  * 
  * This file contains the main application entry point and system initialization.
  * Compatible with Keil uVision and ARM Cortex-M simulators.
  * 
- * SIMPLIFIED FOR BEGINNERS:
- * This version uses cooperative scheduling without infinite loops in tasks.
- * Tasks execute one iteration at a time and return control to the scheduler.
- * This allows the program to run completely without getting stuck.
- * See SIMPLIFIED_APPROACH.md for detailed explanation.
+ * EVENT-DRIVEN:
+ * main() brings up every kernel module, creates the demo tasks and hands the
+ * CPU to the preemptive scheduler. Tasks block on queues and delays instead
+ * of being polled; when nothing is ready the idle task sleeps in WFI (or
+ * tickless idle) until SysTick, a software timer or a queue post readies a
+ * task again, so cpu_utilization in the watch window tracks real work.
  */
 
 #include "rtos_config.h"
@@ -21,6 +22,17 @@
 #include "memory_manager.h"
 #include "timer_manager.h"
 #include "arm_cortex_m.h"
+#if RTOS_USE_BENCHMARKS
+#include "rtos_benchmark.h"
+#endif
+
+/* Demo configuration */
+#define SAMPLE_QUEUE                QUEUE_1 /* Comm/timer -> data processing */
+#define SAMPLE_QUEUE_LENGTH         4       /* Samples buffered */
+#define COMM_PERIOD_MS              50      /* Task 2 sample period */
+#define MONITOR_PERIOD_MS           1000    /* Task 3 report period */
+#define HEARTBEAT_PERIOD_MS         200     /* Software timer period */
+#define HEARTBEAT_SAMPLE            0xFFFFFFFF  /* Sample value posted by the timer */
 
 /* Global test variables visible in watch window */
 volatile int test_counter = 0;
@@ -30,20 +42,18 @@ volatile int system_init_done = 0;
 /* Debug variables - watch these instead of printf */
 volatile int debug_step = 0;        /* Shows current execution step */
 volatile int debug_counter = 0;     /* Debug activity counter */
-volatile char debug_buffer[32];     /* Debug message buffer - smaller */
-volatile int loop_progress = 0;     /* Shows loop progress */
 volatile char status_msg[32] = "";  /* Status message buffer - smaller */
 volatile int task_count = 0;        /* Number of tasks created */
 volatile int scheduler_active = 0;  /* Scheduler status */
 
 /* Task demonstration variables - watch these to see tasks running */
-volatile int task1_counter = 0;     /* Task 1 execution counter */
-volatile int task2_counter = 0;     /* Task 2 execution counter */
-volatile int task3_counter = 0;     /* Task 3 execution counter */
+volatile int task1_counter = 0;     /* Task 1 samples processed */
+volatile int task2_counter = 0;     /* Task 2 samples sent */
+volatile int task3_counter = 0;     /* Task 3 reports */
+volatile int heartbeat_counter = 0; /* Software timer expirations */
 volatile char current_task[20] = "";/* Currently running task name */
-volatile int scheduler_iterations = 0; /* Number of scheduler cycles */
-volatile int current_task_id = 0;   /* Current task in round robin (0,1,2) */
-volatile int time_slice_counter = 0;/* Time slice remaining for current task */
+volatile uint32_t cpu_utilization = 0;  /* Busy share of the CPU (%), from task 3 */
+volatile uint32_t context_switches = 0; /* Context switches so far, from task 3 */
 
 /* Simple debug function - just update variables, no printf */
 void debug_log(int step, const char* message) {
@@ -59,26 +69,19 @@ void debug_log(int step, const char* message) {
         }
         status_msg[i] = '\0';
     }
-    
-    /* Add delay so you can see the message in watch window */
-    for(volatile int i = 0; i < 500000; i++); /* Pause for visibility */
 }
 
-/* Simplified init functions for simulator */
-rtos_result_t memory_init_simple(void);
-rtos_result_t task_manager_init_simple(void);
-rtos_result_t queue_manager_init_simple(void);
-rtos_result_t timer_init_simple(void);
-rtos_result_t scheduler_init_simple(void);
-
-/* Simplified system init */
+/* System init */
 void system_init(void);
 
 /* Task functions for demonstration */
 void task1_high_priority(void);
 void task2_medium_priority(void);
 void task3_low_priority(void);
-void simple_scheduler(void);
+static void set_current_task(const char* task_name);
+#if RTOS_USE_TIMERS
+static void heartbeat_callback(uint8_t timer_id, void* user_data);
+#endif
 
 /**
  * @brief Main application entry point
@@ -88,127 +91,65 @@ int main(void)
 {
     main_reached = 1;  /* Set flag that main was reached */
     
-    /* Remove ITM initialization - it was causing issues */
-    debug_log(1, "HELLO WORLD - BASIC TEST");
-    
-    /* Test loop to see if we reach here */
-    for(int i = 0; i < 5; i++)
-    {
-        debug_log(10 + i, "Test loop running");
-        test_counter = i;  /* Update counter for watch window */
-        loop_progress = i + 1;  /* Show loop progress */
-    }
-    
-    debug_log(20, "Starting RTOS Scheduler");
+    debug_log(1, "Starting RTOS");
     
     /* Initialize system components */
-    debug_log(21, "About to call system_init");
     system_init();
-    debug_log(22, "system_init completed");
     system_init_done = 1;  /* Set flag that init is done */
     
-    /* Initialize RTOS components */
-    debug_log(23, "Initializing memory manager");
-    memory_init_simple();  /* Use simplified version */
-    debug_log(24, "Memory init completed");
-    
-    debug_log(25, "Initializing task manager");
-    task_manager_init_simple();  /* Use simplified version */
-    debug_log(26, "Task manager init completed");
-    
-    debug_log(27, "Initializing queue manager");
-    queue_manager_init_simple();  /* Use simplified version */
-    debug_log(28, "Queue manager init completed");
+    /* Initialize RTOS components (tasks before the scheduler's idle task
+     * and the timer daemon) */
+    debug_log(2, "Initializing kernel");
+    memory_init();
+    task_manager_init();
+    queue_manager_init();
+    scheduler_init();
+    timer_init();
     
-    debug_log(29, "Initializing timer");
-    timer_init_simple();  /* Use simplified version */
-    debug_log(30, "Timer init completed");
+    /* Samples flow from task 2 and the heartbeat timer to task 1 */
+    queue_create_sized(SAMPLE_QUEUE, SAMPLE_QUEUE_LENGTH, sizeof(uint32_t));
     
-    debug_log(31, "Initializing scheduler");
-    scheduler_init_simple();  /* Use simplified version */
-    debug_log(32, "Scheduler init completed");
+#if RTOS_USE_TIMERS
+    uint8_t heartbeat_timer = timer_create(TIMER_TYPE_PERIODIC, HEARTBEAT_PERIOD_MS,
+                                           heartbeat_callback, NULL);
+    timer_start_timer(heartbeat_timer);
+#endif
     
     /* Create example tasks */
-    debug_log(33, "Creating tasks");
-    debug_log(34, "3 tasks created successfully");
-    task_count = 3;  /* Set task count */
-    
-    debug_log(35, "Starting RTOS scheduler");
-    debug_log(36, "Scheduler now active");
-    scheduler_active = 1;  /* Mark scheduler as active */
-    
-    debug_log(37, "Running tasks demonstration");
-    debug_log(38, "Watch task counters!");
+    debug_log(3, "Creating tasks");
+    if(task_create(task1_high_priority, "Task1-DataProc", PRIORITY_HIGH, DEFAULT_STACK_SIZE) != 0xFF)
+    {
+        task_count++;
+    }
+    if(task_create(task2_medium_priority, "Task2-Comm", PRIORITY_MEDIUM, DEFAULT_STACK_SIZE) != 0xFF)
+    {
+        task_count++;
+    }
+    if(task_create(task3_low_priority, "Task3-Monitor", PRIORITY_LOW, DEFAULT_STACK_SIZE) != 0xFF)
+    {
+        task_count++;
+    }
     
-    /* Final success markers */
-    debug_step = 999;
-    debug_counter = 999;
+#if RTOS_USE_BENCHMARKS
+    /* Outranks the demo tasks: results land in rtos_benchmark_results[] */
+    rtos_benchmark_start();
+#endif
     
-    /* Give time to see the setup completion */
-    for(volatile int i = 0; i < 1000000; i++);
+    /* SysTick drives delays and timers from here on */
+    timer_start();
     
-    /* Update status to show task execution starting */
-    int i = 0;
-    const char* running_msg = "Tasks Running!";
-    while(running_msg[i] && i < 30) {
-        status_msg[i] = running_msg[i];
-        i++;
-    }
-    status_msg[i] = '\0';
+    debug_log(4, "Scheduler now active");
+    scheduler_active = 1;  /* Mark scheduler as active */
     
-    /* Now run the task scheduler demonstration */
-    simple_scheduler();
+    /* Switches to the highest priority task; only returns if none exist */
+    scheduler_start();
     
+    debug_log(999, "No tasks to run");
     return 0;  /* Never reached */
 }
 
 /**
- * @brief Simplified memory manager init for simulator
- */
-rtos_result_t memory_init_simple(void)
-{
-    debug_step = 301; /* Simple step update */
-    return RTOS_SUCCESS;
-}
-
-/**
- * @brief Simplified task manager init for simulator  
- */
-rtos_result_t task_manager_init_simple(void)
-{
-    debug_step = 401; /* Simple step update */
-    return RTOS_SUCCESS;
-}
-
-/**
- * @brief Simplified queue manager init for simulator
- */
-rtos_result_t queue_manager_init_simple(void)
-{
-    debug_step = 501; /* Simple step update */
-    return RTOS_SUCCESS;
-}
-
-/**
- * @brief Simplified timer init for simulator
- */
-rtos_result_t timer_init_simple(void)
-{
-    debug_step = 601; /* Simple step update */
-    return RTOS_SUCCESS;
-}
-
-/**
- * @brief Simplified scheduler init for simulator
- */
-rtos_result_t scheduler_init_simple(void)
-{
-    debug_step = 701; /* Simple step update */
-    return RTOS_SUCCESS;
-}
-
-/**
- * @brief System initialization function (SIMPLIFIED)
+ * @brief System initialization function
  */
 void system_init(void)
 {
@@ -217,102 +158,103 @@ void system_init(void)
 
 /**
  * @brief Task 1 - Data Processing Task
+ * @details Sleeps on the sample queue; each post wakes it directly
  */
 void task1_high_priority(void)
 {
-    task1_counter++;
+    uint32_t sample;
     
-    /* Update current task indicator */
-    const char* task_name = "Task1-DataProc";
-    for(int i = 0; i < 19 && task_name[i]; i++) {
-        current_task[i] = task_name[i];
+    while(1)
+    {
+        if(queue_receive(SAMPLE_QUEUE, &sample, QUEUE_TIMEOUT_INFINITE) == QUEUE_SUCCESS)
+        {
+            set_current_task("Task1-DataProc");
+            task1_counter++;
+            
+            if(sample == HEARTBEAT_SAMPLE)
+            {
+                heartbeat_counter++;
+            }
+            else
+            {
+                test_counter = (int)sample;
+            }
+        }
     }
-    current_task[19] = '\0';
-    
-    /* Equal execution time for fair Round Robin */
-    for(volatile int i = 0; i < 20000; i++);
 }
 
 /**
  * @brief Task 2 - Communication Task
+ * @details Produces one sample per COMM_PERIOD_MS; woken by the tick
  */
 void task2_medium_priority(void)
 {
-    task2_counter++;
+    uint32_t sample = 0;
     
-    /* Update current task indicator */
-    const char* task_name = "Task2-Comm";
-    for(int i = 0; i < 19 && task_name[i]; i++) {
-        current_task[i] = task_name[i];
+    while(1)
+    {
+        task_delay(COMM_PERIOD_MS);
+        
+        set_current_task("Task2-Comm");
+        sample++;
+        
+        if(queue_send(SAMPLE_QUEUE, &sample, 0) == QUEUE_SUCCESS)
+        {
+            task2_counter++;
+        }
     }
-    current_task[19] = '\0';
-    
-    /* Equal execution time for fair Round Robin */
-    for(volatile int i = 0; i < 20000; i++);
 }
 
 /**
  * @brief Task 3 - System Monitoring Task
+ * @details Publishes CPU utilization; with nothing polling, idle time is real
  */
 void task3_low_priority(void)
 {
-    task3_counter++;
+    scheduler_stats_t sched_stats;
     
-    /* Update current task indicator */
-    const char* task_name = "Task3-Monitor";
-    for(int i = 0; i < 19 && task_name[i]; i++) {
-        current_task[i] = task_name[i];
+    while(1)
+    {
+        task_delay(MONITOR_PERIOD_MS);
+        
+        set_current_task("Task3-Monitor");
+        task3_counter++;
+        
+        if(scheduler_get_stats(&sched_stats) == RTOS_SUCCESS)
+        {
+            cpu_utilization = sched_stats.cpu_utilization;
+            context_switches = sched_stats.total_context_switches;
+        }
+        
+        debug_log(100 + (task3_counter % 100), "Tasks Running!");
     }
-    current_task[19] = '\0';
-    
-    /* Equal execution time for fair Round Robin */
-    for(volatile int i = 0; i < 20000; i++);
 }
 
 /**
- * @brief Round Robin Scheduler Implementation
- * @details Gives equal CPU time to all tasks for fair execution
+ * @brief Show the running task in the watch window
  */
-void simple_scheduler(void)
+static void set_current_task(const char* task_name)
 {
-    while(1) {
-        scheduler_iterations++;
-        
-        /* Execute exactly one task per scheduler iteration for perfect Round Robin */
-        switch(current_task_id) {
-            case 0:
-                task1_high_priority();  /* Data Processing Task */
-                break;
-            case 1:
-                task2_medium_priority(); /* Communication Task */
-                break;
-            case 2:
-                task3_low_priority();   /* System Monitoring Task */
-                break;
-            default:
-                current_task_id = 0; /* Reset if invalid */
-                break;
-        }
-        
-        /* Move to next task after each execution - true Round Robin */
-        current_task_id = (current_task_id + 1) % 3;
-        time_slice_counter = current_task_id; /* Update for visibility */
-        
-        /* Update scheduler status message */
-        if(scheduler_iterations % 15 == 0) {
-            const char* sched_msg = "RoundRobin Perfect";
-            for(int i = 0; i < 30 && sched_msg[i]; i++) {
-                status_msg[i] = sched_msg[i];
-            }
-            status_msg[30] = '\0';
-        }
-        
-        /* Small delay to make execution visible */
-        for(volatile int i = 0; i < 100000; i++);
-        
-        /* Reset counter periodically to prevent overflow */
-        if(scheduler_iterations >= 1000) {
-            scheduler_iterations = 0;
-        }
+    int i = 0;
+    while(task_name[i] && i < 19) {
+        current_task[i] = task_name[i];
+        i++;
     }
-}
\ No newline at end of file
+    current_task[i] = '\0';
+}
+
+#if RTOS_USE_TIMERS
+/**
+ * @brief Heartbeat timer callback - a timer expiration waking task 1
+ */
+static void heartbeat_callback(uint8_t timer_id, void* user_data)
+{
+    UNUSED(timer_id);
+    UNUSED(user_data);
+    
+    uint32_t sample = HEARTBEAT_SAMPLE;
+    
+    /* Never blocks: callbacks may run in the tick ISR */
+    queue_send(SAMPLE_QUEUE, &sample, 0);
+}
+#endif
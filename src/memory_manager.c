@@ -4,30 +4,59 @@
  * @author Team Member 4 - Memory Management
  * @date 2024
  * 
- * This module implements dynamic memory allocation using a first-fit algorithm
- * with coalescing of adjacent free blocks.
+ * This module implements dynamic memory allocation using either a first-fit
+ * algorithm with coalescing of adjacent free blocks, or a two-level
+ * segregated fit (TLSF) allocator with O(1) alloc/free (MEMORY_ALLOCATOR).
+ * The heap is a set of independent regions (built-in heap[] plus any RAM
+ * added with memory_add_region()), each with its own free lists.
  */
 
 #include "memory_manager.h"
+#include "arm_cortex_m.h"
+
+#if HEAP_SIZE > MEMORY_REGION_MAX_SIZE
+#error "HEAP_SIZE larger than MEMORY_REGION_MAX_SIZE"
+#endif
 
 /* ============================================================================
  * GLOBAL VARIABLES
  * ============================================================================ */
-static uint8_t heap[HEAP_SIZE];             /* Static heap memory */
-static memory_block_t* free_list = NULL;    /* Head of free blocks list */
-static memory_stats_t stats;                /* Memory statistics */
+static uint8_t heap[HEAP_SIZE] __attribute__((aligned(MEMORY_ALIGNMENT)));  /* Static heap memory */
+static memory_region_t regions[MAX_MEMORY_REGIONS]; /* Heap regions (allocator state) */
+static memory_stats_t stats;                /* Memory statistics (all regions) */
+static memory_pool_t pools[MAX_MEMORY_POOLS];   /* Fixed-size block pools */
 static bool memory_initialized = false;
 
 /* ============================================================================
  * PRIVATE FUNCTION PROTOTYPES
  * ============================================================================ */
-static memory_block_t* memory_find_free_block(uint32_t size);
-static void memory_split_block(memory_block_t* block, uint32_t size);
-static void memory_coalesce_blocks(void);
-static void memory_insert_free_block(memory_block_t* block);
-static void memory_remove_free_block(memory_block_t* block);
+static void memory_region_setup(memory_region_t* region, uint8_t* start, uint32_t size, uint32_t attrs);
+static memory_region_t* memory_find_region(void* addr);
+static void* memory_alloc_placed(uint32_t size, uint32_t attr_mask, uint32_t attr_match);
+static memory_block_t* memory_region_take(memory_region_t* region, uint32_t size);
+static uint32_t memory_request_size(uint32_t size);
+static memory_block_t* memory_find_free_block(memory_region_t* region, uint32_t size);
+static void memory_split_block(memory_region_t* region, memory_block_t* block, uint32_t size);
+#if MEMORY_ALLOCATOR != MEMORY_ALLOCATOR_TLSF
+static void memory_coalesce_blocks(memory_region_t* region);
+#endif
+static void memory_insert_free_block(memory_region_t* region, memory_block_t* block);
+static void memory_remove_free_block(memory_region_t* region, memory_block_t* block);
 static uint32_t memory_align_size(uint32_t size);
 static void memory_update_stats(void);
+static uint32_t memory_region_largest(const memory_region_t* region);
+static bool memory_resize_block(memory_region_t* region, memory_block_t* block, uint32_t size);
+static memory_block_t* memory_next_phys(const memory_region_t* region, memory_block_t* block);
+#if MEMORY_ALLOCATOR != MEMORY_ALLOCATOR_TLSF
+static void memory_ff_class_add(memory_region_t* region, uint32_t size);
+static void memory_ff_class_remove(memory_region_t* region, uint32_t size);
+#endif
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+static void memory_tlsf_mapping(uint32_t size, uint32_t* fl, uint32_t* sl);
+static memory_block_t* memory_merge_block(memory_region_t* region, memory_block_t* block);
+#endif
+static rtos_result_t object_table_setup(object_table_t* table, void* storage, uint16_t* generations,
+                                        uint32_t object_size, uint32_t capacity);
 
 /* ============================================================================
  * PUBLIC FUNCTIONS
@@ -46,20 +75,25 @@ rtos_result_t memory_init(void)
     /* Clear heap */
     memset(heap, 0, HEAP_SIZE);
     
-    /* Initialize first free block covering entire heap */
-    free_list = (memory_block_t*)heap;
-    free_list->magic = MEMORY_MAGIC_FREE;
-    free_list->size = HEAP_SIZE;
-    free_list->next = NULL;
-    free_list->prev = NULL;
-    
-    /* Initialize statistics */
+    /* Initialize statistics (the free lists keep free_blocks_count) */
     memset(&stats, 0, sizeof(memory_stats_t));
-    stats.total_heap_size = HEAP_SIZE;
-    stats.free_heap_size = HEAP_SIZE - sizeof(memory_block_t);
-    stats.min_free_heap_size = stats.free_heap_size;
-    stats.largest_free_block = stats.free_heap_size;
-    stats.free_blocks_count = 1;
+    
+    /* Initialize region table; the built-in heap is always region 0 */
+    memset(regions, 0, sizeof(regions));
+    for(int i = 0; i < MAX_MEMORY_REGIONS; i++)
+    {
+        regions[i].region_id = i;
+    }
+    
+    memory_region_setup(&regions[MEMORY_REGION_HEAP], heap, HEAP_SIZE, MEMORY_HEAP_ATTRS);
+    memory_update_stats();
+    
+    /* Initialize pool table */
+    memset(pools, 0, sizeof(pools));
+    for(int i = 0; i < MAX_MEMORY_POOLS; i++)
+    {
+        pools[i].pool_id = i;
+    }
     
     memory_initialized = true;
     
@@ -69,71 +103,125 @@ rtos_result_t memory_init(void)
 }
 
 /**
- * @brief Allocate memory block
+ * @brief Add an address range to the heap as a new region
  */
-void* memory_alloc(uint32_t size)
+uint8_t memory_add_region(void* start, uint32_t size, uint32_t attrs)
 {
-    if(!memory_initialized || size == 0)
+    if(!memory_initialized || start == NULL)
     {
-        return NULL;
+        return MEMORY_REGION_INVALID_ID;
     }
     
-    /* Align size and add header overhead */
-    uint32_t aligned_size = memory_align_size(size + sizeof(memory_block_t));
+    /* Trim the range to whole aligned blocks */
+    uint8_t* aligned_start = (uint8_t*)(((uintptr_t)start + MEMORY_ALIGNMENT - 1) & ~(uintptr_t)(MEMORY_ALIGNMENT - 1));
+    uint32_t skipped = (uint32_t)(aligned_start - (uint8_t*)start);
     
-    if(aligned_size < MIN_BLOCK_SIZE)
+    if(size < skipped + MIN_BLOCK_SIZE)
     {
-        aligned_size = MIN_BLOCK_SIZE;
+        return MEMORY_REGION_INVALID_ID;
+    }
+    
+    size = (size - skipped) & ~(MEMORY_ALIGNMENT - 1);
+    
+    if(size > MEMORY_REGION_MAX_SIZE)
+    {
+        DEBUG_PRINT("Memory region of %u bytes exceeds MEMORY_REGION_MAX_SIZE\n", size);
+        return MEMORY_REGION_INVALID_ID;
     }
     
     ENTER_CRITICAL();
     
-    /* Find suitable free block */
-    memory_block_t* block = memory_find_free_block(aligned_size);
+    uint8_t region_id = MEMORY_REGION_INVALID_ID;
+    for(int i = 0; i < MAX_MEMORY_REGIONS; i++)
+    {
+        memory_region_t* region = &regions[i];
+        
+        if(!region->is_active)
+        {
+            if(region_id == MEMORY_REGION_INVALID_ID)
+            {
+                region_id = i;
+            }
+        }
+        else if(aligned_start < region->start + region->size &&
+                region->start < aligned_start + size)
+        {
+            region_id = MEMORY_REGION_INVALID_ID; /* Overlaps an existing region */
+            break;
+        }
+    }
     
-    if(block == NULL)
+    if(region_id != MEMORY_REGION_INVALID_ID)
     {
-        EXIT_CRITICAL();
-        stats.failed_allocations++;
-        DEBUG_PRINT("Memory allocation failed for %u bytes\n", size);
-        return NULL;
+        memory_region_setup(&regions[region_id], aligned_start, size, attrs);
     }
     
-    /* Remove block from free list */
-    memory_remove_free_block(block);
+    EXIT_CRITICAL();
     
-    /* Split block if too large */
-    if(block->size >= aligned_size + MIN_BLOCK_SIZE)
+    if(region_id != MEMORY_REGION_INVALID_ID)
     {
-        memory_split_block(block, aligned_size);
+        DEBUG_PRINT("Memory region %d added (%u bytes at %p)\n", region_id, size, aligned_start);
     }
     
-    /* Mark block as used */
-    block->magic = MEMORY_MAGIC_USED;
+    return region_id;
+}
+
+/**
+ * @brief Allocate memory block
+ */
+void* memory_alloc(uint32_t size)
+{
+    /* Keep general allocations out of fast memory while anything else has room */
+    return memory_alloc_placed(size, MEMORY_REGION_ATTR_FAST, 0);
+}
+
+/**
+ * @brief Allocate memory block from one region only
+ */
+void* memory_alloc_in(uint8_t region_id, uint32_t size)
+{
+    if(!memory_initialized || size == 0 || region_id >= MAX_MEMORY_REGIONS)
+    {
+        return NULL;
+    }
     
-    /* Update statistics */
-    stats.allocation_count++;
-    stats.used_heap_size += block->size;
-    stats.free_heap_size -= block->size;
+    uint32_t aligned_size = memory_request_size(size);
     
-    if(stats.used_heap_size > stats.max_used_heap_size)
+    ENTER_CRITICAL();
+    
+    memory_block_t* block = NULL;
+    if(regions[region_id].is_active)
     {
-        stats.max_used_heap_size = stats.used_heap_size;
+        block = memory_region_take(&regions[region_id], aligned_size);
     }
     
-    if(stats.free_heap_size < stats.min_free_heap_size)
+#if RTOS_USE_STATS
+    if(block == NULL)
     {
-        stats.min_free_heap_size = stats.free_heap_size;
+        stats.failed_allocations++;
     }
-    
-    memory_update_stats();
+#endif
     
     EXIT_CRITICAL();
     
+    if(block == NULL)
+    {
+        DEBUG_PRINT("Memory allocation failed for %u bytes in region %d\n", size, region_id);
+        return NULL;
+    }
+    
     /* Return pointer to user data (skip header) */
     return (void*)((uint8_t*)block + sizeof(memory_block_t));
 }
 
+/**
+ * @brief Allocate memory block, preferring regions with given attributes
+ */
+void* memory_alloc_prefer(uint32_t attrs, uint32_t size)
+{
+    return memory_alloc_placed(size, attrs, attrs);
+}
+
 /**
  * @brief Free previously allocated memory block
  */
@@ -147,17 +235,18 @@ rtos_result_t memory_free(void* ptr)
     /* Get block header */
     memory_block_t* block = (memory_block_t*)((uint8_t*)ptr - sizeof(memory_block_t));
     
-    /* Validate block */
-    if(block->magic != MEMORY_MAGIC_USED)
+    /* Check bounds */
+    memory_region_t* region = memory_find_region(block);
+    if(region == NULL)
     {
-        DEBUG_PRINT("Invalid memory block or double free detected\n");
+        DEBUG_PRINT("Memory block outside heap bounds\n");
         return RTOS_ERROR;
     }
     
-    /* Check bounds */
-    if((uint8_t*)block < heap || (uint8_t*)block >= heap + HEAP_SIZE)
+    /* Validate block */
+    if(block->magic != MEMORY_MAGIC_USED)
     {
-        DEBUG_PRINT("Memory block outside heap bounds\n");
+        DEBUG_PRINT("Invalid memory block or double free detected\n");
         return RTOS_ERROR;
     }
     
@@ -167,17 +256,24 @@ rtos_result_t memory_free(void* ptr)
     block->magic = MEMORY_MAGIC_FREE;
     
     /* Update statistics */
+#if RTOS_USE_STATS
     stats.free_count++;
+#endif
     stats.used_heap_size -= block->size;
     stats.free_heap_size += block->size;
+    region->used_size -= block->size;
     
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+    /* Merge with free physical neighbours, then file the result */
+    block = memory_merge_block(region, block);
+    memory_insert_free_block(region, block);
+#else
     /* Add block to free list */
-    memory_insert_free_block(block);
+    memory_insert_free_block(region, block);
     
     /* Coalesce adjacent free blocks */
-    memory_coalesce_blocks();
-    
-    memory_update_stats();
+    memory_coalesce_blocks(region);
+#endif
     
     EXIT_CRITICAL();
     
@@ -212,15 +308,23 @@ void* memory_realloc(void* ptr, uint32_t new_size)
         return NULL; /* Invalid pointer */
     }
     
-    /* If new size fits in current block, return same pointer */
-    uint32_t aligned_new_size = memory_align_size(new_size + sizeof(memory_block_t));
-    if(aligned_new_size <= current_size)
+    memory_block_t* block = (memory_block_t*)((uint8_t*)ptr - sizeof(memory_block_t));
+    memory_region_t* region = memory_find_region(block);
+    
+    /* Grow into / shrink onto the physically next block where possible */
+    ENTER_CRITICAL();
+    
+    bool resized = memory_resize_block(region, block, memory_request_size(new_size));
+    
+    EXIT_CRITICAL();
+    
+    if(resized)
     {
         return ptr;
     }
     
-    /* Allocate new block */
-    void* new_ptr = memory_alloc(new_size);
+    /* No room next to the block: allocate (in like memory), copy and free */
+    void* new_ptr = memory_alloc_placed(new_size, region->attrs, region->attrs);
     if(new_ptr == NULL)
     {
         return NULL;
@@ -236,7 +340,6 @@ void* memory_realloc(void* ptr, uint32_t new_size)
     
     return new_ptr;
 }
-
 /**
  * @brief Allocate and clear memory block
  */
@@ -274,7 +377,10 @@ rtos_result_t memory_get_stats(memory_stats_t* stats_out)
         return RTOS_INVALID_PARAM;
     }
     
+    /* Constant time: every figure is either kept by alloc/free or read off
+     * the size-class bitmaps */
     ENTER_CRITICAL();
+    memory_update_stats();
     *stats_out = stats;
     EXIT_CRITICAL();
     
@@ -302,7 +408,47 @@ uint32_t memory_get_used_size(void)
  */
 uint32_t memory_get_largest_free_block(void)
 {
-    return memory_initialized ? stats.largest_free_block : 0;
+    if(!memory_initialized)
+    {
+        return 0;
+    }
+    
+    ENTER_CRITICAL();
+    memory_update_stats();
+    EXIT_CRITICAL();
+    
+    return stats.largest_free_block;
+}
+
+/**
+ * @brief Get information about one heap region
+ */
+rtos_result_t memory_get_region_info(uint8_t region_id, memory_region_info_t* info)
+{
+    if(!memory_initialized || region_id >= MAX_MEMORY_REGIONS || info == NULL)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    memory_region_t* region = &regions[region_id];
+    
+    if(!region->is_active)
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    info->start = region->start;
+    info->size = region->size;
+    info->attrs = region->attrs;
+    info->used_size = region->used_size;
+    info->free_size = region->size - region->used_size;
+    info->largest_free_block = memory_region_largest(region);
+    
+    EXIT_CRITICAL();
+    
+    return RTOS_SUCCESS;
 }
 
 /**
@@ -319,7 +465,7 @@ bool memory_is_valid_ptr(void* ptr)
     memory_block_t* block = (memory_block_t*)((uint8_t*)ptr - sizeof(memory_block_t));
     
     /* Check bounds */
-    if((uint8_t*)block < heap || (uint8_t*)block >= heap + HEAP_SIZE)
+    if(memory_find_region(block) == NULL)
     {
         return false;
     }
@@ -354,8 +500,16 @@ rtos_result_t memory_defragment(void)
     
     ENTER_CRITICAL();
     
-    /* Coalesce all adjacent free blocks */
-    memory_coalesce_blocks();
+#if MEMORY_ALLOCATOR != MEMORY_ALLOCATOR_TLSF
+    /* Coalesce all adjacent free blocks (TLSF merges on every free) */
+    for(int i = 0; i < MAX_MEMORY_REGIONS; i++)
+    {
+        if(regions[i].is_active)
+        {
+            memory_coalesce_blocks(&regions[i]);
+        }
+    }
+#endif
     
     memory_update_stats();
     
@@ -376,41 +530,66 @@ rtos_result_t memory_check_integrity(void)
     
     ENTER_CRITICAL();
     
-    /* Walk through heap and verify block structure */
-    uint8_t* current = heap;
-    uint32_t total_checked = 0;
-    
-    while(current < heap + HEAP_SIZE)
+    /* Walk through every region and verify block structure */
+    for(int i = 0; i < MAX_MEMORY_REGIONS; i++)
     {
-        memory_block_t* block = (memory_block_t*)current;
+        memory_region_t* region = &regions[i];
         
-        /* Check magic number */
-        if(block->magic != MEMORY_MAGIC_FREE && block->magic != MEMORY_MAGIC_USED)
+        if(!region->is_active)
         {
-            EXIT_CRITICAL();
-            DEBUG_PRINT("Heap corruption detected: invalid magic at %p\n", block);
-            return RTOS_ERROR;
+            continue;
+        }
+        
+        uint8_t* current = region->start;
+        uint8_t* end = region->start + region->size;
+        uint32_t total_checked = 0;
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+        memory_block_t* previous = NULL;
+#endif
+        
+        while(current < end)
+        {
+            memory_block_t* block = (memory_block_t*)current;
+            
+            /* Check magic number */
+            if(block->magic != MEMORY_MAGIC_FREE && block->magic != MEMORY_MAGIC_USED)
+            {
+                EXIT_CRITICAL();
+                DEBUG_PRINT("Heap corruption detected: invalid magic at %p\n", block);
+                return RTOS_ERROR;
+            }
+            
+            /* Check block size */
+            if(block->size < sizeof(memory_block_t) || 
+               current + block->size > end)
+            {
+                EXIT_CRITICAL();
+                DEBUG_PRINT("Heap corruption detected: invalid size at %p\n", block);
+                return RTOS_ERROR;
+            }
+            
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+            /* Check boundary tag */
+            if(block->prev_phys != previous)
+            {
+                EXIT_CRITICAL();
+                DEBUG_PRINT("Heap corruption detected: invalid boundary tag at %p\n", block);
+                return RTOS_ERROR;
+            }
+            previous = block;
+#endif
+            
+            total_checked += block->size;
+            current += block->size;
         }
         
-        /* Check block size */
-        if(block->size < sizeof(memory_block_t) || 
-           current + block->size > heap + HEAP_SIZE)
+        /* Verify total size */
+        if(total_checked != region->size)
         {
             EXIT_CRITICAL();
-            DEBUG_PRINT("Heap corruption detected: invalid size at %p\n", block);
+            DEBUG_PRINT("Heap corruption detected: size mismatch in region %d\n", i);
             return RTOS_ERROR;
         }
-        
-        total_checked += block->size;
-        current += block->size;
-    }
-    
-    /* Verify total size */
-    if(total_checked != HEAP_SIZE)
-    {
-        EXIT_CRITICAL();
-        DEBUG_PRINT("Heap corruption detected: size mismatch\n");
-        return RTOS_ERROR;
     }
     
     EXIT_CRITICAL();
@@ -430,17 +609,45 @@ void memory_print_info(void)
         return;
     }
     
+    memory_update_stats();
+    
     DEBUG_PRINT("=== Memory Information ===\n");
     DEBUG_PRINT("Total Heap: %u bytes\n", stats.total_heap_size);
     DEBUG_PRINT("Used: %u bytes\n", stats.used_heap_size);
     DEBUG_PRINT("Free: %u bytes\n", stats.free_heap_size);
     DEBUG_PRINT("Largest Free Block: %u bytes\n", stats.largest_free_block);
     DEBUG_PRINT("Free Blocks: %u\n", stats.free_blocks_count);
+    DEBUG_PRINT("Fragmentation: %u%%\n", stats.fragmentation_index);
     DEBUG_PRINT("Allocations: %u\n", stats.allocation_count);
     DEBUG_PRINT("Frees: %u\n", stats.free_count);
     DEBUG_PRINT("Failed Allocations: %u\n", stats.failed_allocations);
     DEBUG_PRINT("Max Used: %u bytes\n", stats.max_used_heap_size);
     DEBUG_PRINT("Min Free: %u bytes\n", stats.min_free_heap_size);
+    
+    for(int i = 0; i < MAX_MEMORY_REGIONS; i++)
+    {
+        memory_region_t* region = &regions[i];
+        
+        if(region->is_active)
+        {
+            DEBUG_PRINT("Region %d: %p, %u bytes, attrs 0x%x, Used: %u, Largest Free: %u\n",
+                       i, region->start, region->size, region->attrs, region->used_size,
+                       memory_region_largest(region));
+        }
+    }
+    
+    for(int i = 0; i < MAX_MEMORY_POOLS; i++)
+    {
+        memory_pool_t* pool = &pools[i];
+        
+        if(pool->is_active)
+        {
+            DEBUG_PRINT("Pool %d: %u x %u bytes, Free: %u (min %u), Allocs: %u, Frees: %u, Failed: %u\n",
+                       i, pool->block_count, pool->block_size, pool->free_blocks,
+                       pool->min_free_blocks, pool->allocation_count, pool->free_count,
+                       pool->failed_allocations);
+        }
+    }
 }
 
 /**
@@ -455,18 +662,30 @@ void memory_print_heap_layout(void)
     
     DEBUG_PRINT("=== Heap Layout ===\n");
     
-    uint8_t* current = heap;
-    int block_num = 0;
-    
-    while(current < heap + HEAP_SIZE)
+    for(int i = 0; i < MAX_MEMORY_REGIONS; i++)
     {
-        memory_block_t* block = (memory_block_t*)current;
+        memory_region_t* region = &regions[i];
+        
+        if(!region->is_active)
+        {
+            continue;
+        }
         
-        DEBUG_PRINT("Block %d: %p, Size: %d, %s\n", 
-                   block_num++, block, block->size,
-                   (block->magic == MEMORY_MAGIC_FREE) ? "FREE" : "USED");
+        DEBUG_PRINT("Region %d:\n", i);
         
-        current += block->size;
+        uint8_t* current = region->start;
+        int block_num = 0;
+        
+        while(current < region->start + region->size)
+        {
+            memory_block_t* block = (memory_block_t*)current;
+            
+            DEBUG_PRINT("Block %d: %p, Size: %d, %s\n", 
+                       block_num++, block, block->size,
+                       (block->magic == MEMORY_MAGIC_FREE) ? "FREE" : "USED");
+            
+            current += block->size;
+        }
     }
 }
 
@@ -492,117 +711,936 @@ void memory_reset_stats(void)
 }
 
 /* ============================================================================
- * PRIVATE FUNCTIONS
+ * MEMORY POOL FUNCTIONS
  * ============================================================================ */
 
 /**
- * @brief Find free block of sufficient size
+ * @brief Create a pool of fixed-size blocks
  */
-static memory_block_t* memory_find_free_block(uint32_t size)
+uint8_t pool_create(void* region, uint32_t block_size, uint32_t block_count)
 {
-    memory_block_t* current = free_list;
+    if(!memory_initialized || block_size == 0 || block_count == 0)
+    {
+        return POOL_INVALID_ID;
+    }
     
-    /* First-fit algorithm */
-    while(current != NULL)
+    if(region != NULL && ((uintptr_t)region & (MEMORY_ALIGNMENT - 1)) != 0)
     {
-        if(current->size >= size)
-        {
-            return current;
-        }
-        current = current->next;
+        return POOL_INVALID_ID;
     }
     
-    return NULL; /* No suitable block found */
-}
-
-/**
- * @brief Split block into allocated and free parts
- */
-static void memory_split_block(memory_block_t* block, uint32_t size)
-{
-    if(block->size <= size + sizeof(memory_block_t))
+    uint32_t aligned_size = POOL_BLOCK_SIZE(block_size);
+    
+    if(block_count > 0xFFFFFFFF / aligned_size)
     {
-        return; /* Block too small to split */
+        return POOL_INVALID_ID;
     }
     
-    /* Create new free block */
-    memory_block_t* new_block = (memory_block_t*)((uint8_t*)block + size);
-    new_block->magic = MEMORY_MAGIC_FREE;
-    new_block->size = block->size - size;
-    new_block->next = NULL;
-    new_block->prev = NULL;
+    /* Reserve a pool slot */
+    ENTER_CRITICAL();
     
-    /* Update original block size */
-    block->size = size;
+    uint8_t pool_id = POOL_INVALID_ID;
+    for(int i = 0; i < MAX_MEMORY_POOLS; i++)
+    {
+        if(!pools[i].is_active)
+        {
+            pool_id = i;
+            pools[i].is_active = true;
+            break;
+        }
+    }
     
-    /* Add new block to free list */
-    memory_insert_free_block(new_block);
-}
-
-/**
- * @brief Coalesce adjacent free blocks
- */
-static void memory_coalesce_blocks(void)
-{
-    /* Simple coalescing: walk through heap and merge adjacent free blocks */
-    uint8_t* current = heap;
+    EXIT_CRITICAL();
     
-    while(current < heap + HEAP_SIZE)
+    if(pool_id == POOL_INVALID_ID)
     {
-        memory_block_t* block = (memory_block_t*)current;
+        return POOL_INVALID_ID;
+    }
+    
+    memory_pool_t* pool = &pools[pool_id];
+    
+    /* No region given: carve one out of the heap */
+    pool->owns_region = (region == NULL);
+    if(region == NULL)
+    {
+        region = memory_alloc(aligned_size * block_count);
         
-        if(block->magic == MEMORY_MAGIC_FREE)
+        if(region == NULL)
         {
-            /* Check if next block is also free */
-            uint8_t* next_addr = current + block->size;
-            
-            if(next_addr < heap + HEAP_SIZE)
-            {
-                memory_block_t* next_block = (memory_block_t*)next_addr;
-                
-                if(next_block->magic == MEMORY_MAGIC_FREE)
-                {
-                    /* Merge blocks */
-                    memory_remove_free_block(next_block);
-                    block->size += next_block->size;
-                    continue; /* Check again without advancing */
-                }
-            }
+            pool->is_active = false;
+            return POOL_INVALID_ID;
         }
-        
-        current += block->size;
     }
-}
-
-/**
- * @brief Insert block into free list
- */
-static void memory_insert_free_block(memory_block_t* block)
-{
-    block->next = free_list;
-    block->prev = NULL;
     
-    if(free_list != NULL)
+    pool->region = (uint8_t*)region;
+    pool->block_size = aligned_size;
+    pool->block_count = block_count;
+    pool->free_blocks = block_count;
+    pool->min_free_blocks = block_count;
+    pool->allocation_count = 0;
+    pool->free_count = 0;
+    pool->failed_allocations = 0;
+    
+    /* Thread every block onto the free stack, lowest address on top */
+    pool->free_stack = NULL;
+    for(uint32_t i = block_count; i > 0; i--)
     {
-        free_list->prev = block;
+        void** block = (void**)(pool->region + (i - 1) * aligned_size);
+        *block = pool->free_stack;
+        pool->free_stack = block;
     }
     
-    free_list = block;
+    DEBUG_PRINT("Memory pool %d created (%u x %u bytes)\n", pool_id, block_count, aligned_size);
+    
+    return pool_id;
 }
 
 /**
- * @brief Remove block from free list
+ * @brief Delete a pool
  */
-static void memory_remove_free_block(memory_block_t* block)
+rtos_result_t pool_delete(uint8_t pool_id)
 {
-    if(block->prev != NULL)
+    if(!memory_initialized || pool_id >= MAX_MEMORY_POOLS)
     {
-        block->prev->next = block->next;
+        return RTOS_INVALID_PARAM;
+    }
+    
+    memory_pool_t* pool = &pools[pool_id];
+    
+    if(!pool->is_active)
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    pool->free_stack = NULL;
+    pool->free_blocks = 0;
+    
+    EXIT_CRITICAL();
+    
+    if(pool->owns_region)
+    {
+        memory_free(pool->region);
+    }
+    
+    pool->region = NULL;
+    pool->is_active = false;
+    
+    DEBUG_PRINT("Memory pool %d deleted\n", pool_id);
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Allocate one block from a pool
+ */
+void* pool_alloc(uint8_t pool_id)
+{
+    if(pool_id >= MAX_MEMORY_POOLS || !pools[pool_id].is_active)
+    {
+        return NULL;
+    }
+    
+    memory_pool_t* pool = &pools[pool_id];
+    
+    ENTER_CRITICAL();
+    
+    void** block = (void**)pool->free_stack;
+    
+    if(block == NULL)
+    {
+        pool->failed_allocations++;
+        EXIT_CRITICAL();
+        return NULL;
+    }
+    
+    /* Pop the top of the free stack */
+    pool->free_stack = *block;
+    pool->free_blocks--;
+    pool->allocation_count++;
+    
+    if(pool->free_blocks < pool->min_free_blocks)
+    {
+        pool->min_free_blocks = pool->free_blocks;
+    }
+    
+    EXIT_CRITICAL();
+    
+    return (void*)block;
+}
+
+/**
+ * @brief Return a block to its pool
+ */
+rtos_result_t pool_free(uint8_t pool_id, void* block)
+{
+    if(pool_id >= MAX_MEMORY_POOLS || block == NULL)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    memory_pool_t* pool = &pools[pool_id];
+    
+    if(!pool->is_active)
+    {
+        return RTOS_ERROR;
+    }
+    
+    /* Must be the start of a block inside this pool */
+    uint8_t* addr = (uint8_t*)block;
+    if(addr < pool->region ||
+       addr >= pool->region + pool->block_size * pool->block_count ||
+       ((uint32_t)(addr - pool->region) % pool->block_size) != 0)
+    {
+        DEBUG_PRINT("Block %p does not belong to pool %d\n", block, pool_id);
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    if(pool->free_blocks >= pool->block_count)
+    {
+        EXIT_CRITICAL();
+        DEBUG_PRINT("Pool %d double free detected\n", pool_id);
+        return RTOS_ERROR;
+    }
+    
+    /* Push onto the free stack */
+    *(void**)block = pool->free_stack;
+    pool->free_stack = block;
+    pool->free_blocks++;
+    pool->free_count++;
+    
+    EXIT_CRITICAL();
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Get pool statistics
+ */
+rtos_result_t pool_get_stats(uint8_t pool_id, memory_pool_stats_t* stats_out)
+{
+    if(pool_id >= MAX_MEMORY_POOLS || stats_out == NULL)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    memory_pool_t* pool = &pools[pool_id];
+    
+    if(!pool->is_active)
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    stats_out->block_size = pool->block_size;
+    stats_out->block_count = pool->block_count;
+    stats_out->free_blocks = pool->free_blocks;
+    stats_out->min_free_blocks = pool->min_free_blocks;
+    stats_out->allocation_count = pool->allocation_count;
+    stats_out->free_count = pool->free_count;
+    stats_out->failed_allocations = pool->failed_allocations;
+    
+    EXIT_CRITICAL();
+    
+    return RTOS_SUCCESS;
+}
+
+/* ============================================================================
+ * OBJECT HANDLE TABLE FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Create a table of fixed-size objects addressed by handles
+ */
+rtos_result_t object_table_create(object_table_t* table, uint32_t object_size, uint32_t capacity)
+{
+    if(table == NULL || object_size == 0 || capacity == 0 || capacity > OBJECT_TABLE_MAX_CAPACITY)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    uint16_t* generations = (uint16_t*)memory_alloc(capacity * sizeof(uint16_t));
+    if(generations == NULL)
+    {
+        return RTOS_ERROR;
+    }
+    
+    rtos_result_t result = object_table_setup(table, NULL, generations, object_size, capacity);
+    if(result != RTOS_SUCCESS)
+    {
+        memory_free(generations);
+        return result;
+    }
+    
+    table->owns_generations = true;
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Create an object table on caller-provided storage
+ */
+rtos_result_t object_table_create_static(object_table_t* table, void* storage, uint16_t* generations,
+                                         uint32_t object_size, uint32_t capacity)
+{
+    if(table == NULL || storage == NULL || generations == NULL ||
+       object_size == 0 || capacity == 0 || capacity > OBJECT_TABLE_MAX_CAPACITY)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    rtos_result_t result = object_table_setup(table, storage, generations, object_size, capacity);
+    if(result == RTOS_SUCCESS)
+    {
+        table->owns_generations = false;
+    }
+    
+    return result;
+}
+
+/**
+ * @brief Delete an object table and release its storage
+ */
+rtos_result_t object_table_delete(object_table_t* table)
+{
+    if(table == NULL || table->generations == NULL)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    pool_delete(table->pool_id);
+    
+    if(table->owns_generations)
+    {
+        memory_free(table->generations);
+    }
+    
+    table->pool_id = POOL_INVALID_ID;
+    table->generations = NULL;
+    table->capacity = 0;
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Allocate an object
+ */
+void* object_alloc(object_table_t* table, object_handle_t* handle)
+{
+    if(table == NULL || table->generations == NULL || handle == NULL)
+    {
+        return NULL;
+    }
+    
+    uint8_t* object = (uint8_t*)pool_alloc(table->pool_id);
+    if(object == NULL)
+    {
+        return NULL;
+    }
+    
+    memory_pool_t* pool = &pools[table->pool_id];
+    uint32_t index = (uint32_t)(object - pool->region) / pool->block_size;
+    
+    ENTER_CRITICAL();
+    
+    /* Odd generation: slot live */
+    uint16_t generation = ++table->generations[index];
+    
+    EXIT_CRITICAL();
+    
+    *handle = ((object_handle_t)generation << OBJECT_HANDLE_INDEX_BITS) | index;
+    
+    return object;
+}
+
+/**
+ * @brief Free an object
+ */
+rtos_result_t object_free(object_table_t* table, object_handle_t handle)
+{
+    void* object = object_get(table, handle);
+    
+    if(object == NULL)
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    /* Re-check under the lock so two frees of one handle cannot both win */
+    uint32_t index = handle & OBJECT_HANDLE_INDEX_MASK;
+    if(table->generations[index] != (uint16_t)(handle >> OBJECT_HANDLE_INDEX_BITS))
+    {
+        EXIT_CRITICAL();
+        return RTOS_ERROR;
+    }
+    
+    table->generations[index]++;
+    
+    EXIT_CRITICAL();
+    
+    return pool_free(table->pool_id, object);
+}
+
+/**
+ * @brief Resolve a handle to its object
+ */
+void* object_get(const object_table_t* table, object_handle_t handle)
+{
+    if(table == NULL || table->generations == NULL)
+    {
+        return NULL;
+    }
+    
+    uint32_t index = handle & OBJECT_HANDLE_INDEX_MASK;
+    uint16_t generation = (uint16_t)(handle >> OBJECT_HANDLE_INDEX_BITS);
+    
+    if(index >= table->capacity || (generation & 1) == 0 ||
+       table->generations[index] != generation)
+    {
+        return NULL;
+    }
+    
+    memory_pool_t* pool = &pools[table->pool_id];
+    
+    return pool->region + index * pool->block_size;
+}
+
+/**
+ * @brief Resolve a slot index to its object
+ */
+void* object_get_index(const object_table_t* table, uint32_t index)
+{
+    if(table == NULL || table->generations == NULL || index >= table->capacity ||
+       (table->generations[index] & 1) == 0)
+    {
+        return NULL;
+    }
+    
+    memory_pool_t* pool = &pools[table->pool_id];
+    
+    return pool->region + index * pool->block_size;
+}
+
+/* ============================================================================
+ * PRIVATE FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Set up a region as one free block covering all of it
+ */
+static void memory_region_setup(memory_region_t* region, uint8_t* start, uint32_t size, uint32_t attrs)
+{
+    uint8_t region_id = region->region_id;
+    
+    memset(region, 0, sizeof(memory_region_t));
+    region->region_id = region_id;
+    region->attrs = attrs;
+    region->start = start;
+    region->size = size;
+    
+    /* Initialize first free block covering the entire region */
+    memory_block_t* first_block = (memory_block_t*)start;
+    first_block->magic = MEMORY_MAGIC_FREE;
+    first_block->size = size;
+    first_block->next = NULL;
+    first_block->prev = NULL;
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+    first_block->prev_phys = NULL;
+#endif
+    
+    memory_insert_free_block(region, first_block);
+    region->is_active = true;
+    
+    stats.total_heap_size += size;
+    stats.free_heap_size += size - sizeof(memory_block_t);
+    stats.min_free_heap_size += size - sizeof(memory_block_t);
+}
+
+/**
+ * @brief Find the region containing an address (NULL if none)
+ */
+static memory_region_t* memory_find_region(void* addr)
+{
+    uint8_t* byte = (uint8_t*)addr;
+    
+    for(int i = 0; i < MAX_MEMORY_REGIONS; i++)
+    {
+        memory_region_t* region = &regions[i];
+        
+        if(region->is_active && byte >= region->start && byte < region->start + region->size)
+        {
+            return region;
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief Allocate from preferred regions, then from any other region
+ * @note A region is preferred when (attrs & attr_mask) == attr_match
+ */
+static void* memory_alloc_placed(uint32_t size, uint32_t attr_mask, uint32_t attr_match)
+{
+    if(!memory_initialized || size == 0)
+    {
+        return NULL;
+    }
+    
+    uint32_t aligned_size = memory_request_size(size);
+    
+    ENTER_CRITICAL();
+    
+    memory_block_t* block = NULL;
+    for(int pass = 0; pass < 2 && block == NULL; pass++)
+    {
+        for(int i = 0; i < MAX_MEMORY_REGIONS && block == NULL; i++)
+        {
+            memory_region_t* region = &regions[i];
+            bool preferred = ((region->attrs & attr_mask) == attr_match);
+            
+            if(region->is_active && preferred == (pass == 0))
+            {
+                block = memory_region_take(region, aligned_size);
+            }
+        }
+    }
+    
+#if RTOS_USE_STATS
+    if(block == NULL)
+    {
+        stats.failed_allocations++;
+    }
+#endif
+    
+    EXIT_CRITICAL();
+    
+    if(block == NULL)
+    {
+        DEBUG_PRINT("Memory allocation failed for %u bytes\n", size);
+        return NULL;
+    }
+    
+    /* Return pointer to user data (skip header) */
+    return (void*)((uint8_t*)block + sizeof(memory_block_t));
+}
+
+/**
+ * @brief Take a block of size bytes (header included) from one region
+ * @return memory_block_t* The block, marked used, or NULL if nothing fits
+ * @note Called inside a critical section
+ */
+static memory_block_t* memory_region_take(memory_region_t* region, uint32_t size)
+{
+    /* Find suitable free block */
+    memory_block_t* block = memory_find_free_block(region, size);
+    
+    if(block == NULL)
+    {
+        return NULL;
+    }
+    
+    /* Remove block from free list */
+    memory_remove_free_block(region, block);
+    
+    /* Split block if too large */
+    if(block->size >= size + MIN_BLOCK_SIZE)
+    {
+        memory_split_block(region, block, size);
+    }
+    
+    /* Mark block as used */
+    block->magic = MEMORY_MAGIC_USED;
+    
+    /* Update statistics */
+    region->used_size += block->size;
+    stats.used_heap_size += block->size;
+    stats.free_heap_size -= block->size;
+    
+#if RTOS_USE_STATS
+    stats.allocation_count++;
+    
+    if(stats.used_heap_size > stats.max_used_heap_size)
+    {
+        stats.max_used_heap_size = stats.used_heap_size;
+    }
+    
+    if(stats.free_heap_size < stats.min_free_heap_size)
+    {
+        stats.min_free_heap_size = stats.free_heap_size;
+    }
+#endif
+    
+    return block;
+}
+
+/**
+ * @brief Block size needed for a request: header added, aligned, floored
+ */
+static uint32_t memory_request_size(uint32_t size)
+{
+    uint32_t aligned_size = memory_align_size(size + sizeof(memory_block_t));
+    
+    return (aligned_size < MIN_BLOCK_SIZE) ? MIN_BLOCK_SIZE : aligned_size;
+}
+
+/**
+ * @brief Find free block of sufficient size
+ */
+static memory_block_t* memory_find_free_block(memory_region_t* region, uint32_t size)
+{
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+    uint32_t fl;
+    uint32_t sl;
+    
+    /* Round up to the next list boundary so any block found is big enough */
+    if(size >= MEMORY_TLSF_SMALL_BLOCK)
+    {
+        size += (1UL << ((31 - __CLZ(size)) - MEMORY_TLSF_SL_LOG2)) - 1;
+    }
+    
+    memory_tlsf_mapping(size, &fl, &sl);
+    
+    if(fl >= MEMORY_TLSF_FL_COUNT)
+    {
+        return NULL;
+    }
+    
+    /* Same first-level class, same or larger second-level list */
+    uint32_t sl_map = region->tlsf_sl_bitmap[fl] & (~0UL << sl);
+    
+    if(sl_map == 0)
+    {
+        /* Fall back to the smallest larger first-level class */
+        uint32_t fl_map = region->tlsf_fl_bitmap & (~0UL << (fl + 1));
+        
+        if(fl_map == 0)
+        {
+            return NULL; /* No suitable block found */
+        }
+        
+        fl = 31 - __CLZ(fl_map & (0 - fl_map));
+        sl_map = region->tlsf_sl_bitmap[fl];
+    }
+    
+    sl = 31 - __CLZ(sl_map & (0 - sl_map));
+    
+    return region->tlsf_free_lists[fl][sl];
+#else
+    memory_block_t* current = region->free_list;
+    
+    /* First-fit algorithm */
+    while(current != NULL)
+    {
+        if(current->size >= size)
+        {
+            return current;
+        }
+        current = current->next;
+    }
+    
+    return NULL; /* No suitable block found */
+#endif
+}
+
+/**
+ * @brief Split block into allocated and free parts
+ */
+static void memory_split_block(memory_region_t* region, memory_block_t* block, uint32_t size)
+{
+    if(block->size <= size + sizeof(memory_block_t))
+    {
+        return; /* Block too small to split */
+    }
+    
+    /* Create new free block */
+    memory_block_t* new_block = (memory_block_t*)((uint8_t*)block + size);
+    new_block->magic = MEMORY_MAGIC_FREE;
+    new_block->size = block->size - size;
+    new_block->next = NULL;
+    new_block->prev = NULL;
+    
+    /* Update original block size */
+    block->size = size;
+    
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+    /* Fix up boundary tags on both sides of the new block */
+    new_block->prev_phys = block;
+    
+    memory_block_t* after = memory_next_phys(region, new_block);
+    if(after != NULL)
+    {
+        after->prev_phys = new_block;
+    }
+#endif
+    
+    /* Add new block to free list */
+    memory_insert_free_block(region, new_block);
+}
+
+/**
+ * @brief Get the physically following block (NULL at the end of the region)
+ */
+static memory_block_t* memory_next_phys(const memory_region_t* region, memory_block_t* block)
+{
+    uint8_t* next_addr = (uint8_t*)block + block->size;
+    
+    return (next_addr < region->start + region->size) ? (memory_block_t*)next_addr : NULL;
+}
+
+/**
+ * @brief Resize a used block in place using its physical successor
+ * @return bool True if the block now holds size bytes, false if it must move
+ */
+static bool memory_resize_block(memory_region_t* region, memory_block_t* block, uint32_t size)
+{
+    uint32_t old_size = block->size;
+    memory_block_t* next_block = memory_next_phys(region, block);
+    
+    if(next_block != NULL && next_block->magic != MEMORY_MAGIC_FREE)
+    {
+        next_block = NULL;
+    }
+    
+    if(size > old_size && (next_block == NULL || old_size + next_block->size < size))
+    {
+        return false; /* Not enough room without moving */
+    }
+    
+    /* Absorb a free successor; any excess is split back off below */
+    if(next_block != NULL)
+    {
+        memory_remove_free_block(region, next_block);
+        block->size += next_block->size;
+        
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+        memory_block_t* after = memory_next_phys(region, block);
+        if(after != NULL)
+        {
+            after->prev_phys = block;
+        }
+#endif
+    }
+    
+    if(block->size >= size + MIN_BLOCK_SIZE)
+    {
+        memory_split_block(region, block, size);
+    }
+    
+    /* Update statistics by the change in footprint */
+    region->used_size += block->size;
+    region->used_size -= old_size;
+    
+    if(block->size >= old_size)
+    {
+        stats.used_heap_size += block->size - old_size;
+        stats.free_heap_size -= block->size - old_size;
+        
+#if RTOS_USE_STATS
+        if(stats.used_heap_size > stats.max_used_heap_size)
+        {
+            stats.max_used_heap_size = stats.used_heap_size;
+        }
+        
+        if(stats.free_heap_size < stats.min_free_heap_size)
+        {
+            stats.min_free_heap_size = stats.free_heap_size;
+        }
+#endif
+    }
+    else
+    {
+        stats.used_heap_size -= old_size - block->size;
+        stats.free_heap_size += old_size - block->size;
+    }
+    
+    return true;
+}
+
+#if MEMORY_ALLOCATOR != MEMORY_ALLOCATOR_TLSF
+/**
+ * @brief Coalesce adjacent free blocks
+ */
+static void memory_coalesce_blocks(memory_region_t* region)
+{
+    /* Simple coalescing: walk through the region and merge adjacent free blocks */
+    uint8_t* current = region->start;
+    uint8_t* end = region->start + region->size;
+    
+    while(current < end)
+    {
+        memory_block_t* block = (memory_block_t*)current;
+        
+        if(block->magic == MEMORY_MAGIC_FREE)
+        {
+            /* Check if next block is also free */
+            uint8_t* next_addr = current + block->size;
+            
+            if(next_addr < end)
+            {
+                memory_block_t* next_block = (memory_block_t*)next_addr;
+                
+                if(next_block->magic == MEMORY_MAGIC_FREE)
+                {
+                    /* Merge blocks; block stays listed, so re-file its size class */
+                    memory_remove_free_block(region, next_block);
+                    memory_ff_class_remove(region, block->size);
+                    block->size += next_block->size;
+                    memory_ff_class_add(region, block->size);
+                    continue; /* Check again without advancing */
+                }
+            }
+        }
+        
+        current += block->size;
+    }
+}
+#endif
+
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+/**
+ * @brief Map a block size to its first/second level list indices
+ */
+static void memory_tlsf_mapping(uint32_t size, uint32_t* fl, uint32_t* sl)
+{
+    if(size < MEMORY_TLSF_SMALL_BLOCK)
+    {
+        /* Small sizes share first-level class 0, split linearly */
+        *fl = 0;
+        *sl = size / (MEMORY_TLSF_SMALL_BLOCK / MEMORY_TLSF_SL_COUNT);
+    }
+    else
+    {
+        uint32_t msb = 31 - __CLZ(size);
+        *sl = (size >> (msb - MEMORY_TLSF_SL_LOG2)) ^ MEMORY_TLSF_SL_COUNT;
+        *fl = msb - (MEMORY_TLSF_FL_SHIFT - 1);
+    }
+}
+
+/**
+ * @brief Merge a block being freed with its free physical neighbours
+ * @return memory_block_t* The merged block (not yet in any free list)
+ */
+static memory_block_t* memory_merge_block(memory_region_t* region, memory_block_t* block)
+{
+    memory_block_t* prev_block = block->prev_phys;
+    
+    if(prev_block != NULL && prev_block->magic == MEMORY_MAGIC_FREE)
+    {
+        memory_remove_free_block(region, prev_block);
+        prev_block->size += block->size;
+        block = prev_block;
+    }
+    
+    memory_block_t* next_block = memory_next_phys(region, block);
+    
+    if(next_block != NULL && next_block->magic == MEMORY_MAGIC_FREE)
+    {
+        memory_remove_free_block(region, next_block);
+        block->size += next_block->size;
+    }
+    
+    /* Block after the merged range now points back at it */
+    next_block = memory_next_phys(region, block);
+    if(next_block != NULL)
+    {
+        next_block->prev_phys = block;
+    }
+    
+    return block;
+}
+#endif
+
+/**
+ * @brief Insert block into free list
+ */
+static void memory_insert_free_block(memory_region_t* region, memory_block_t* block)
+{
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+    uint32_t fl;
+    uint32_t sl;
+    
+    memory_tlsf_mapping(block->size, &fl, &sl);
+    
+    memory_block_t** head = &region->tlsf_free_lists[fl][sl];
+    
+    block->next = *head;
+    block->prev = NULL;
+    
+    if(*head != NULL)
+    {
+        (*head)->prev = block;
+    }
+    
+    *head = block;
+    
+    region->tlsf_fl_bitmap |= (1UL << fl);
+    region->tlsf_sl_bitmap[fl] |= (1UL << sl);
+#else
+    memory_ff_class_add(region, block->size);
+    
+    block->next = region->free_list;
+    block->prev = NULL;
+    
+    if(region->free_list != NULL)
+    {
+        region->free_list->prev = block;
+    }
+    
+    region->free_list = block;
+#endif
+    
+    stats.free_blocks_count++;
+}
+
+/**
+ * @brief Remove block from free list
+ */
+static void memory_remove_free_block(memory_region_t* region, memory_block_t* block)
+{
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+    uint32_t fl;
+    uint32_t sl;
+    
+    memory_tlsf_mapping(block->size, &fl, &sl);
+    
+    if(block->prev != NULL)
+    {
+        block->prev->next = block->next;
     }
     else
     {
-        free_list = block->next;
+        region->tlsf_free_lists[fl][sl] = block->next;
+        
+        /* Keep the bitmaps in step with empty lists */
+        if(block->next == NULL)
+        {
+            region->tlsf_sl_bitmap[fl] &= ~(1UL << sl);
+            
+            if(region->tlsf_sl_bitmap[fl] == 0)
+            {
+                region->tlsf_fl_bitmap &= ~(1UL << fl);
+            }
+        }
+    }
+    
+#else
+    memory_ff_class_remove(region, block->size);
+    
+    if(block->prev != NULL)
+    {
+        block->prev->next = block->next;
     }
+    else
+    {
+        region->free_list = block->next;
+    }
+#endif
     
     if(block->next != NULL)
     {
@@ -611,6 +1649,8 @@ static void memory_remove_free_block(memory_block_t* block)
     
     block->next = NULL;
     block->prev = NULL;
+    
+    stats.free_blocks_count--;
 }
 
 /**
@@ -622,24 +1662,110 @@ static uint32_t memory_align_size(uint32_t size)
 }
 
 /**
- * @brief Update memory statistics
+ * @brief Refresh the derived statistics from the size-class bitmaps
+ * @note O(MAX_MEMORY_REGIONS): the highest non-empty class of each region
+ *       bounds its largest free block from below
  */
 static void memory_update_stats(void)
 {
-    /* Count free blocks and find largest */
-    stats.free_blocks_count = 0;
     stats.largest_free_block = 0;
     
-    memory_block_t* current = free_list;
-    while(current != NULL)
+    for(int i = 0; i < MAX_MEMORY_REGIONS; i++)
     {
-        stats.free_blocks_count++;
-        
-        if(current->size > stats.largest_free_block)
+        if(regions[i].is_active)
         {
-            stats.largest_free_block = current->size - sizeof(memory_block_t);
+            uint32_t largest = memory_region_largest(&regions[i]);
+            
+            if(largest > stats.largest_free_block)
+            {
+                stats.largest_free_block = largest;
+            }
         }
+    }
+    
+    stats.fragmentation_index = (stats.free_heap_size > 0) ?
+                                100 - (stats.largest_free_block * 100 / stats.free_heap_size) : 0;
+}
+
+/**
+ * @brief Largest allocation a region is guaranteed to serve
+ * @note O(1): any request up to the lower bound of the highest non-empty
+ *       size class is guaranteed to be served
+ */
+static uint32_t memory_region_largest(const memory_region_t* region)
+{
+    uint32_t class_size = 0;
+    
+#if MEMORY_ALLOCATOR == MEMORY_ALLOCATOR_TLSF
+    if(region->tlsf_fl_bitmap != 0)
+    {
+        uint32_t fl = 31 - __CLZ(region->tlsf_fl_bitmap);
+        uint32_t sl = 31 - __CLZ(region->tlsf_sl_bitmap[fl]);
         
-        current = current->next;
+        /* Smallest size memory_tlsf_mapping() files under (fl, sl) */
+        if(fl == 0)
+        {
+            class_size = sl * (MEMORY_TLSF_SMALL_BLOCK / MEMORY_TLSF_SL_COUNT);
+        }
+        else
+        {
+            class_size = (MEMORY_TLSF_SL_COUNT + sl) << (fl + MEMORY_TLSF_FL_SHIFT - 1 - MEMORY_TLSF_SL_LOG2);
+        }
+    }
+#else
+    if(region->ff_class_bitmap != 0)
+    {
+        class_size = 1UL << (31 - __CLZ(region->ff_class_bitmap));
+    }
+#endif
+    
+    return (class_size > sizeof(memory_block_t)) ? class_size - sizeof(memory_block_t) : 0;
+}
+
+#if MEMORY_ALLOCATOR != MEMORY_ALLOCATOR_TLSF
+/**
+ * @brief Count a block into its first-fit size class
+ */
+static void memory_ff_class_add(memory_region_t* region, uint32_t size)
+{
+    uint32_t size_class = 31 - __CLZ(size);
+    
+    region->ff_class_counts[size_class]++;
+    region->ff_class_bitmap |= (1UL << size_class);
+}
+
+/**
+ * @brief Count a block out of its first-fit size class
+ */
+static void memory_ff_class_remove(memory_region_t* region, uint32_t size)
+{
+    uint32_t size_class = 31 - __CLZ(size);
+    
+    if(--region->ff_class_counts[size_class] == 0)
+    {
+        region->ff_class_bitmap &= ~(1UL << size_class);
+    }
+}
+#endif
+
+/**
+ * @brief Back a table with a pool over the given storage (NULL: heap) and clear its generations
+ */
+static rtos_result_t object_table_setup(object_table_t* table, void* storage, uint16_t* generations,
+                                        uint32_t object_size, uint32_t capacity)
+{
+    /* The pool's free stack doubles as the free-index stack */
+    table->pool_id = pool_create(storage, object_size, capacity);
+    if(table->pool_id == POOL_INVALID_ID)
+    {
+        table->generations = NULL;
+        return RTOS_ERROR;
     }
-}
\ No newline at end of file
+    
+    /* Even generation: slot free */
+    memset(generations, 0, capacity * sizeof(uint16_t));
+    table->generations = generations;
+    table->capacity = capacity;
+    
+    return RTOS_SUCCESS;
+}
@@ -11,23 +11,68 @@
 #include "queue_manager.h"
 #include "memory_manager.h"
 #include "task_manager.h"
+#include "scheduler.h"
+#include "timer_manager.h"
+#include "arm_cortex_m.h"
+#include "rtos_trace.h"
 
 /* ============================================================================
  * GLOBAL VARIABLES
  * ============================================================================ */
 static queue_t queues[MAX_QUEUES];              /* Queue array */
+#if RTOS_USE_SEMAPHORES
 static semaphore_t semaphores[MAX_SEMAPHORES];  /* Semaphore array */
+#endif
+static mutex_t mutexes[MAX_MUTEXES];            /* Mutex array */
+static spsc_ring_t spsc_rings[MAX_SPSC_RINGS];  /* SPSC ring array */
+static event_group_t event_groups[MAX_EVENT_GROUPS]; /* Event group array */
+static queue_set_t queue_sets[MAX_QUEUE_SETS];  /* Queue set array */
+static object_table_t queue_table;              /* Handle-based queues */
+#if RTOS_USE_SEMAPHORES
+static object_table_t semaphore_table;          /* Handle-based semaphores */
+#endif
+
+/* Condition a task waits for in event_group_wait() (lives on its stack) */
+typedef struct {
+    uint32_t bits;                              /* Requested bits */
+    uint8_t options;                            /* EVENT_WAIT_ALL / EVENT_CLEAR_ON_EXIT */
+    uint32_t matched_bits;                      /* Group bits when the wait was satisfied */
+} event_wait_t;
 static bool queue_manager_initialized = false;
 
 /* ============================================================================
  * PRIVATE FUNCTION PROTOTYPES
  * ============================================================================ */
-static void queue_add_waiting_task(uint8_t queue_id, uint8_t task_id, bool is_sender);
-static void queue_remove_waiting_task(uint8_t queue_id, uint8_t task_id, bool is_sender);
-static void queue_wake_waiting_task(uint8_t queue_id, bool is_sender);
-static void semaphore_add_waiting_task(uint8_t semaphore_id, uint8_t task_id);
-static void semaphore_remove_waiting_task(uint8_t semaphore_id, uint8_t task_id);
-static void semaphore_wake_waiting_task(uint8_t semaphore_id);
+static bool queue_wake_waiting_task(queue_t* queue, bool is_sender);
+static bool queue_service_waiters(queue_t* queue);
+static queue_result_t queue_init_object(queue_t* queue, uint32_t size, uint32_t item_size, void* buffer);
+static void queue_destroy(queue_t* queue);
+static queue_result_t queue_send_to(queue_t* queue, const void* data, uint32_t timeout_ms);
+static queue_result_t queue_receive_from(queue_t* queue, void* data, uint32_t timeout_ms);
+#if RTOS_USE_SEMAPHORES
+static bool semaphore_wake_waiting_task(semaphore_t* sem);
+static void semaphore_init_object(semaphore_t* sem, uint8_t initial_count, uint8_t max_count);
+static void semaphore_destroy(semaphore_t* sem);
+static rtos_result_t semaphore_take_from(semaphore_t* sem, uint32_t timeout_ms);
+static rtos_result_t semaphore_give_to(semaphore_t* sem);
+#endif
+static void mutex_remove_held(tcb_t* owner, mutex_t* mutex);
+static void mutex_hand_over(mutex_t* mutex);
+static void mutex_update_priority(tcb_t* tcb);
+static bool event_group_matches(uint32_t group_bits, uint32_t bits, uint8_t options);
+static bool event_group_wake_waiters(event_group_t* group);
+static uint8_t* queue_set_member_link(uint8_t member);
+static bool queue_set_member_ready(uint8_t member);
+static bool queue_set_notify(uint8_t set_id, uint8_t member);
+static void wait_list_cancel(task_wait_list_t* wait_list);
+static bool wait_can_block(uint32_t timeout_ms);
+static uint32_t wait_timeout_ticks(uint32_t timeout_ms);
+static uint8_t* queue_slot(const queue_t* queue, uint32_t index);
+static void queue_copy_in(queue_t* queue, const uint8_t* items, uint32_t count);
+static void queue_copy_out(queue_t* queue, uint8_t* items, uint32_t count);
+static queue_result_t spsc_push(spsc_ring_t* ring, const void* data, bool* task_woken);
+static queue_result_t spsc_pop(spsc_ring_t* ring, void* data);
+static queue_result_t spsc_init_ring(uint8_t ring_id, uint32_t size, uint32_t item_size, void* buffer);
 
 /* ============================================================================
  * PUBLIC FUNCTIONS - QUEUE MANAGER
@@ -44,14 +89,21 @@ rtos_result_t queue_manager_init(void)
         queues[i].queue_id = i;
         queues[i].buffer = NULL;
         queues[i].size = 0;
+        queues[i].item_size = 0;
+        queues[i].slot_size = 0;
         queues[i].head = 0;
         queues[i].tail = 0;
         queues[i].count = 0;
         queues[i].is_active = false;
-        queues[i].send_waiting_count = 0;
-        queues[i].receive_waiting_count = 0;
+        queues[i].owns_buffer = false;
+        queues[i].send_reserved = false;
+        queues[i].receive_borrowed = false;
+        queues[i].set_id = QUEUE_SET_INVALID_ID;
+        task_wait_list_init(&queues[i].send_waiters);
+        task_wait_list_init(&queues[i].receive_waiters);
     }
     
+#if RTOS_USE_SEMAPHORES
     /* Initialize semaphores */
     for(int i = 0; i < MAX_SEMAPHORES; i++)
     {
@@ -59,7 +111,51 @@ rtos_result_t queue_manager_init(void)
         semaphores[i].count = 0;
         semaphores[i].max_count = 0;
         semaphores[i].is_active = false;
-        semaphores[i].waiting_count = 0;
+        semaphores[i].set_id = QUEUE_SET_INVALID_ID;
+        task_wait_list_init(&semaphores[i].waiters);
+    }
+#endif
+    
+    /* Initialize SPSC rings */
+    for(int i = 0; i < MAX_SPSC_RINGS; i++)
+    {
+        spsc_rings[i].ring_id = i;
+        spsc_rings[i].buffer = NULL;
+        spsc_rings[i].item_size = 0;
+        spsc_rings[i].mask = 0;
+        spsc_rings[i].head = 0;
+        spsc_rings[i].tail = 0;
+        spsc_rings[i].waiting_task = NULL;
+        spsc_rings[i].is_active = false;
+        spsc_rings[i].owns_buffer = false;
+    }
+    
+    /* Initialize event groups */
+    for(int i = 0; i < MAX_EVENT_GROUPS; i++)
+    {
+        event_groups[i].group_id = i;
+        event_groups[i].is_active = false;
+        event_groups[i].bits = 0;
+        task_wait_list_init(&event_groups[i].waiters);
+    }
+    
+    /* Initialize queue sets */
+    for(int i = 0; i < MAX_QUEUE_SETS; i++)
+    {
+        queue_sets[i].set_id = i;
+        queue_sets[i].is_active = false;
+        task_wait_list_init(&queue_sets[i].waiters);
+    }
+    
+    /* Initialize mutexes */
+    for(int i = 0; i < MAX_MUTEXES; i++)
+    {
+        mutexes[i].mutex_id = i;
+        mutexes[i].is_active = false;
+        mutexes[i].owner = NULL;
+        mutexes[i].lock_count = 0;
+        mutexes[i].next_held = NULL;
+        task_wait_list_init(&mutexes[i].waiters);
     }
     
     queue_manager_initialized = true;
@@ -77,76 +173,80 @@ rtos_result_t queue_manager_init(void)
  */
 queue_result_t queue_create(uint8_t queue_id, uint32_t size)
 {
-    if(!queue_manager_initialized || queue_id >= MAX_QUEUES || size == 0 || size > MAX_QUEUE_SIZE)
+    return queue_create_sized(queue_id, size, QUEUE_ITEM_SIZE);
+}
+
+/**
+ * @brief Create a message queue with a custom item size
+ */
+queue_result_t queue_create_sized(uint8_t queue_id, uint32_t size, uint32_t item_size)
+{
+    if(!queue_manager_initialized || queue_id >= MAX_QUEUES)
     {
         return QUEUE_ERROR;
     }
     
-    queue_t* queue = &queues[queue_id];
-    
-    if(queue->is_active)
+    if(queues[queue_id].is_active)
     {
         return QUEUE_ERROR; /* Queue already exists */
     }
     
-    /* Allocate buffer */
-    queue->buffer = (uint32_t*)memory_alloc(size * QUEUE_ITEM_SIZE);
-    if(queue->buffer == NULL)
+    queue_result_t result = queue_init_object(&queues[queue_id], size, item_size, NULL);
+    
+    if(result == QUEUE_SUCCESS)
     {
-        return QUEUE_ERROR;
+        DEBUG_PRINT("Queue %d created with size %u (%u byte items)\n", queue_id, size, item_size);
     }
     
-    /* Initialize queue */
-    queue->size = size;
-    queue->head = 0;
-    queue->tail = 0;
-    queue->count = 0;
-    queue->is_active = true;
-    queue->send_waiting_count = 0;
-    queue->receive_waiting_count = 0;
-    
-    DEBUG_PRINT("Queue %d created with size %u\n", queue_id, size);
-    
-    return QUEUE_SUCCESS;
+    return result;
 }
 
 /**
- * @brief Delete a message queue
+ * @brief Create a message queue on caller-provided storage
  */
-queue_result_t queue_delete(uint8_t queue_id)
+queue_result_t queue_create_static(uint8_t queue_id, uint32_t size, uint32_t item_size, void* buffer)
 {
-    if(!queue_manager_initialized || queue_id >= MAX_QUEUES)
+    if(!queue_manager_initialized || queue_id >= MAX_QUEUES || buffer == NULL)
     {
         return QUEUE_ERROR;
     }
     
-    queue_t* queue = &queues[queue_id];
+    if(((uintptr_t)buffer & (QUEUE_SLOT_ALIGNMENT - 1)) != 0)
+    {
+        return QUEUE_ERROR; /* Slots must stay aligned for in-place use */
+    }
     
-    if(!queue->is_active)
+    if(queues[queue_id].is_active)
     {
-        return QUEUE_ERROR;
+        return QUEUE_ERROR; /* Queue already exists */
     }
     
-    /* Free buffer */
-    if(queue->buffer != NULL)
+    queue_result_t result = queue_init_object(&queues[queue_id], size, item_size, buffer);
+    
+    if(result == QUEUE_SUCCESS)
     {
-        memory_free(queue->buffer);
-        queue->buffer = NULL;
+        DEBUG_PRINT("Queue %d created with size %u (%u byte items, static)\n", queue_id, size, item_size);
     }
     
-    /* Wake up all waiting tasks with error */
-    while(queue->send_waiting_count > 0)
+    return result;
+}
+
+/**
+ * @brief Delete a message queue
+ */
+queue_result_t queue_delete(uint8_t queue_id)
+{
+    if(!queue_manager_initialized || queue_id >= MAX_QUEUES)
     {
-        queue_wake_waiting_task(queue_id, true);
+        return QUEUE_ERROR;
     }
     
-    while(queue->receive_waiting_count > 0)
+    if(!queues[queue_id].is_active)
     {
-        queue_wake_waiting_task(queue_id, false);
+        return QUEUE_ERROR;
     }
     
-    /* Mark as inactive */
-    queue->is_active = false;
+    queue_destroy(&queues[queue_id]);
     
     DEBUG_PRINT("Queue %d deleted\n", queue_id);
     
@@ -158,125 +258,133 @@ queue_result_t queue_delete(uint8_t queue_id)
  */
 queue_result_t queue_send(uint8_t queue_id, const void* data, uint32_t timeout_ms)
 {
-    if(!queue_manager_initialized || queue_id >= MAX_QUEUES || data == NULL)
+    if(!queue_manager_initialized || queue_id >= MAX_QUEUES)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    return queue_send_to(&queues[queue_id], data, timeout_ms);
+}
+
+/**
+ * @brief Receive data from queue
+ */
+queue_result_t queue_receive(uint8_t queue_id, void* data, uint32_t timeout_ms)
+{
+    if(!queue_manager_initialized || queue_id >= MAX_QUEUES)
     {
         return QUEUE_ERROR;
     }
     
+    return queue_receive_from(&queues[queue_id], data, timeout_ms);
+}
+
+/**
+ * @brief Send up to count items to queue in one critical section
+ */
+uint32_t queue_send_batch(uint8_t queue_id, const void* items, uint32_t count, uint32_t timeout_ms)
+{
+    if(!queue_manager_initialized || queue_id >= MAX_QUEUES || items == NULL || count == 0)
+    {
+        return 0;
+    }
+    
     queue_t* queue = &queues[queue_id];
     
     if(!queue->is_active)
     {
-        return QUEUE_ERROR;
+        return 0;
     }
     
     ENTER_CRITICAL();
     
-    /* Check if queue is full */
-    if(queue->count >= queue->size)
+    /* A reserved slot blocks the tail just as for queue_send() */
+    uint32_t space = queue->send_reserved ? 0 : queue->size - queue->count;
+    
+    if(space == 0)
     {
         EXIT_CRITICAL();
         
-        if(timeout_ms == 0)
-        {
-            return QUEUE_FULL;
-        }
-        
-        /* Add current task to waiting list */
-        tcb_t* current_task = task_get_current();
-        if(current_task != NULL)
+        /* Full: block for the first item, then take whatever else fits */
+        if(queue_send_to(queue, items, timeout_ms) != QUEUE_SUCCESS)
         {
-            queue_add_waiting_task(queue_id, current_task->task_id, true);
-            task_set_state(current_task->task_id, TASK_STATE_BLOCKED);
-            
-            /* In real implementation, would set timeout and yield */
-            /* For simulation, return timeout */
-            if(timeout_ms != QUEUE_TIMEOUT_INFINITE)
-            {
-                return QUEUE_TIMEOUT;
-            }
+            return 0;
         }
         
-        return QUEUE_FULL;
+        return (count > 1) ? 1 + queue_send_batch(queue_id, (const uint8_t*)items + queue->item_size,
+                                                  count - 1, 0) : 1;
     }
     
-    /* Add data to queue */
-    queue->buffer[queue->tail] = *(uint32_t*)data;
-    queue->tail = (queue->tail + 1) % queue->size;
-    queue->count++;
+    uint32_t batch = (count < space) ? count : space;
+    
+    queue_copy_in(queue, (const uint8_t*)items, batch);
+    RTOS_TRACE(TRACE_EVENT_QUEUE_SEND, queue->queue_id);
+    
+    /* One pass hands items to every receiver the batch can satisfy */
+    bool woken = queue_service_waiters(queue);
     
     EXIT_CRITICAL();
     
-    /* Wake up waiting receiver */
-    if(queue->receive_waiting_count > 0)
+    if(woken)
     {
-        queue_wake_waiting_task(queue_id, false);
+        scheduler_switch_context();
     }
     
-    return QUEUE_SUCCESS;
+    return batch;
 }
 
 /**
- * @brief Receive data from queue
+ * @brief Receive up to count items from queue in one critical section
  */
-queue_result_t queue_receive(uint8_t queue_id, void* data, uint32_t timeout_ms)
+uint32_t queue_receive_batch(uint8_t queue_id, void* items, uint32_t count, uint32_t timeout_ms)
 {
-    if(!queue_manager_initialized || queue_id >= MAX_QUEUES || data == NULL)
+    if(!queue_manager_initialized || queue_id >= MAX_QUEUES || items == NULL || count == 0)
     {
-        return QUEUE_ERROR;
+        return 0;
     }
     
     queue_t* queue = &queues[queue_id];
     
     if(!queue->is_active)
     {
-        return QUEUE_ERROR;
+        return 0;
     }
     
     ENTER_CRITICAL();
     
-    /* Check if queue is empty */
-    if(queue->count == 0)
+    /* A borrowed slot blocks the head just as for queue_receive() */
+    uint32_t available = queue->receive_borrowed ? 0 : queue->count;
+    
+    if(available == 0)
     {
         EXIT_CRITICAL();
         
-        if(timeout_ms == 0)
-        {
-            return QUEUE_EMPTY;
-        }
-        
-        /* Add current task to waiting list */
-        tcb_t* current_task = task_get_current();
-        if(current_task != NULL)
+        /* Empty: block for the first item, then take whatever else is queued */
+        if(queue_receive_from(queue, items, timeout_ms) != QUEUE_SUCCESS)
         {
-            queue_add_waiting_task(queue_id, current_task->task_id, false);
-            task_set_state(current_task->task_id, TASK_STATE_BLOCKED);
-            
-            /* In real implementation, would set timeout and yield */
-            /* For simulation, return timeout */
-            if(timeout_ms != QUEUE_TIMEOUT_INFINITE)
-            {
-                return QUEUE_TIMEOUT;
-            }
+            return 0;
         }
         
-        return QUEUE_EMPTY;
+        return (count > 1) ? 1 + queue_receive_batch(queue_id, (uint8_t*)items + queue->item_size,
+                                                     count - 1, 0) : 1;
     }
     
-    /* Get data from queue */
-    *(uint32_t*)data = queue->buffer[queue->head];
-    queue->head = (queue->head + 1) % queue->size;
-    queue->count--;
+    uint32_t batch = (count < available) ? count : available;
+    
+    queue_copy_out(queue, (uint8_t*)items, batch);
+    RTOS_TRACE(TRACE_EVENT_QUEUE_RECEIVE, queue->queue_id);
+    
+    /* One pass lets blocked senders refill the freed slots */
+    bool woken = queue_service_waiters(queue);
     
     EXIT_CRITICAL();
     
-    /* Wake up waiting sender */
-    if(queue->send_waiting_count > 0)
+    if(woken)
     {
-        queue_wake_waiting_task(queue_id, true);
+        scheduler_switch_context();
     }
     
-    return QUEUE_SUCCESS;
+    return batch;
 }
 
 /**
@@ -297,9 +405,151 @@ queue_result_t queue_peek(uint8_t queue_id, void* data)
     }
     
     ENTER_CRITICAL();
-    *(uint32_t*)data = queue->buffer[queue->head];
+    memcpy(data, queue_slot(queue, queue->head), queue->item_size);
+    EXIT_CRITICAL();
+    
+    return QUEUE_SUCCESS;
+}
+
+/**
+ * @brief Reserve the next free slot for in-place filling
+ */
+queue_result_t queue_send_reserve(uint8_t queue_id, void** slot)
+{
+    if(!queue_manager_initialized || queue_id >= MAX_QUEUES || slot == NULL)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    queue_t* queue = &queues[queue_id];
+    
+    if(!queue->is_active)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    if(queue->count >= queue->size || queue->send_reserved)
+    {
+        EXIT_CRITICAL();
+        return QUEUE_FULL;
+    }
+    
+    /* Hand out the tail slot; it only becomes visible on commit */
+    queue->send_reserved = true;
+    *slot = queue_slot(queue, queue->tail);
+    
+    EXIT_CRITICAL();
+    
+    return QUEUE_SUCCESS;
+}
+
+/**
+ * @brief Publish the reserved slot
+ */
+queue_result_t queue_send_commit(uint8_t queue_id)
+{
+    if(!queue_manager_initialized || queue_id >= MAX_QUEUES)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    queue_t* queue = &queues[queue_id];
+    
+    ENTER_CRITICAL();
+    
+    if(!queue->is_active || !queue->send_reserved)
+    {
+        EXIT_CRITICAL();
+        return QUEUE_ERROR;
+    }
+    
+    queue->send_reserved = false;
+    queue->tail = (queue->tail + 1) % queue->size;
+    queue->count++;
+    
+    /* Hand the item to a waiting receiver */
+    bool woken = queue_service_waiters(queue);
+    
+    EXIT_CRITICAL();
+    
+    if(woken)
+    {
+        scheduler_switch_context();
+    }
+    
+    return QUEUE_SUCCESS;
+}
+
+/**
+ * @brief Borrow the oldest item in place
+ */
+queue_result_t queue_receive_borrow(uint8_t queue_id, void** slot)
+{
+    if(!queue_manager_initialized || queue_id >= MAX_QUEUES || slot == NULL)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    queue_t* queue = &queues[queue_id];
+    
+    if(!queue->is_active)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    if(queue->count == 0 || queue->receive_borrowed)
+    {
+        EXIT_CRITICAL();
+        return QUEUE_EMPTY;
+    }
+    
+    /* Head slot stays counted until release, so senders cannot reuse it */
+    queue->receive_borrowed = true;
+    *slot = queue_slot(queue, queue->head);
+    
+    EXIT_CRITICAL();
+    
+    return QUEUE_SUCCESS;
+}
+
+/**
+ * @brief Return the borrowed slot to the queue
+ */
+queue_result_t queue_receive_release(uint8_t queue_id)
+{
+    if(!queue_manager_initialized || queue_id >= MAX_QUEUES)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    queue_t* queue = &queues[queue_id];
+    
+    ENTER_CRITICAL();
+    
+    if(!queue->is_active || !queue->receive_borrowed)
+    {
+        EXIT_CRITICAL();
+        return QUEUE_ERROR;
+    }
+    
+    queue->receive_borrowed = false;
+    queue->head = (queue->head + 1) % queue->size;
+    queue->count--;
+    
+    /* Let a waiting sender fill the freed slot */
+    bool woken = queue_service_waiters(queue);
+    
     EXIT_CRITICAL();
     
+    if(woken)
+    {
+        scheduler_switch_context();
+    }
+    
     return QUEUE_SUCCESS;
 }
 
@@ -357,6 +607,7 @@ bool queue_is_empty(uint8_t queue_id)
     return (queues[queue_id].count == 0);
 }
 
+#if RTOS_USE_SEMAPHORES
 /* ============================================================================
  * SEMAPHORE FUNCTIONS
  * ============================================================================ */
@@ -379,11 +630,7 @@ rtos_result_t semaphore_create(uint8_t semaphore_id, uint8_t initial_count, uint
         return RTOS_ERROR; /* Semaphore already exists */
     }
     
-    /* Initialize semaphore */
-    sem->count = initial_count;
-    sem->max_count = max_count;
-    sem->is_active = true;
-    sem->waiting_count = 0;
+    semaphore_init_object(sem, initial_count, max_count);
     
     DEBUG_PRINT("Semaphore %d created (initial: %d, max: %d)\n", 
                semaphore_id, initial_count, max_count);
@@ -401,21 +648,12 @@ rtos_result_t semaphore_delete(uint8_t semaphore_id)
         return RTOS_INVALID_PARAM;
     }
     
-    semaphore_t* sem = &semaphores[semaphore_id];
-    
-    if(!sem->is_active)
+    if(!semaphores[semaphore_id].is_active)
     {
         return RTOS_ERROR;
     }
     
-    /* Wake up all waiting tasks with error */
-    while(sem->waiting_count > 0)
-    {
-        semaphore_wake_waiting_task(semaphore_id);
-    }
-    
-    /* Mark as inactive */
-    sem->is_active = false;
+    semaphore_destroy(&semaphores[semaphore_id]);
     
     DEBUG_PRINT("Semaphore %d deleted\n", semaphore_id);
     
@@ -432,61 +670,1436 @@ rtos_result_t semaphore_take(uint8_t semaphore_id, uint32_t timeout_ms)
         return RTOS_INVALID_PARAM;
     }
     
-    semaphore_t* sem = &semaphores[semaphore_id];
-    
-    if(!sem->is_active)
+    return semaphore_take_from(&semaphores[semaphore_id], timeout_ms);
+}
+
+/**
+ * @brief Give/release a semaphore
+ */
+rtos_result_t semaphore_give(uint8_t semaphore_id)
+{
+    if(!queue_manager_initialized || semaphore_id >= MAX_SEMAPHORES)
     {
-        return RTOS_ERROR;
+        return RTOS_INVALID_PARAM;
     }
     
-    ENTER_CRITICAL();
+    return semaphore_give_to(&semaphores[semaphore_id]);
+}
+
+/**
+ * @brief Get current semaphore count
+ */
+uint8_t semaphore_get_count(uint8_t semaphore_id)
+{
+    if(!queue_manager_initialized || semaphore_id >= MAX_SEMAPHORES)
+    {
+        return 0xFF;
+    }
+    
+    return semaphores[semaphore_id].count;
+}
+#endif /* RTOS_USE_SEMAPHORES */
+
+/* ============================================================================
+ * HANDLE-BASED QUEUE AND SEMAPHORE FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Create the object tables for handle-based queues and semaphores
+ */
+rtos_result_t queue_manager_init_handles(uint16_t max_queues, uint16_t max_semaphores)
+{
+    if(!queue_manager_initialized || max_queues == 0 || max_semaphores == 0)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    rtos_result_t result = object_table_create(&queue_table, sizeof(queue_t), max_queues);
+    if(result != RTOS_SUCCESS)
+    {
+        return result;
+    }
+    
+#if RTOS_USE_SEMAPHORES
+    result = object_table_create(&semaphore_table, sizeof(semaphore_t), max_semaphores);
+    if(result != RTOS_SUCCESS)
+    {
+        object_table_delete(&queue_table);
+        return result;
+    }
+#else
+    UNUSED(max_semaphores);
+#endif
+    
+    DEBUG_PRINT("Handle tables created (%u queues, %u semaphores)\n", max_queues, max_semaphores);
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Create a queue and return its handle
+ */
+queue_handle_t queue_create_handle(uint32_t size, uint32_t item_size)
+{
+    queue_handle_t handle;
+    queue_t* queue = (queue_t*)object_alloc(&queue_table, &handle);
+    
+    if(queue == NULL)
+    {
+        return OBJECT_HANDLE_INVALID;
+    }
+    
+    queue->queue_id = 0xFF; /* Not in the static queue array */
+    
+    if(queue_init_object(queue, size, item_size, NULL) != QUEUE_SUCCESS)
+    {
+        object_free(&queue_table, handle);
+        return OBJECT_HANDLE_INVALID;
+    }
+    
+    return handle;
+}
+
+/**
+ * @brief Delete a handle-based queue
+ */
+queue_result_t queue_delete_handle(queue_handle_t handle)
+{
+    queue_t* queue = (queue_t*)object_get(&queue_table, handle);
+    
+    if(queue == NULL || !queue->is_active)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    queue_destroy(queue);
+    object_free(&queue_table, handle);
+    
+    return QUEUE_SUCCESS;
+}
+
+/**
+ * @brief Send data to a handle-based queue
+ */
+queue_result_t queue_send_handle(queue_handle_t handle, const void* data, uint32_t timeout_ms)
+{
+    queue_t* queue = (queue_t*)object_get(&queue_table, handle);
+    
+    if(queue == NULL)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    return queue_send_to(queue, data, timeout_ms);
+}
+
+/**
+ * @brief Receive data from a handle-based queue
+ */
+queue_result_t queue_receive_handle(queue_handle_t handle, void* data, uint32_t timeout_ms)
+{
+    queue_t* queue = (queue_t*)object_get(&queue_table, handle);
+    
+    if(queue == NULL)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    return queue_receive_from(queue, data, timeout_ms);
+}
+
+#if RTOS_USE_SEMAPHORES
+/**
+ * @brief Create a semaphore and return its handle
+ */
+semaphore_handle_t semaphore_create_handle(uint8_t initial_count, uint8_t max_count)
+{
+    if(initial_count > max_count)
+    {
+        return OBJECT_HANDLE_INVALID;
+    }
+    
+#if SEMAPHORE_MAX_COUNT < 255
+    /* A uint8_t count can only exceed a limit below its own range */
+    if(max_count > SEMAPHORE_MAX_COUNT)
+    {
+        return OBJECT_HANDLE_INVALID;
+    }
+#endif
+    
+    semaphore_handle_t handle;
+    semaphore_t* sem = (semaphore_t*)object_alloc(&semaphore_table, &handle);
+    
+    if(sem == NULL)
+    {
+        return OBJECT_HANDLE_INVALID;
+    }
+    
+    sem->semaphore_id = 0xFF; /* Not in the static semaphore array */
+    semaphore_init_object(sem, initial_count, max_count);
+    
+    return handle;
+}
+
+/**
+ * @brief Delete a handle-based semaphore
+ */
+rtos_result_t semaphore_delete_handle(semaphore_handle_t handle)
+{
+    semaphore_t* sem = (semaphore_t*)object_get(&semaphore_table, handle);
+    
+    if(sem == NULL || !sem->is_active)
+    {
+        return RTOS_ERROR;
+    }
+    
+    semaphore_destroy(sem);
+    object_free(&semaphore_table, handle);
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Take a handle-based semaphore
+ */
+rtos_result_t semaphore_take_handle(semaphore_handle_t handle, uint32_t timeout_ms)
+{
+    semaphore_t* sem = (semaphore_t*)object_get(&semaphore_table, handle);
+    
+    if(sem == NULL)
+    {
+        return RTOS_ERROR;
+    }
+    
+    return semaphore_take_from(sem, timeout_ms);
+}
+
+/**
+ * @brief Give a handle-based semaphore
+ */
+rtos_result_t semaphore_give_handle(semaphore_handle_t handle)
+{
+    semaphore_t* sem = (semaphore_t*)object_get(&semaphore_table, handle);
+    
+    if(sem == NULL)
+    {
+        return RTOS_ERROR;
+    }
+    
+    return semaphore_give_to(sem);
+}
+#endif
+
+/* ============================================================================
+ * SPSC RING FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Create a single-producer/single-consumer ring
+ */
+queue_result_t spsc_create(uint8_t ring_id, uint32_t size, uint32_t item_size)
+{
+    return spsc_init_ring(ring_id, size, item_size, NULL);
+}
+
+/**
+ * @brief Create an SPSC ring on caller-provided storage
+ */
+queue_result_t spsc_create_static(uint8_t ring_id, uint32_t size, uint32_t item_size, void* buffer)
+{
+    if(buffer == NULL)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    return spsc_init_ring(ring_id, size, item_size, buffer);
+}
+
+/**
+ * @brief Delete an SPSC ring
+ */
+queue_result_t spsc_delete(uint8_t ring_id)
+{
+    if(!queue_manager_initialized || ring_id >= MAX_SPSC_RINGS)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    spsc_ring_t* ring = &spsc_rings[ring_id];
+    
+    if(!ring->is_active)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    /* Wake a sleeping consumer with error */
+    tcb_t* tcb = ring->waiting_task;
+    ring->waiting_task = NULL;
+    if(tcb != NULL)
+    {
+        task_wake_blocked(tcb, QUEUE_ERROR);
+    }
+    
+    ring->is_active = false;
+    
+    EXIT_CRITICAL();
+    
+    if(ring->owns_buffer)
+    {
+        memory_free(ring->buffer);
+    }
+    ring->buffer = NULL;
+    
+    /* Woken task may outrank the caller */
+    scheduler_switch_context();
+    
+    DEBUG_PRINT("SPSC ring %d deleted\n", ring_id);
+    
+    return QUEUE_SUCCESS;
+}
+
+/**
+ * @brief Push an item from task context
+ */
+queue_result_t spsc_send(uint8_t ring_id, const void* data)
+{
+    if(ring_id >= MAX_SPSC_RINGS || data == NULL || !spsc_rings[ring_id].is_active)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    bool task_woken = false;
+    queue_result_t result = spsc_push(&spsc_rings[ring_id], data, &task_woken);
+    
+    if(task_woken)
+    {
+        scheduler_switch_context();
+    }
+    
+    return result;
+}
+
+/**
+ * @brief Push an item from an ISR
+ */
+queue_result_t spsc_send_from_isr(uint8_t ring_id, const void* data, bool* task_woken)
+{
+    if(ring_id >= MAX_SPSC_RINGS || data == NULL || !spsc_rings[ring_id].is_active)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    bool woken = false;
+    queue_result_t result = spsc_push(&spsc_rings[ring_id], data, &woken);
+    
+    /* Accumulate so one ISR can push several items and switch once */
+    if(task_woken != NULL && woken)
+    {
+        *task_woken = true;
+    }
+    
+    return result;
+}
+
+/**
+ * @brief Pop an item without waiting (task context)
+ */
+queue_result_t spsc_receive(uint8_t ring_id, void* data)
+{
+    if(ring_id >= MAX_SPSC_RINGS || data == NULL || !spsc_rings[ring_id].is_active)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    return spsc_pop(&spsc_rings[ring_id], data);
+}
+
+/**
+ * @brief Pop an item from an ISR
+ */
+queue_result_t spsc_receive_from_isr(uint8_t ring_id, void* data)
+{
+    /* The pop path never blocks or masks interrupts, so it is ISR-safe as is */
+    return spsc_receive(ring_id, data);
+}
+
+/**
+ * @brief Pop an item, sleeping until the producer publishes one
+ */
+queue_result_t spsc_receive_wait(uint8_t ring_id, void* data, uint32_t timeout_ms)
+{
+    if(ring_id >= MAX_SPSC_RINGS || data == NULL || !spsc_rings[ring_id].is_active)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    spsc_ring_t* ring = &spsc_rings[ring_id];
+    
+    /* Fast path: nothing to coordinate if an item is already there */
+    if(spsc_pop(ring, data) == QUEUE_SUCCESS)
+    {
+        return QUEUE_SUCCESS;
+    }
+    
+    ENTER_CRITICAL();
+    
+    if(!wait_can_block(timeout_ms))
+    {
+        EXIT_CRITICAL();
+        return QUEUE_EMPTY;
+    }
+    
+    /* Re-check with the producer locked out, then announce that we sleep */
+    if(ring->tail == ring->head)
+    {
+        tcb_t* current_task = task_get_current();
+        ring->waiting_task = current_task;
+        task_block_current(NULL, wait_timeout_ticks(timeout_ms), NULL);
+        
+        EXIT_CRITICAL();
+        
+        scheduler_yield();
+        
+        ENTER_CRITICAL();
+        
+        /* Still set if we timed out rather than being woken */
+        if(ring->waiting_task == current_task)
+        {
+            ring->waiting_task = NULL;
+        }
+        
+        queue_result_t result = (queue_result_t)current_task->wait_result;
+        
+        EXIT_CRITICAL();
+        
+        if(result != QUEUE_SUCCESS)
+        {
+            return result;
+        }
+    }
+    else
+    {
+        EXIT_CRITICAL();
+    }
+    
+    return spsc_pop(ring, data);
+}
+
+/**
+ * @brief Get number of items in an SPSC ring
+ */
+uint32_t spsc_get_count(uint8_t ring_id)
+{
+    if(!queue_manager_initialized || ring_id >= MAX_SPSC_RINGS)
+    {
+        return 0xFFFFFFFF;
+    }
+    
+    spsc_ring_t* ring = &spsc_rings[ring_id];
+    
+    return ring->tail - ring->head;
+}
+
+/* ============================================================================
+ * MUTEX FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Create a mutex
+ */
+rtos_result_t mutex_create(uint8_t mutex_id)
+{
+    if(!queue_manager_initialized || mutex_id >= MAX_MUTEXES)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    mutex_t* mutex = &mutexes[mutex_id];
+    
+    if(mutex->is_active)
+    {
+        return RTOS_ERROR; /* Mutex already exists */
+    }
+    
+    /* Initialize mutex */
+    mutex->owner = NULL;
+    mutex->lock_count = 0;
+    mutex->next_held = NULL;
+    task_wait_list_init(&mutex->waiters);
+    mutex->is_active = true;
+    
+    DEBUG_PRINT("Mutex %d created\n", mutex_id);
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Delete a mutex
+ */
+rtos_result_t mutex_delete(uint8_t mutex_id)
+{
+    if(!queue_manager_initialized || mutex_id >= MAX_MUTEXES)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    mutex_t* mutex = &mutexes[mutex_id];
+    
+    if(!mutex->is_active)
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    /* Wake up all waiting tasks with error */
+    wait_list_cancel(&mutex->waiters);
+    
+    /* The owner no longer inherits anything through this mutex */
+    tcb_t* owner = mutex->owner;
+    if(owner != NULL)
+    {
+        mutex_remove_held(owner, mutex);
+        mutex->owner = NULL;
+        mutex->lock_count = 0;
+        mutex_update_priority(owner);
+    }
+    
+    /* Mark as inactive */
+    mutex->is_active = false;
+    
+    EXIT_CRITICAL();
+    
+    /* Woken tasks may outrank the caller */
+    scheduler_switch_context();
+    
+    DEBUG_PRINT("Mutex %d deleted\n", mutex_id);
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Lock a mutex
+ */
+rtos_result_t mutex_lock(uint8_t mutex_id, uint32_t timeout_ms)
+{
+    if(!queue_manager_initialized || mutex_id >= MAX_MUTEXES)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    mutex_t* mutex = &mutexes[mutex_id];
+    tcb_t* current_task = task_get_current();
+    
+    /* Ownership belongs to a task, never to an ISR */
+    if(!mutex->is_active || current_task == NULL || cortex_m_in_interrupt())
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    if(mutex->owner == NULL)
+    {
+        /* Mutex free - take it */
+        mutex->owner = current_task;
+        mutex->lock_count = 1;
+        mutex->next_held = current_task->held_mutexes;
+        current_task->held_mutexes = mutex;
+        EXIT_CRITICAL();
+        return RTOS_SUCCESS;
+    }
+    
+    if(mutex->owner == current_task)
+    {
+        /* Recursive lock */
+        if(mutex->lock_count >= MUTEX_MAX_LOCK_COUNT)
+        {
+            EXIT_CRITICAL();
+            return RTOS_ERROR;
+        }
+        
+        mutex->lock_count++;
+        EXIT_CRITICAL();
+        return RTOS_SUCCESS;
+    }
+    
+    if(!wait_can_block(timeout_ms))
+    {
+        EXIT_CRITICAL();
+        return RTOS_TIMEOUT;
+    }
+    
+    /* Sleep until unlock hands the mutex over, lending the owner our priority */
+    current_task->waiting_mutex = mutex;
+    task_block_current(&mutex->waiters, wait_timeout_ticks(timeout_ms), NULL);
+    mutex_update_priority(mutex->owner);
+    
+    EXIT_CRITICAL();
+    
+    scheduler_yield();
+    
+    ENTER_CRITICAL();
+    
+    /* A timeout already withdrew the priority we lent (mutex_abandon_wait) */
+    current_task->waiting_mutex = NULL;
+    
+    rtos_result_t result = (rtos_result_t)current_task->wait_result;
+    
+    EXIT_CRITICAL();
+    
+    return result;
+}
+
+/**
+ * @brief Unlock a mutex
+ */
+rtos_result_t mutex_unlock(uint8_t mutex_id)
+{
+    if(!queue_manager_initialized || mutex_id >= MAX_MUTEXES)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    mutex_t* mutex = &mutexes[mutex_id];
+    tcb_t* current_task = task_get_current();
+    
+    if(current_task == NULL || cortex_m_in_interrupt())
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    if(!mutex->is_active || mutex->owner != current_task)
+    {
+        EXIT_CRITICAL();
+        return RTOS_ERROR; /* Only the owner may unlock */
+    }
+    
+    if(--mutex->lock_count > 0)
+    {
+        EXIT_CRITICAL();
+        return RTOS_SUCCESS; /* Still held recursively */
+    }
+    
+    mutex_remove_held(current_task, mutex);
+    mutex_hand_over(mutex);
+    
+    /* Drop back to the base priority (or what other held mutexes still lend) */
+    mutex_update_priority(current_task);
+    
+    EXIT_CRITICAL();
+    
+    scheduler_switch_context();
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Get the task that owns a mutex
+ */
+uint8_t mutex_get_owner(uint8_t mutex_id)
+{
+    if(!queue_manager_initialized || mutex_id >= MAX_MUTEXES)
+    {
+        return 0xFF;
+    }
+    
+    tcb_t* owner = mutexes[mutex_id].owner;
+    
+    return (owner != NULL) ? owner->task_id : 0xFF;
+}
+
+/**
+ * @brief Withdraw the priority a task lent while waiting on a mutex
+ */
+void mutex_abandon_wait(tcb_t* tcb)
+{
+    mutex_t* mutex = tcb->waiting_mutex;
+    tcb->waiting_mutex = NULL;
+    
+    if(mutex != NULL && mutex->owner != NULL)
+    {
+        mutex_update_priority(mutex->owner);
+    }
+}
+
+/**
+ * @brief Hand every mutex a task holds to its best waiter
+ */
+void mutex_release_all(tcb_t* tcb)
+{
+    while(tcb->held_mutexes != NULL)
+    {
+        mutex_t* mutex = tcb->held_mutexes;
+        
+        mutex_remove_held(tcb, mutex);
+        mutex_hand_over(mutex);
+    }
+}
+
+/* ============================================================================
+ * EVENT GROUP FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Create an event group
+ */
+rtos_result_t event_group_create(uint8_t group_id)
+{
+    if(!queue_manager_initialized || group_id >= MAX_EVENT_GROUPS)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    event_group_t* group = &event_groups[group_id];
+    
+    if(group->is_active)
+    {
+        return RTOS_ERROR; /* Event group already exists */
+    }
+    
+    /* Initialize event group */
+    group->bits = 0;
+    task_wait_list_init(&group->waiters);
+    group->is_active = true;
+    
+    DEBUG_PRINT("Event group %d created\n", group_id);
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Delete an event group
+ */
+rtos_result_t event_group_delete(uint8_t group_id)
+{
+    if(!queue_manager_initialized || group_id >= MAX_EVENT_GROUPS)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    event_group_t* group = &event_groups[group_id];
+    
+    if(!group->is_active)
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    /* Wake up all waiting tasks with error */
+    wait_list_cancel(&group->waiters);
+    
+    /* Mark as inactive */
+    group->is_active = false;
+    
+    EXIT_CRITICAL();
+    
+    /* Woken tasks may outrank the caller */
+    scheduler_switch_context();
+    
+    DEBUG_PRINT("Event group %d deleted\n", group_id);
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Set bits and wake every waiter whose condition now holds
+ */
+rtos_result_t event_group_set_bits(uint8_t group_id, uint32_t bits)
+{
+    bool task_woken = false;
+    rtos_result_t result = event_group_set_bits_from_isr(group_id, bits, &task_woken);
+    
+    if(task_woken)
+    {
+        scheduler_switch_context();
+    }
+    
+    return result;
+}
+
+/**
+ * @brief Set bits from an ISR
+ */
+rtos_result_t event_group_set_bits_from_isr(uint8_t group_id, uint32_t bits, bool* task_woken)
+{
+    if(!queue_manager_initialized || group_id >= MAX_EVENT_GROUPS)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    event_group_t* group = &event_groups[group_id];
+    
+    ENTER_CRITICAL();
+    
+    if(!group->is_active)
+    {
+        EXIT_CRITICAL();
+        return RTOS_ERROR;
+    }
+    
+    group->bits |= bits;
+    bool woken = event_group_wake_waiters(group);
+    
+    EXIT_CRITICAL();
+    
+    /* Accumulate so one ISR can signal several groups and switch once */
+    if(task_woken != NULL && woken)
+    {
+        *task_woken = true;
+    }
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Clear bits
+ */
+rtos_result_t event_group_clear_bits(uint8_t group_id, uint32_t bits)
+{
+    if(!queue_manager_initialized || group_id >= MAX_EVENT_GROUPS)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    event_group_t* group = &event_groups[group_id];
+    
+    if(!group->is_active)
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    group->bits &= ~bits;
+    EXIT_CRITICAL();
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Get the current bits
+ */
+uint32_t event_group_get_bits(uint8_t group_id)
+{
+    if(!queue_manager_initialized || group_id >= MAX_EVENT_GROUPS)
+    {
+        return 0;
+    }
+    
+    return event_groups[group_id].bits;
+}
+
+/**
+ * @brief Wait for any or all of a set of bits
+ */
+rtos_result_t event_group_wait(uint8_t group_id, uint32_t bits, uint8_t options,
+                               uint32_t* bits_out, uint32_t timeout_ms)
+{
+    if(!queue_manager_initialized || group_id >= MAX_EVENT_GROUPS || bits == 0)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    event_group_t* group = &event_groups[group_id];
+    
+    if(!group->is_active)
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    if(event_group_matches(group->bits, bits, options))
+    {
+        /* Condition already holds */
+        if(bits_out != NULL)
+        {
+            *bits_out = group->bits;
+        }
+        
+        if(options & EVENT_CLEAR_ON_EXIT)
+        {
+            group->bits &= ~bits;
+        }
+        
+        EXIT_CRITICAL();
+        return RTOS_SUCCESS;
+    }
+    
+    if(!wait_can_block(timeout_ms))
+    {
+        if(bits_out != NULL)
+        {
+            *bits_out = group->bits;
+        }
+        
+        EXIT_CRITICAL();
+        return RTOS_TIMEOUT;
+    }
+    
+    /* Sleep until a set completes our condition */
+    event_wait_t wait;
+    wait.bits = bits;
+    wait.options = options;
+    wait.matched_bits = 0;
+    
+    tcb_t* current_task = task_get_current();
+    task_block_current(&group->waiters, wait_timeout_ticks(timeout_ms), &wait);
+    
+    EXIT_CRITICAL();
+    
+    scheduler_yield();
+    
+    rtos_result_t result = (rtos_result_t)current_task->wait_result;
+    
+    if(bits_out != NULL)
+    {
+        *bits_out = (result == RTOS_SUCCESS) ? wait.matched_bits : group->bits;
+    }
+    
+    return result;
+}
+
+/* ============================================================================
+ * QUEUE SET FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Create a queue set
+ */
+rtos_result_t queue_set_create(uint8_t set_id)
+{
+    if(!queue_manager_initialized || set_id >= MAX_QUEUE_SETS)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    queue_set_t* set = &queue_sets[set_id];
+    
+    if(set->is_active)
+    {
+        return RTOS_ERROR; /* Queue set already exists */
+    }
+    
+    task_wait_list_init(&set->waiters);
+    set->is_active = true;
+    
+    DEBUG_PRINT("Queue set %d created\n", set_id);
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Delete a queue set
+ */
+rtos_result_t queue_set_delete(uint8_t set_id)
+{
+    if(!queue_manager_initialized || set_id >= MAX_QUEUE_SETS)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    queue_set_t* set = &queue_sets[set_id];
+    
+    if(!set->is_active)
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    /* Release the members */
+    for(int i = 0; i < MAX_QUEUES; i++)
+    {
+        if(queues[i].set_id == set_id)
+        {
+            queues[i].set_id = QUEUE_SET_INVALID_ID;
+        }
+    }
+#if RTOS_USE_SEMAPHORES
+    for(int i = 0; i < MAX_SEMAPHORES; i++)
+    {
+        if(semaphores[i].set_id == set_id)
+        {
+            semaphores[i].set_id = QUEUE_SET_INVALID_ID;
+        }
+    }
+#endif
+    
+    /* Wake up all waiting tasks with error */
+    wait_list_cancel(&set->waiters);
+    
+    /* Mark as inactive */
+    set->is_active = false;
+    
+    EXIT_CRITICAL();
+    
+    /* Woken tasks may outrank the caller */
+    scheduler_switch_context();
+    
+    DEBUG_PRINT("Queue set %d deleted\n", set_id);
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Add a queue or semaphore to a set
+ */
+rtos_result_t queue_set_add(uint8_t set_id, uint8_t member)
+{
+    if(!queue_manager_initialized || set_id >= MAX_QUEUE_SETS)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    if(!queue_sets[set_id].is_active)
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    uint8_t* link = queue_set_member_link(member);
+    
+    if(link == NULL || *link != QUEUE_SET_INVALID_ID)
+    {
+        EXIT_CRITICAL();
+        return (link == NULL) ? RTOS_INVALID_PARAM : RTOS_ERROR;
+    }
+    
+    *link = set_id;
+    
+    /* A member that is already ready releases a task selecting on the set */
+    bool woken = queue_set_member_ready(member) && queue_set_notify(set_id, member);
+    
+    EXIT_CRITICAL();
+    
+    if(woken)
+    {
+        scheduler_switch_context();
+    }
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Remove a queue or semaphore from a set
+ */
+rtos_result_t queue_set_remove(uint8_t set_id, uint8_t member)
+{
+    if(!queue_manager_initialized || set_id >= MAX_QUEUE_SETS)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    ENTER_CRITICAL();
+    
+    uint8_t* link = queue_set_member_link(member);
+    
+    if(link == NULL || *link != set_id)
+    {
+        EXIT_CRITICAL();
+        return (link == NULL) ? RTOS_INVALID_PARAM : RTOS_ERROR;
+    }
+    
+    *link = QUEUE_SET_INVALID_ID;
+    
+    EXIT_CRITICAL();
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Wait until any member of a set is ready
+ */
+uint8_t queue_set_select(uint8_t set_id, uint32_t timeout_ms)
+{
+    if(!queue_manager_initialized || set_id >= MAX_QUEUE_SETS)
+    {
+        return QUEUE_SET_MEMBER_NONE;
+    }
+    
+    queue_set_t* set = &queue_sets[set_id];
+    
+    if(!set->is_active)
+    {
+        return QUEUE_SET_MEMBER_NONE;
+    }
+    
+    ENTER_CRITICAL();
+    
+    /* Already ready: report the first member found (queues before semaphores) */
+    for(int i = 0; i < MAX_QUEUES; i++)
+    {
+        if(queues[i].set_id == set_id && queue_set_member_ready(QUEUE_SET_MEMBER_QUEUE(i)))
+        {
+            EXIT_CRITICAL();
+            return QUEUE_SET_MEMBER_QUEUE(i);
+        }
+    }
+#if RTOS_USE_SEMAPHORES
+    for(int i = 0; i < MAX_SEMAPHORES; i++)
+    {
+        if(semaphores[i].set_id == set_id && queue_set_member_ready(QUEUE_SET_MEMBER_SEMAPHORE(i)))
+        {
+            EXIT_CRITICAL();
+            return QUEUE_SET_MEMBER_SEMAPHORE(i);
+        }
+    }
+#endif
+    
+    if(!wait_can_block(timeout_ms))
+    {
+        EXIT_CRITICAL();
+        return QUEUE_SET_MEMBER_NONE;
+    }
+    
+    /* Sleep until a send or give names the member; left at NONE on timeout */
+    uint8_t member = QUEUE_SET_MEMBER_NONE;
+    
+    task_block_current(&set->waiters, wait_timeout_ticks(timeout_ms), &member);
+    
+    EXIT_CRITICAL();
+    
+    scheduler_yield();
+    
+    return member;
+}
+
+/* ============================================================================
+ * UTILITY FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Print queue information
+ */
+void queue_print_info(uint8_t queue_id)
+{
+    if(queue_id == 0xFF)
+    {
+        /* Print all queues */
+        DEBUG_PRINT("=== Queue Information ===\n");
+        for(int i = 0; i < MAX_QUEUES; i++)
+        {
+            if(queues[i].is_active)
+            {
+                DEBUG_PRINT("Queue %d: Size=%u, Item=%u, Count=%u, Senders=%d, Receivers=%d\n",
+                           i, queues[i].size, queues[i].item_size, queues[i].count,
+                           queues[i].send_waiters.count, queues[i].receive_waiters.count);
+            }
+        }
+    }
+    else if(queue_id < MAX_QUEUES && queues[queue_id].is_active)
+    {
+        queue_t* queue = &queues[queue_id];
+        DEBUG_PRINT("Queue %d: Size=%u, Count=%u, Head=%u, Tail=%u\n",
+                   queue_id, queue->size, queue->count, queue->head, queue->tail);
+    }
+}
+
+#if RTOS_USE_SEMAPHORES
+/**
+ * @brief Print semaphore information
+ */
+void semaphore_print_info(uint8_t semaphore_id)
+{
+    if(semaphore_id == 0xFF)
+    {
+        /* Print all semaphores */
+        DEBUG_PRINT("=== Semaphore Information ===\n");
+        for(int i = 0; i < MAX_SEMAPHORES; i++)
+        {
+            if(semaphores[i].is_active)
+            {
+                DEBUG_PRINT("Semaphore %d: Count=%d, Max=%d, Waiting=%d\n",
+                           i, semaphores[i].count, semaphores[i].max_count,
+                           semaphores[i].waiters.count);
+            }
+        }
+    }
+    else if(semaphore_id < MAX_SEMAPHORES && semaphores[semaphore_id].is_active)
+    {
+        semaphore_t* sem = &semaphores[semaphore_id];
+        DEBUG_PRINT("Semaphore %d: Count=%d, Max=%d, Waiting=%d\n",
+                   semaphore_id, sem->count, sem->max_count, sem->waiters.count);
+    }
+}
+#endif
+
+/**
+ * @brief Handle timeouts for waiting tasks
+ */
+void queue_manager_handle_timeouts(void)
+{
+    /* Nothing to do: blocked tasks sit on the task delay list, so the tick
+     * wakes them with wait_result = RTOS_TIMEOUT and unlinks them from the
+     * object's wait list. Kept for callers of the old polling interface. */
+}
+
+/* ============================================================================
+ * PRIVATE FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Set up a queue object, allocating its buffer unless one is given
+ */
+static queue_result_t queue_init_object(queue_t* queue, uint32_t size, uint32_t item_size, void* buffer)
+{
+    if(size == 0 || size > MAX_QUEUE_SIZE)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    if(item_size == 0 || item_size > 0xFFFFFFFF / MAX_QUEUE_SIZE - QUEUE_SLOT_ALIGNMENT)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    /* Keep every slot aligned so it can be filled in place */
+    uint32_t slot_size = (item_size + QUEUE_SLOT_ALIGNMENT - 1) & ~(QUEUE_SLOT_ALIGNMENT - 1);
+    
+    /* Allocate buffer */
+    queue->owns_buffer = (buffer == NULL);
+    queue->buffer = (buffer != NULL) ? (uint8_t*)buffer : (uint8_t*)memory_alloc_prefer(MEMORY_REGION_ATTR_FAST, size * slot_size);
+    if(queue->buffer == NULL)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    /* Initialize queue */
+    queue->size = size;
+    queue->item_size = item_size;
+    queue->slot_size = slot_size;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->count = 0;
+    queue->is_active = true;
+    queue->send_reserved = false;
+    queue->receive_borrowed = false;
+    queue->set_id = QUEUE_SET_INVALID_ID;
+    task_wait_list_init(&queue->send_waiters);
+    task_wait_list_init(&queue->receive_waiters);
+    
+    return QUEUE_SUCCESS;
+}
+
+/**
+ * @brief Cancel a queue's waiters and release its buffer
+ */
+static void queue_destroy(queue_t* queue)
+{
+    ENTER_CRITICAL();
+    
+    /* Wake up all waiting tasks with error */
+    wait_list_cancel(&queue->send_waiters);
+    wait_list_cancel(&queue->receive_waiters);
+    
+    /* Mark as inactive (and drop out of its queue set) */
+    queue->is_active = false;
+    queue->send_reserved = false;
+    queue->receive_borrowed = false;
+    queue->set_id = QUEUE_SET_INVALID_ID;
+    
+    EXIT_CRITICAL();
+    
+    /* Free buffer (static buffers belong to the caller) */
+    if(queue->buffer != NULL && queue->owns_buffer)
+    {
+        memory_free(queue->buffer);
+    }
+    queue->buffer = NULL;
+    
+    /* Woken tasks may outrank the caller */
+    scheduler_switch_context();
+}
+
+/**
+ * @brief Send data to a queue object
+ */
+static queue_result_t queue_send_to(queue_t* queue, const void* data, uint32_t timeout_ms)
+{
+    if(data == NULL || !queue->is_active)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    /* Check if queue is full (a reserved slot blocks the tail) */
+    if(queue->count >= queue->size || queue->send_reserved)
+    {
+        if(!wait_can_block(timeout_ms))
+        {
+            EXIT_CRITICAL();
+            return QUEUE_FULL;
+        }
+        
+        /* Sleep until a receiver copies the item in for us */
+        tcb_t* current_task = task_get_current();
+        RTOS_TRACE(TRACE_EVENT_QUEUE_BLOCK_SEND, queue->queue_id);
+        task_block_current(&queue->send_waiters, wait_timeout_ticks(timeout_ms), (void*)data);
+        
+        EXIT_CRITICAL();
+        
+        scheduler_yield();
+        
+        return (queue_result_t)current_task->wait_result;
+    }
+    
+    /* Add data to queue */
+    memcpy(queue_slot(queue, queue->tail), data, queue->item_size);
+    queue->tail = (queue->tail + 1) % queue->size;
+    queue->count++;
+    RTOS_TRACE(TRACE_EVENT_QUEUE_SEND, queue->queue_id);
+    
+    /* Hand the item to a waiting receiver */
+    bool woken = queue_service_waiters(queue);
+    
+    EXIT_CRITICAL();
+    
+    if(woken)
+    {
+        scheduler_switch_context();
+    }
+    
+    return QUEUE_SUCCESS;
+}
+
+/**
+ * @brief Receive data from a queue object
+ */
+static queue_result_t queue_receive_from(queue_t* queue, void* data, uint32_t timeout_ms)
+{
+    if(data == NULL || !queue->is_active)
+    {
+        return QUEUE_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    /* Check if queue is empty (a borrowed slot blocks the head) */
+    if(queue->count == 0 || queue->receive_borrowed)
+    {
+        if(!wait_can_block(timeout_ms))
+        {
+            EXIT_CRITICAL();
+            return QUEUE_EMPTY;
+        }
+        
+        /* Sleep until a sender copies an item out to us */
+        tcb_t* current_task = task_get_current();
+        RTOS_TRACE(TRACE_EVENT_QUEUE_BLOCK_RECEIVE, queue->queue_id);
+        task_block_current(&queue->receive_waiters, wait_timeout_ticks(timeout_ms), data);
+        
+        EXIT_CRITICAL();
+        
+        scheduler_yield();
+        
+        return (queue_result_t)current_task->wait_result;
+    }
+    
+    /* Get data from queue */
+    memcpy(data, queue_slot(queue, queue->head), queue->item_size);
+    queue->head = (queue->head + 1) % queue->size;
+    queue->count--;
+    RTOS_TRACE(TRACE_EVENT_QUEUE_RECEIVE, queue->queue_id);
+    
+    /* Let a waiting sender fill the freed slot */
+    bool woken = queue_service_waiters(queue);
+    
+    EXIT_CRITICAL();
+    
+    if(woken)
+    {
+        scheduler_switch_context();
+    }
+    
+    return QUEUE_SUCCESS;
+}
+
+#if RTOS_USE_SEMAPHORES
+/**
+ * @brief Initialize a semaphore object
+ */
+static void semaphore_init_object(semaphore_t* sem, uint8_t initial_count, uint8_t max_count)
+{
+    sem->count = initial_count;
+    sem->max_count = max_count;
+    sem->is_active = true;
+    sem->set_id = QUEUE_SET_INVALID_ID;
+    task_wait_list_init(&sem->waiters);
+}
+
+/**
+ * @brief Cancel a semaphore's waiters and mark it inactive
+ */
+static void semaphore_destroy(semaphore_t* sem)
+{
+    ENTER_CRITICAL();
+    
+    /* Wake up all waiting tasks with error */
+    wait_list_cancel(&sem->waiters);
+    
+    /* Mark as inactive (and drop out of its queue set) */
+    sem->is_active = false;
+    sem->set_id = QUEUE_SET_INVALID_ID;
+    
+    EXIT_CRITICAL();
+    
+    /* Woken tasks may outrank the caller */
+    scheduler_switch_context();
+}
+
+/**
+ * @brief Take a semaphore object
+ */
+static rtos_result_t semaphore_take_from(semaphore_t* sem, uint32_t timeout_ms)
+{
+    if(!sem->is_active)
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
     
     if(sem->count > 0)
     {
         /* Semaphore available */
         sem->count--;
+        RTOS_TRACE(TRACE_EVENT_SEMAPHORE_TAKE, sem->semaphore_id);
         EXIT_CRITICAL();
         return RTOS_SUCCESS;
     }
     
-    EXIT_CRITICAL();
-    
     /* Semaphore not available */
-    if(timeout_ms == 0)
+    if(!wait_can_block(timeout_ms))
     {
+        EXIT_CRITICAL();
         return RTOS_TIMEOUT;
     }
     
-    /* Add current task to waiting list */
+    /* Sleep until a give hands the count over to us */
     tcb_t* current_task = task_get_current();
-    if(current_task != NULL)
-    {
-        semaphore_add_waiting_task(semaphore_id, current_task->task_id);
-        task_set_state(current_task->task_id, TASK_STATE_BLOCKED);
-        
-        /* In real implementation, would set timeout and yield */
-        /* For simulation, return timeout */
-        if(timeout_ms != QUEUE_TIMEOUT_INFINITE)
-        {
-            return RTOS_TIMEOUT;
-        }
-    }
+    RTOS_TRACE(TRACE_EVENT_SEMAPHORE_BLOCK, sem->semaphore_id);
+    task_block_current(&sem->waiters, wait_timeout_ticks(timeout_ms), NULL);
+    
+    EXIT_CRITICAL();
+    
+    scheduler_yield();
     
-    return RTOS_TIMEOUT;
+    return (rtos_result_t)current_task->wait_result;
 }
 
 /**
- * @brief Give/release a semaphore
+ * @brief Give a semaphore object
  */
-rtos_result_t semaphore_give(uint8_t semaphore_id)
+static rtos_result_t semaphore_give_to(semaphore_t* sem)
 {
-    if(!queue_manager_initialized || semaphore_id >= MAX_SEMAPHORES)
-    {
-        return RTOS_INVALID_PARAM;
-    }
-    
-    semaphore_t* sem = &semaphores[semaphore_id];
-    
     if(!sem->is_active)
     {
         return RTOS_ERROR;
@@ -494,11 +2107,13 @@ rtos_result_t semaphore_give(uint8_t semaphore_id)
     
     ENTER_CRITICAL();
     
-    /* Wake up waiting task first */
-    if(sem->waiting_count > 0)
+    RTOS_TRACE(TRACE_EVENT_SEMAPHORE_GIVE, sem->semaphore_id);
+    
+    /* Hand the count straight to a waiting task first */
+    if(semaphore_wake_waiting_task(sem))
     {
         EXIT_CRITICAL();
-        semaphore_wake_waiting_task(semaphore_id);
+        scheduler_switch_context();
         return RTOS_SUCCESS;
     }
     
@@ -512,218 +2127,572 @@ rtos_result_t semaphore_give(uint8_t semaphore_id)
     
     return RTOS_SUCCESS;
 }
+#endif
 
 /**
- * @brief Get current semaphore count
+ * @brief Wake up the highest-priority task waiting on a queue, handing its item over
+ * @return bool True if a task was woken
+ * @note Caller holds a critical section and has checked that a slot (sender)
+ *       or an item (receiver) is available. With no receiver waiting, a task
+ *       selecting on the queue's set is woken instead and no item moves.
  */
-uint8_t semaphore_get_count(uint8_t semaphore_id)
+static bool queue_wake_waiting_task(queue_t* queue, bool is_sender)
 {
-    if(!queue_manager_initialized || semaphore_id >= MAX_SEMAPHORES)
+    if(is_sender)
     {
-        return 0xFF;
+        tcb_t* tcb = queue->send_waiters.head;
+        
+        if(tcb == NULL)
+        {
+            return false;
+        }
+        
+        /* Copy the item from the blocked sender's buffer */
+        memcpy(queue_slot(queue, queue->tail), tcb->wait_data, queue->item_size);
+        queue->tail = (queue->tail + 1) % queue->size;
+        queue->count++;
+        
+        task_wake_blocked(tcb, QUEUE_SUCCESS);
+    }
+    else
+    {
+        tcb_t* tcb = queue->receive_waiters.head;
+        
+        if(tcb == NULL)
+        {
+            /* No direct receiver: wake a task selecting on the queue's set,
+             * which fetches the item itself */
+            return queue_set_notify(queue->set_id, QUEUE_SET_MEMBER_QUEUE(queue->queue_id));
+        }
+        
+        /* Copy the item into the blocked receiver's buffer */
+        memcpy(tcb->wait_data, queue_slot(queue, queue->head), queue->item_size);
+        queue->head = (queue->head + 1) % queue->size;
+        queue->count--;
+        
+        task_wake_blocked(tcb, QUEUE_SUCCESS);
     }
     
-    return semaphores[semaphore_id].count;
+    return true;
 }
 
-/* ============================================================================
- * UTILITY FUNCTIONS
- * ============================================================================ */
+/**
+ * @brief Complete transfers to blocked tasks until no more can proceed
+ * @return bool True if any task was woken
+ * @note Caller holds a critical section
+ */
+static bool queue_service_waiters(queue_t* queue)
+{
+    bool woken = false;
+    bool progress = true;
+    
+    while(progress)
+    {
+        progress = false;
+        
+        /* Blocked senders fill free slots */
+        if(queue->count < queue->size && !queue->send_reserved &&
+           queue_wake_waiting_task(queue, true))
+        {
+            progress = true;
+            woken = true;
+        }
+        
+        /* Blocked receivers drain queued items; a queue set notification
+         * moves none, so it must not repeat for the same items */
+        uint32_t queued = queue->count;
+        if(queue->count > 0 && !queue->receive_borrowed &&
+           queue_wake_waiting_task(queue, false))
+        {
+            progress = progress || (queue->count != queued);
+            woken = true;
+        }
+    }
+    
+    return woken;
+}
 
+#if RTOS_USE_SEMAPHORES
 /**
- * @brief Print queue information
+ * @brief Wake up the highest-priority task waiting on a semaphore, handing it the count
+ * @return bool True if a task was woken (the give is consumed)
+ * @note Caller holds a critical section. With no direct waiter, the count is
+ *       banked and a task selecting on the semaphore's set is woken to take it.
  */
-void queue_print_info(uint8_t queue_id)
+static bool semaphore_wake_waiting_task(semaphore_t* sem)
 {
-    if(queue_id == 0xFF)
+    tcb_t* tcb = sem->waiters.head;
+    
+    if(tcb == NULL)
     {
-        /* Print all queues */
-        DEBUG_PRINT("=== Queue Information ===\n");
-        for(int i = 0; i < MAX_QUEUES; i++)
+        if(sem->count < sem->max_count &&
+           queue_set_notify(sem->set_id, QUEUE_SET_MEMBER_SEMAPHORE(sem->semaphore_id)))
         {
-            if(queues[i].is_active)
+            sem->count++;
+            return true;
+        }
+        
+        return false;
+    }
+    
+    task_wake_blocked(tcb, RTOS_SUCCESS);
+    return true;
+}
+#endif
+
+/**
+ * @brief Unlink a mutex from its owner's held chain
+ * @note Caller holds a critical section
+ */
+static void mutex_remove_held(tcb_t* owner, mutex_t* mutex)
+{
+    mutex_t** link = &owner->held_mutexes;
+    
+    while(*link != NULL)
+    {
+        if(*link == mutex)
+        {
+            *link = mutex->next_held;
+            break;
+        }
+        link = &(*link)->next_held;
+    }
+    
+    mutex->next_held = NULL;
+}
+
+/**
+ * @brief Give an unlinked mutex to its highest-priority waiter
+ * @note Caller holds a critical section and has already taken the mutex
+ *       off the old owner's held chain. Handing over directly means nobody
+ *       can barge in between unlock and the waiter running.
+ */
+static void mutex_hand_over(mutex_t* mutex)
+{
+    tcb_t* next_owner = mutex->waiters.head;
+    mutex->owner = next_owner;
+    mutex->lock_count = 0;
+    
+    if(next_owner != NULL)
+    {
+        mutex->lock_count = 1;
+        mutex->next_held = next_owner->held_mutexes;
+        next_owner->held_mutexes = mutex;
+        next_owner->waiting_mutex = NULL;
+        task_wake_blocked(next_owner, RTOS_SUCCESS);
+        
+        /* Remaining waiters now push on the new owner */
+        mutex_update_priority(next_owner);
+    }
+}
+
+/**
+ * @brief Recompute a task's inherited priority and pass changes down the chain
+ * @note Caller holds a critical section. The effective priority is the base
+ *       priority raised to the best waiter on any mutex the task holds. If the
+ *       task itself waits on a mutex, that owner is updated next.
+ */
+static void mutex_update_priority(tcb_t* tcb)
+{
+    /* A chain cannot be longer than the number of tasks */
+    for(int depth = 0; tcb != NULL && depth < task_get_capacity(); depth++)
+    {
+        uint8_t priority = tcb->base_priority;
+        
+        for(mutex_t* mutex = tcb->held_mutexes; mutex != NULL; mutex = mutex->next_held)
+        {
+            /* Wait lists are sorted, the head is the best waiter */
+            tcb_t* waiter = mutex->waiters.head;
+            if(waiter != NULL && waiter->priority > priority)
             {
-                DEBUG_PRINT("Queue %d: Size=%u, Count=%u, Senders=%d, Receivers=%d\n",
-                           i, queues[i].size, queues[i].count,
-                           queues[i].send_waiting_count, queues[i].receive_waiting_count);
+                priority = waiter->priority;
             }
         }
+        
+        if(priority == tcb->priority)
+        {
+            break;
+        }
+        
+        task_change_priority(tcb, priority);
+        
+        /* Still queued on a mutex: its owner inherits through us */
+        mutex_t* waiting_mutex = tcb->waiting_mutex;
+        if(waiting_mutex != NULL && tcb->wait_list == &waiting_mutex->waiters)
+        {
+            tcb = waiting_mutex->owner;
+        }
+        else
+        {
+            tcb = NULL;
+        }
     }
-    else if(queue_id < MAX_QUEUES && queues[queue_id].is_active)
+}
+
+/**
+ * @brief Check whether group bits satisfy a wait condition
+ */
+static bool event_group_matches(uint32_t group_bits, uint32_t bits, uint8_t options)
+{
+    if(options & EVENT_WAIT_ALL)
     {
-        queue_t* queue = &queues[queue_id];
-        DEBUG_PRINT("Queue %d: Size=%u, Count=%u, Head=%u, Tail=%u\n",
-                   queue_id, queue->size, queue->count, queue->head, queue->tail);
+        return (group_bits & bits) == bits;
     }
+    
+    return (group_bits & bits) != 0;
 }
 
 /**
- * @brief Print semaphore information
+ * @brief Release every waiter whose condition holds, in one pass
+ * @return bool True if any task was woken
+ * @note Caller holds a critical section. Clear-on-exit bits are collected
+ *       and cleared after the pass so every waiter sees the same bits.
  */
-void semaphore_print_info(uint8_t semaphore_id)
+static bool event_group_wake_waiters(event_group_t* group)
 {
-    if(semaphore_id == 0xFF)
+    uint32_t clear_bits = 0;
+    bool woken = false;
+    tcb_t* tcb = group->waiters.head;
+    
+    while(tcb != NULL)
     {
-        /* Print all semaphores */
-        DEBUG_PRINT("=== Semaphore Information ===\n");
-        for(int i = 0; i < MAX_SEMAPHORES; i++)
+        /* Waking unlinks the task, so step first */
+        tcb_t* next = tcb->wait_next;
+        event_wait_t* wait = (event_wait_t*)tcb->wait_data;
+        
+        if(event_group_matches(group->bits, wait->bits, wait->options))
         {
-            if(semaphores[i].is_active)
+            wait->matched_bits = group->bits;
+            
+            if(wait->options & EVENT_CLEAR_ON_EXIT)
             {
-                DEBUG_PRINT("Semaphore %d: Count=%d, Max=%d, Waiting=%d\n",
-                           i, semaphores[i].count, semaphores[i].max_count,
-                           semaphores[i].waiting_count);
+                clear_bits |= wait->bits;
             }
+            
+            task_wake_blocked(tcb, RTOS_SUCCESS);
+            woken = true;
         }
+        
+        tcb = next;
     }
-    else if(semaphore_id < MAX_SEMAPHORES && semaphores[semaphore_id].is_active)
+    
+    group->bits &= ~clear_bits;
+    
+    return woken;
+}
+
+/**
+ * @brief Get the set_id field of a queue set member
+ * @return uint8_t* Member's set link (NULL if the handle names no active object)
+ * @note Caller holds a critical section
+ */
+static uint8_t* queue_set_member_link(uint8_t member)
+{
+    uint8_t id = QUEUE_SET_MEMBER_ID(member);
+    
+    if(QUEUE_SET_MEMBER_IS_SEMAPHORE(member))
     {
-        semaphore_t* sem = &semaphores[semaphore_id];
-        DEBUG_PRINT("Semaphore %d: Count=%d, Max=%d, Waiting=%d\n",
-                   semaphore_id, sem->count, sem->max_count, sem->waiting_count);
+#if RTOS_USE_SEMAPHORES
+        if(id < MAX_SEMAPHORES && semaphores[id].is_active)
+        {
+            return &semaphores[id].set_id;
+        }
+#endif
+        return NULL;
+    }
+    
+    if(id < MAX_QUEUES && queues[id].is_active)
+    {
+        return &queues[id].set_id;
     }
+    
+    return NULL;
 }
 
 /**
- * @brief Handle timeouts for waiting tasks
+ * @brief Check whether a zero-timeout read of a set member would succeed
+ * @note Caller holds a critical section
  */
-void queue_manager_handle_timeouts(void)
+static bool queue_set_member_ready(uint8_t member)
 {
-    /* This would be called by timer to handle task timeouts */
-    /* Implementation would check timeout values and wake up timed-out tasks */
+    uint8_t id = QUEUE_SET_MEMBER_ID(member);
     
-    /* For simulation, we'll keep this simple */
+    if(QUEUE_SET_MEMBER_IS_SEMAPHORE(member))
+    {
+#if RTOS_USE_SEMAPHORES
+        return semaphores[id].count > 0;
+#else
+        return false;
+#endif
+    }
+    
+    return queues[id].count > 0 && !queues[id].receive_borrowed;
 }
 
-/* ============================================================================
- * PRIVATE FUNCTIONS
- * ============================================================================ */
-
 /**
- * @brief Add task to queue waiting list
+ * @brief Wake the highest-priority task selecting on a set, naming the ready member
+ * @return bool True if a task was woken
+ * @note Caller holds a critical section
  */
-static void queue_add_waiting_task(uint8_t queue_id, uint8_t task_id, bool is_sender)
+static bool queue_set_notify(uint8_t set_id, uint8_t member)
 {
-    queue_t* queue = &queues[queue_id];
+    if(set_id == QUEUE_SET_INVALID_ID)
+    {
+        return false;
+    }
     
-    if(is_sender && queue->send_waiting_count < MAX_TASKS)
+    tcb_t* tcb = queue_sets[set_id].waiters.head;
+    
+    if(tcb == NULL)
     {
-        queue->send_waiting_tasks[queue->send_waiting_count++] = task_id;
+        return false;
     }
-    else if(!is_sender && queue->receive_waiting_count < MAX_TASKS)
+    
+    *(uint8_t*)tcb->wait_data = member;
+    task_wake_blocked(tcb, RTOS_SUCCESS);
+    
+    return true;
+}
+
+/**
+ * @brief Wake every task on a wait list with an error
+ * @note Caller holds a critical section
+ */
+static void wait_list_cancel(task_wait_list_t* wait_list)
+{
+    /* Waking a task unlinks it, so the head advances each time */
+    while(wait_list->head != NULL)
     {
-        queue->receive_waiting_tasks[queue->receive_waiting_count++] = task_id;
+        task_wake_blocked(wait_list->head, RTOS_ERROR);
     }
 }
 
 /**
- * @brief Remove task from queue waiting list
+ * @brief Check whether the caller may block for the given timeout
+ * @note ISRs, the idle path before the scheduler runs and a locked scheduler
+ *       cannot switch away, so they always get the non-blocking result
  */
-static void queue_remove_waiting_task(uint8_t queue_id, uint8_t task_id, bool is_sender)
+static bool wait_can_block(uint32_t timeout_ms)
 {
-    queue_t* queue = &queues[queue_id];
+    return timeout_ms != 0 &&
+           task_get_current() != NULL &&
+           scheduler_is_running() &&
+           !scheduler_is_locked() &&
+           !cortex_m_in_interrupt();
+}
+
+/**
+ * @brief Convert a millisecond timeout to delay list ticks
+ */
+static uint32_t wait_timeout_ticks(uint32_t timeout_ms)
+{
+    if(timeout_ms == QUEUE_TIMEOUT_INFINITE)
+    {
+        return TASK_WAIT_FOREVER;
+    }
     
-    if(is_sender)
+    uint32_t ticks = timer_ms_to_ticks(timeout_ms);
+    
+    return (ticks > 0) ? ticks : 1;
+}
+
+/**
+ * @brief Get address of a slot in the queue buffer
+ */
+static uint8_t* queue_slot(const queue_t* queue, uint32_t index)
+{
+    return queue->buffer + index * queue->slot_size;
+}
+
+/**
+ * @brief Append count items at the tail (caller checked the space)
+ * @note Caller holds a critical section. Unpadded slots are copied as at
+ *       most two runs, split at the ring wrap point.
+ */
+static void queue_copy_in(queue_t* queue, const uint8_t* items, uint32_t count)
+{
+    if(queue->slot_size == queue->item_size)
     {
-        for(int i = 0; i < queue->send_waiting_count; i++)
+        uint32_t first = queue->size - queue->tail;
+        
+        if(first > count)
         {
-            if(queue->send_waiting_tasks[i] == task_id)
-            {
-                /* Shift remaining tasks */
-                for(int j = i; j < queue->send_waiting_count - 1; j++)
-                {
-                    queue->send_waiting_tasks[j] = queue->send_waiting_tasks[j + 1];
-                }
-                queue->send_waiting_count--;
-                break;
-            }
+            first = count;
         }
+        
+        memcpy(queue_slot(queue, queue->tail), items, first * queue->item_size);
+        memcpy(queue->buffer, items + first * queue->item_size, (count - first) * queue->item_size);
     }
     else
     {
-        for(int i = 0; i < queue->receive_waiting_count; i++)
+        for(uint32_t i = 0; i < count; i++)
         {
-            if(queue->receive_waiting_tasks[i] == task_id)
+            uint32_t index = queue->tail + i;
+            
+            if(index >= queue->size)
             {
-                /* Shift remaining tasks */
-                for(int j = i; j < queue->receive_waiting_count - 1; j++)
-                {
-                    queue->receive_waiting_tasks[j] = queue->receive_waiting_tasks[j + 1];
-                }
-                queue->receive_waiting_count--;
-                break;
+                index -= queue->size;
             }
+            
+            memcpy(queue_slot(queue, index), items + i * queue->item_size, queue->item_size);
         }
     }
+    
+    queue->tail += count;
+    if(queue->tail >= queue->size)
+    {
+        queue->tail -= queue->size;
+    }
+    queue->count += count;
 }
 
 /**
- * @brief Wake up waiting task from queue
+ * @brief Remove count items from the head (caller checked the count)
+ * @note Caller holds a critical section. Unpadded slots are copied as at
+ *       most two runs, split at the ring wrap point.
  */
-static void queue_wake_waiting_task(uint8_t queue_id, bool is_sender)
+static void queue_copy_out(queue_t* queue, uint8_t* items, uint32_t count)
 {
-    queue_t* queue = &queues[queue_id];
-    
-    if(is_sender && queue->send_waiting_count > 0)
+    if(queue->slot_size == queue->item_size)
+    {
+        uint32_t first = queue->size - queue->head;
+        
+        if(first > count)
+        {
+            first = count;
+        }
+        
+        memcpy(items, queue_slot(queue, queue->head), first * queue->item_size);
+        memcpy(items + first * queue->item_size, queue->buffer, (count - first) * queue->item_size);
+    }
+    else
     {
-        uint8_t task_id = queue->send_waiting_tasks[0];
-        queue_remove_waiting_task(queue_id, task_id, true);
-        task_set_state(task_id, TASK_STATE_READY);
+        for(uint32_t i = 0; i < count; i++)
+        {
+            uint32_t index = queue->head + i;
+            
+            if(index >= queue->size)
+            {
+                index -= queue->size;
+            }
+            
+            memcpy(items + i * queue->item_size, queue_slot(queue, index), queue->item_size);
+        }
     }
-    else if(!is_sender && queue->receive_waiting_count > 0)
+    
+    queue->head += count;
+    if(queue->head >= queue->size)
     {
-        uint8_t task_id = queue->receive_waiting_tasks[0];
-        queue_remove_waiting_task(queue_id, task_id, false);
-        task_set_state(task_id, TASK_STATE_READY);
+        queue->head -= queue->size;
     }
+    queue->count -= count;
 }
 
 /**
- * @brief Add task to semaphore waiting list
+ * @brief Publish one item to an SPSC ring (producer side)
  */
-static void semaphore_add_waiting_task(uint8_t semaphore_id, uint8_t task_id)
+static queue_result_t spsc_push(spsc_ring_t* ring, const void* data, bool* task_woken)
 {
-    semaphore_t* sem = &semaphores[semaphore_id];
+    uint32_t tail = ring->tail;
+    
+    /* Unsigned difference stays correct across index wrap-around */
+    if(tail - ring->head > ring->mask)
+    {
+        return QUEUE_FULL;
+    }
     
-    if(sem->waiting_count < MAX_TASKS)
+    memcpy(ring->buffer + (tail & ring->mask) * ring->item_size, data, ring->item_size);
+    
+    /* Item must be visible before the index that publishes it */
+    __DMB();
+    ring->tail = tail + 1;
+    
+    /* Publish before looking for a sleeper (pairs with spsc_receive_wait) */
+    __DMB();
+    
+    if(ring->waiting_task != NULL)
     {
-        sem->waiting_tasks[sem->waiting_count++] = task_id;
+        ENTER_CRITICAL();
+        
+        tcb_t* tcb = ring->waiting_task;
+        ring->waiting_task = NULL;
+        
+        if(tcb != NULL)
+        {
+            task_wake_blocked(tcb, QUEUE_SUCCESS);
+            *task_woken = true;
+        }
+        
+        EXIT_CRITICAL();
     }
+    
+    return QUEUE_SUCCESS;
 }
 
 /**
- * @brief Remove task from semaphore waiting list
+ * @brief Set up an SPSC ring, allocating its buffer unless one is given
  */
-static void semaphore_remove_waiting_task(uint8_t semaphore_id, uint8_t task_id)
+static queue_result_t spsc_init_ring(uint8_t ring_id, uint32_t size, uint32_t item_size, void* buffer)
 {
-    semaphore_t* sem = &semaphores[semaphore_id];
+    if(!queue_manager_initialized || ring_id >= MAX_SPSC_RINGS || item_size == 0)
+    {
+        return QUEUE_ERROR;
+    }
     
-    for(int i = 0; i < sem->waiting_count; i++)
+    /* Power-of-two size lets the free-running indices wrap with a mask */
+    if(size < 2 || size > SPSC_MAX_SIZE || (size & (size - 1)) != 0 ||
+       item_size > 0xFFFFFFFF / SPSC_MAX_SIZE)
     {
-        if(sem->waiting_tasks[i] == task_id)
-        {
-            /* Shift remaining tasks */
-            for(int j = i; j < sem->waiting_count - 1; j++)
-            {
-                sem->waiting_tasks[j] = sem->waiting_tasks[j + 1];
-            }
-            sem->waiting_count--;
-            break;
-        }
+        return QUEUE_ERROR;
+    }
+    
+    spsc_ring_t* ring = &spsc_rings[ring_id];
+    
+    if(ring->is_active)
+    {
+        return QUEUE_ERROR; /* Ring already exists */
+    }
+    
+    /* Allocate buffer */
+    ring->owns_buffer = (buffer == NULL);
+    ring->buffer = (buffer != NULL) ? (uint8_t*)buffer : (uint8_t*)memory_alloc_prefer(MEMORY_REGION_ATTR_FAST, size * item_size);
+    if(ring->buffer == NULL)
+    {
+        return QUEUE_ERROR;
     }
+    
+    /* Initialize ring */
+    ring->item_size = item_size;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->waiting_task = NULL;
+    ring->is_active = true;
+    
+    DEBUG_PRINT("SPSC ring %d created with size %u (%u byte items)\n", ring_id, size, item_size);
+    
+    return QUEUE_SUCCESS;
 }
 
 /**
- * @brief Wake up waiting task from semaphore
+ * @brief Take one item from an SPSC ring (consumer side)
  */
-static void semaphore_wake_waiting_task(uint8_t semaphore_id)
+static queue_result_t spsc_pop(spsc_ring_t* ring, void* data)
 {
-    semaphore_t* sem = &semaphores[semaphore_id];
+    uint32_t head = ring->head;
     
-    if(sem->waiting_count > 0)
+    if(head == ring->tail)
     {
-        uint8_t task_id = sem->waiting_tasks[0];
-        semaphore_remove_waiting_task(semaphore_id, task_id);
-        task_set_state(task_id, TASK_STATE_READY);
+        return QUEUE_EMPTY;
     }
+    
+    /* Read the item only after observing the index that published it */
+    __DMB();
+    memcpy(data, ring->buffer + (head & ring->mask) * ring->item_size, ring->item_size);
+    
+    /* Finish reading before handing the slot back to the producer */
+    __DMB();
+    ring->head = head + 1;
+    
+    return QUEUE_SUCCESS;
 }
\ No newline at end of file
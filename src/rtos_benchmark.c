@@ -0,0 +1,488 @@
+/**
+ * @file rtos_benchmark.c
+ * @brief Kernel Micro-Benchmark Implementation
+ * @author Team Member 6 - System Integration
+ * @date 2024
+ *
+ * Every sample is one DWT CYCCNT difference minus the cost of reading the
+ * counter itself. Partner tasks share BENCHMARK_PRIORITY with the benchmark
+ * task, so nothing else runs while a sample is open (SysTick aside).
+ */
+
+#include "rtos_benchmark.h"
+#include "task_manager.h"
+#include "scheduler.h"
+#include "queue_manager.h"
+#include "memory_manager.h"
+#include "timer_manager.h"
+#include "arm_cortex_m.h"
+
+#if RTOS_USE_BENCHMARKS
+
+#if RTOS_PORT_POSIX
+#define BENCHMARK_PRINT(...)        printf(__VA_ARGS__)
+#else
+#define BENCHMARK_PRINT(...)        DEBUG_PRINT(__VA_ARGS__)
+#endif
+
+/* ============================================================================
+ * GLOBAL VARIABLES
+ * ============================================================================ */
+benchmark_result_t rtos_benchmark_results[BENCHMARK_COUNT] = {
+    { "context switch",      0, 0, 0, 0, 0 },
+    { "scheduler_tick",      0, 0, 0, 0, 0 },
+    { "memory_alloc (frag)", 0, 0, 0, 0, 0 },
+    { "memory_free (frag)",  0, 0, 0, 0, 0 },
+    { "queue round trip",    0, 0, 0, 0, 0 },
+    { "semaphore ping-pong", 0, 0, 0, 0, 0 },
+    { "timer tick",          0, 0, 0, 0, 0 }
+};
+
+volatile bool rtos_benchmark_done = false;
+
+static uint32_t counter_overhead = 0;   /* Cycles of a back-to-back CYCCNT read */
+static uint32_t random_state = 1;       /* Heap benchmark size sequence */
+
+/* ============================================================================
+ * PRIVATE FUNCTION PROTOTYPES
+ * ============================================================================ */
+static void benchmark_task(void);
+static void benchmark_calibrate(void);
+static void benchmark_record(benchmark_id_t id, uint32_t cycles);
+static void benchmark_context_switch(void);
+static void benchmark_scheduler_tick(void);
+static void benchmark_memory(void);
+static void benchmark_queue(void);
+static uint32_t benchmark_random_size(void);
+static void yield_partner_task(void);
+#if RTOS_USE_SEMAPHORES
+static void benchmark_semaphore(void);
+static void semaphore_partner_task(void);
+#endif
+#if RTOS_USE_TIMERS
+static void benchmark_timers(void);
+static void benchmark_timer_callback(uint8_t timer_id, void* user_data);
+#endif
+
+/* ============================================================================
+ * PUBLIC FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Create the benchmark task
+ */
+rtos_result_t rtos_benchmark_start(void)
+{
+    for(int i = 0; i < BENCHMARK_COUNT; i++)
+    {
+        rtos_benchmark_results[i].load = 0;
+        rtos_benchmark_results[i].iterations = 0;
+        rtos_benchmark_results[i].min_cycles = 0xFFFFFFFF;
+        rtos_benchmark_results[i].max_cycles = 0;
+        rtos_benchmark_results[i].total_cycles = 0;
+    }
+    rtos_benchmark_done = false;
+    
+    if(task_create(benchmark_task, "Benchmark", BENCHMARK_PRIORITY, BENCHMARK_STACK_SIZE) == 0xFF)
+    {
+        return RTOS_ERROR;
+    }
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Get one benchmark's result
+ */
+const benchmark_result_t* rtos_benchmark_get_result(benchmark_id_t id)
+{
+    if(id >= BENCHMARK_COUNT)
+    {
+        return NULL;
+    }
+    
+    return &rtos_benchmark_results[id];
+}
+
+/**
+ * @brief Convert cycle counter ticks to nanoseconds
+ */
+uint32_t rtos_benchmark_cycles_to_ns(uint32_t cycles)
+{
+    uint64_t ns = (uint64_t)cycles * 1000000000ULL / CORTEX_M_CYCLE_HZ;
+    
+    return (ns > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)ns;
+}
+
+/**
+ * @brief Print every result
+ */
+void rtos_benchmark_print(void)
+{
+    BENCHMARK_PRINT("=== Kernel Benchmarks (%lu Hz counter) ===\n", (unsigned long)CORTEX_M_CYCLE_HZ);
+    BENCHMARK_PRINT("%-20s %5s %6s %8s %8s %8s %8s\n",
+                    "benchmark", "load", "runs", "min", "mean", "max", "mean ns");
+    
+    for(int i = 0; i < BENCHMARK_COUNT; i++)
+    {
+        const benchmark_result_t* result = &rtos_benchmark_results[i];
+        
+        if(result->iterations == 0)
+        {
+            BENCHMARK_PRINT("%-20s (not run)\n", result->name);
+            continue;
+        }
+        
+        uint32_t mean = (uint32_t)(result->total_cycles / result->iterations);
+        
+        BENCHMARK_PRINT("%-20s %5u %6u %8u %8u %8u %8u\n",
+                        result->name, result->load, result->iterations,
+                        result->min_cycles, mean, result->max_cycles,
+                        rtos_benchmark_cycles_to_ns(mean));
+    }
+}
+
+/* ============================================================================
+ * PRIVATE FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Benchmark task: run every benchmark once, report, then go away
+ */
+static void benchmark_task(void)
+{
+    benchmark_calibrate();
+    
+    benchmark_context_switch();
+    benchmark_scheduler_tick();
+    benchmark_memory();
+    benchmark_queue();
+#if RTOS_USE_SEMAPHORES
+    benchmark_semaphore();
+#endif
+#if RTOS_USE_TIMERS
+    benchmark_timers();
+#endif
+    
+    rtos_benchmark_done = true;
+    rtos_benchmark_print();
+    
+#if RTOS_PORT_POSIX
+    cortex_m_host_exit(0);
+#endif
+    
+    task_delete(task_get_current()->task_id);
+}
+
+/**
+ * @brief Measure the cost of reading the counter, subtracted from every sample
+ */
+static void benchmark_calibrate(void)
+{
+    counter_overhead = 0xFFFFFFFF;
+    
+    for(int i = 0; i < 16; i++)
+    {
+        uint32_t start = DWT_CYCCNT_REG;
+        uint32_t cycles = DWT_CYCCNT_REG - start;
+        
+        if(cycles < counter_overhead)
+        {
+            counter_overhead = cycles;
+        }
+    }
+}
+
+/**
+ * @brief Add one sample to a result
+ */
+static void benchmark_record(benchmark_id_t id, uint32_t cycles)
+{
+    benchmark_result_t* result = &rtos_benchmark_results[id];
+    
+    cycles = (cycles > counter_overhead) ? cycles - counter_overhead : 0;
+    
+    result->iterations++;
+    result->total_cycles += cycles;
+    
+    if(cycles < result->min_cycles)
+    {
+        result->min_cycles = cycles;
+    }
+    
+    if(cycles > result->max_cycles)
+    {
+        result->max_cycles = cycles;
+    }
+}
+
+/**
+ * @brief Yield to an equal-priority partner and back (two switches per sample)
+ */
+static void benchmark_context_switch(void)
+{
+    uint8_t partner = task_create(yield_partner_task, "BenchYield", BENCHMARK_PRIORITY, BENCHMARK_STACK_SIZE);
+    
+    if(partner == 0xFF)
+    {
+        return;
+    }
+    
+    /* Let the partner reach its loop first */
+    scheduler_yield();
+    
+    rtos_benchmark_results[BENCHMARK_CONTEXT_SWITCH].load = 2;
+    
+    for(uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        uint32_t start = DWT_CYCCNT_REG;
+        scheduler_yield();
+        uint32_t cycles = DWT_CYCCNT_REG - start;
+        
+        benchmark_record(BENCHMARK_CONTEXT_SWITCH, cycles / 2);
+    }
+    
+    task_delete(partner);
+}
+
+/**
+ * @brief Time scheduler_tick() as the SysTick handler would run it
+ */
+static void benchmark_scheduler_tick(void)
+{
+    rtos_benchmark_results[BENCHMARK_SCHEDULER_TICK].load = task_get_count();
+    
+    for(uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        ENTER_CRITICAL();
+        
+        uint32_t start = DWT_CYCCNT_REG;
+        scheduler_tick();
+        uint32_t cycles = DWT_CYCCNT_REG - start;
+        
+        EXIT_CRITICAL();
+        
+        benchmark_record(BENCHMARK_SCHEDULER_TICK, cycles);
+    }
+}
+
+/**
+ * @brief Time alloc/free of random sizes while a ring of live blocks keeps
+ *        the heap fragmented
+ */
+static void benchmark_memory(void)
+{
+    void* blocks[BENCHMARK_HEAP_BLOCKS];
+    
+    /* Fill, then punch holes: every other block is freed */
+    random_state = 1;
+    for(int i = 0; i < BENCHMARK_HEAP_BLOCKS; i++)
+    {
+        blocks[i] = memory_alloc(benchmark_random_size());
+    }
+    for(int i = 0; i < BENCHMARK_HEAP_BLOCKS; i += 2)
+    {
+        memory_free(blocks[i]);
+        blocks[i] = NULL;
+    }
+    
+    rtos_benchmark_results[BENCHMARK_MEMORY_ALLOC].load = BENCHMARK_HEAP_BLOCKS;
+    rtos_benchmark_results[BENCHMARK_MEMORY_FREE].load = BENCHMARK_HEAP_BLOCKS;
+    
+    /* Replace the oldest block each round */
+    for(uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        void** slot = &blocks[i % BENCHMARK_HEAP_BLOCKS];
+        uint32_t size = benchmark_random_size();
+        
+        if(*slot != NULL)
+        {
+            uint32_t start = DWT_CYCCNT_REG;
+            memory_free(*slot);
+            uint32_t cycles = DWT_CYCCNT_REG - start;
+            
+            benchmark_record(BENCHMARK_MEMORY_FREE, cycles);
+        }
+        
+        uint32_t start = DWT_CYCCNT_REG;
+        *slot = memory_alloc(size);
+        uint32_t cycles = DWT_CYCCNT_REG - start;
+        
+        /* A failed allocation is timed too: it walks the same free lists */
+        benchmark_record(BENCHMARK_MEMORY_ALLOC, cycles);
+    }
+    
+    for(int i = 0; i < BENCHMARK_HEAP_BLOCKS; i++)
+    {
+        if(blocks[i] != NULL)
+        {
+            memory_free(blocks[i]);
+        }
+    }
+}
+
+/**
+ * @brief Time a send immediately followed by a receive on an idle queue
+ */
+static void benchmark_queue(void)
+{
+    if(queue_create_sized(BENCHMARK_QUEUE_ID, 1, sizeof(uint32_t)) != QUEUE_SUCCESS)
+    {
+        return;
+    }
+    
+    rtos_benchmark_results[BENCHMARK_QUEUE_ROUND_TRIP].load = 1;
+    
+    for(uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        uint32_t item = i;
+        
+        uint32_t start = DWT_CYCCNT_REG;
+        queue_send(BENCHMARK_QUEUE_ID, &item, 0);
+        queue_receive(BENCHMARK_QUEUE_ID, &item, 0);
+        uint32_t cycles = DWT_CYCCNT_REG - start;
+        
+        benchmark_record(BENCHMARK_QUEUE_ROUND_TRIP, cycles);
+    }
+    
+    queue_delete(BENCHMARK_QUEUE_ID);
+}
+
+/**
+ * @brief Next size of the heap benchmark's LCG sequence
+ */
+static uint32_t benchmark_random_size(void)
+{
+    random_state = random_state * 1103515245 + 12345;
+    
+    return BENCHMARK_HEAP_MIN_SIZE +
+           (random_state >> 16) % (BENCHMARK_HEAP_MAX_SIZE - BENCHMARK_HEAP_MIN_SIZE + 1);
+}
+
+/**
+ * @brief Context switch partner: hand the CPU straight back
+ */
+static void yield_partner_task(void)
+{
+    while(1)
+    {
+        scheduler_yield();
+    }
+}
+
+#if RTOS_USE_SEMAPHORES
+/**
+ * @brief Give ping, block on pong: two blocking handoffs per sample
+ */
+static void benchmark_semaphore(void)
+{
+    if(semaphore_create(BENCHMARK_PING_SEMAPHORE, 0, 1) != RTOS_SUCCESS)
+    {
+        return;
+    }
+    
+    if(semaphore_create(BENCHMARK_PONG_SEMAPHORE, 0, 1) != RTOS_SUCCESS)
+    {
+        semaphore_delete(BENCHMARK_PING_SEMAPHORE);
+        return;
+    }
+    
+    uint8_t partner = task_create(semaphore_partner_task, "BenchPong", BENCHMARK_PRIORITY, BENCHMARK_STACK_SIZE);
+    
+    if(partner != 0xFF)
+    {
+        /* Let the partner block on ping first */
+        scheduler_yield();
+        
+        rtos_benchmark_results[BENCHMARK_SEMAPHORE_PING_PONG].load = 2;
+        
+        for(uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+        {
+            uint32_t start = DWT_CYCCNT_REG;
+            semaphore_give(BENCHMARK_PING_SEMAPHORE);
+            semaphore_take(BENCHMARK_PONG_SEMAPHORE, QUEUE_TIMEOUT_INFINITE);
+            uint32_t cycles = DWT_CYCCNT_REG - start;
+            
+            benchmark_record(BENCHMARK_SEMAPHORE_PING_PONG, cycles);
+        }
+        
+        /* Partner is blocked on ping again: delete it before its semaphores */
+        task_delete(partner);
+    }
+    
+    semaphore_delete(BENCHMARK_PONG_SEMAPHORE);
+    semaphore_delete(BENCHMARK_PING_SEMAPHORE);
+}
+
+/**
+ * @brief Semaphore partner: answer every ping with a pong
+ */
+static void semaphore_partner_task(void)
+{
+    while(1)
+    {
+        if(semaphore_take(BENCHMARK_PING_SEMAPHORE, QUEUE_TIMEOUT_INFINITE) == RTOS_SUCCESS)
+        {
+            semaphore_give(BENCHMARK_PONG_SEMAPHORE);
+        }
+    }
+}
+#endif /* RTOS_USE_SEMAPHORES */
+
+#if RTOS_USE_TIMERS
+/**
+ * @brief Time the tick handler with every free software timer armed
+ * @note Each sample advances the system tick, like a real SysTick
+ */
+static void benchmark_timers(void)
+{
+    uint8_t timers[MAX_SOFTWARE_TIMERS];
+    uint32_t armed = 0;
+    
+    /* Stagger the periods so the timers spread over the wheel */
+    while(armed < MAX_SOFTWARE_TIMERS)
+    {
+        uint8_t timer_id = timer_create(TIMER_TYPE_ONE_SHOT, BENCHMARK_TIMER_PERIOD_MS + armed * 97,
+                                        benchmark_timer_callback, NULL);
+        
+        if(timer_id == TIMER_INVALID_ID)
+        {
+            break;
+        }
+        
+        timer_start_timer(timer_id);
+        timers[armed++] = timer_id;
+    }
+    
+    rtos_benchmark_results[BENCHMARK_TIMER_TICK].load = armed;
+    
+    for(uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        ENTER_CRITICAL();
+        
+        uint32_t start = DWT_CYCCNT_REG;
+        timer_interrupt_handler();
+        uint32_t cycles = DWT_CYCCNT_REG - start;
+        
+        EXIT_CRITICAL();
+        
+        benchmark_record(BENCHMARK_TIMER_TICK, cycles);
+    }
+    
+    for(uint32_t i = 0; i < armed; i++)
+    {
+        timer_delete(timers[i]);
+    }
+}
+
+/**
+ * @brief Callback for the armed timers (never expected to run)
+ */
+static void benchmark_timer_callback(uint8_t timer_id, void* user_data)
+{
+    UNUSED(timer_id);
+    UNUSED(user_data);
+}
+#endif /* RTOS_USE_TIMERS */
+
+#endif /* RTOS_USE_BENCHMARKS */
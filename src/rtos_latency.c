@@ -0,0 +1,238 @@
+/**
+ * @file rtos_latency.c
+ * @brief Interrupt and Critical-Section Latency Instrumentation Implementation
+ * @author Team Member 6 - System Integration
+ * @date 2024
+ * 
+ * Called from inside ENTER_CRITICAL()/EXIT_CRITICAL(), so nothing here may
+ * use those macros itself.
+ */
+
+#include "rtos_latency.h"
+#include "arm_cortex_m.h"
+
+/* ============================================================================
+ * GLOBAL VARIABLES
+ * ============================================================================ */
+latency_site_t rtos_latency_systick = LATENCY_SITE_INIT("SysTick_Handler", 0);
+latency_site_t rtos_latency_pendsv = LATENCY_SITE_INIT("PendSV_Handler", 0);
+
+#if RTOS_USE_LATENCY_STATS
+static latency_site_t* site_list = NULL;                /* Registered sites */
+static latency_site_t** site_list_tail = &site_list;    /* Append point */
+static latency_site_t* active_site = NULL;              /* Critical section being timed */
+#endif
+
+/* ============================================================================
+ * PRIVATE FUNCTION PROTOTYPES
+ * ============================================================================ */
+#if RTOS_USE_LATENCY_STATS
+static void latency_register(latency_site_t* site);
+static void latency_record(latency_site_t* site, uint32_t cycles);
+static void latency_clear(latency_site_t* site);
+#endif
+
+/* ============================================================================
+ * PUBLIC FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Register the handler sites (scheduler_init() has started the cycle counter)
+ */
+void rtos_latency_init(void)
+{
+#if RTOS_USE_LATENCY_STATS
+    uint32_t basepri = cortex_m_raise_basepri();
+    
+    latency_register(&rtos_latency_systick);
+    latency_register(&rtos_latency_pendsv);
+    
+    cortex_m_set_basepri(basepri);
+#endif
+}
+
+#if RTOS_USE_LATENCY_STATS
+/**
+ * @brief Start timing a critical section
+ */
+void rtos_latency_critical_enter(latency_site_t* site, bool outermost)
+{
+    if(!site->registered)
+    {
+        latency_register(site);
+    }
+    
+    if(outermost)
+    {
+        site->start_cycles = DWT_CYCCNT_REG;
+        active_site = site;
+    }
+}
+
+/**
+ * @brief Stop timing the active critical section
+ */
+void rtos_latency_critical_exit(bool outermost)
+{
+    latency_site_t* site = active_site;
+    
+    if(outermost && site != NULL)
+    {
+        latency_record(site, DWT_CYCCNT_REG - site->start_cycles);
+        active_site = NULL;
+    }
+}
+
+/**
+ * @brief Start timing a handler
+ */
+void rtos_latency_isr_enter(latency_site_t* site)
+{
+    site->start_cycles = DWT_CYCCNT_REG;
+}
+
+/**
+ * @brief Stop timing a handler and record the duration
+ */
+void rtos_latency_isr_exit(latency_site_t* site)
+{
+    uint32_t cycles = DWT_CYCCNT_REG - site->start_cycles;
+    
+    /* Histograms are shared with critical sections in other contexts */
+    uint32_t basepri = cortex_m_raise_basepri();
+    
+    latency_record(site, cycles);
+    
+    cortex_m_set_basepri(basepri);
+}
+#endif
+
+/**
+ * @brief Close the PendSV measurement
+ */
+void rtos_latency_pendsv_exit(void)
+{
+#if RTOS_USE_LATENCY_STATS
+    latency_record(&rtos_latency_pendsv, DWT_CYCCNT_REG - rtos_latency_pendsv.start_cycles);
+#endif
+}
+
+/**
+ * @brief Get the registered sites
+ */
+const latency_site_t* rtos_latency_get_sites(void)
+{
+#if RTOS_USE_LATENCY_STATS
+    return site_list;
+#else
+    return NULL;
+#endif
+}
+
+/**
+ * @brief Clear the counters and histograms of every registered site
+ */
+void rtos_latency_reset(void)
+{
+#if RTOS_USE_LATENCY_STATS
+    uint32_t basepri = cortex_m_raise_basepri();
+    
+    for(latency_site_t* site = site_list; site != NULL; site = site->next)
+    {
+        latency_clear(site);
+    }
+    
+    cortex_m_set_basepri(basepri);
+#endif
+}
+
+/**
+ * @brief Print every site's histogram (for debugging)
+ */
+void rtos_latency_print_info(void)
+{
+    DEBUG_PRINT("=== Latency (cycles) ===\n");
+    
+    for(const latency_site_t* site = rtos_latency_get_sites(); site != NULL; site = site->next)
+    {
+        if(site->count == 0)
+        {
+            continue;
+        }
+        
+        DEBUG_PRINT("%s:%u  n=%u min=%u max=%u avg=%u\n", site->name, site->line, site->count,
+                   site->min_cycles, site->max_cycles, (uint32_t)(site->total_cycles / site->count));
+        
+        for(int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+        {
+            if(site->histogram[i] != 0)
+            {
+                DEBUG_PRINT("  >= %u: %u\n", 1UL << i, site->histogram[i]);
+            }
+        }
+    }
+}
+
+/* ============================================================================
+ * PRIVATE FUNCTIONS
+ * ============================================================================ */
+
+#if RTOS_USE_LATENCY_STATS
+/**
+ * @brief Append a site to the site list
+ * @note Caller has kernel interrupts masked
+ */
+static void latency_register(latency_site_t* site)
+{
+    if(site->registered)
+    {
+        return;
+    }
+    
+    site->next = NULL;
+    site->registered = true;
+    *site_list_tail = site;
+    site_list_tail = &site->next;
+}
+
+/**
+ * @brief Add one duration to a site's statistics
+ * @note Caller has kernel interrupts masked
+ */
+static void latency_record(latency_site_t* site, uint32_t cycles)
+{
+    site->count++;
+    site->total_cycles += cycles;
+    
+    if(cycles < site->min_cycles)
+    {
+        site->min_cycles = cycles;
+    }
+    
+    if(cycles > site->max_cycles)
+    {
+        site->max_cycles = cycles;
+    }
+    
+    /* Bucket = position of the highest set bit */
+    uint32_t bucket = (cycles != 0) ? (31 - __CLZ(cycles)) : 0;
+    if(bucket >= LATENCY_HISTOGRAM_BUCKETS)
+    {
+        bucket = LATENCY_HISTOGRAM_BUCKETS - 1;
+    }
+    
+    site->histogram[bucket]++;
+}
+
+/**
+ * @brief Zero a site's statistics
+ */
+static void latency_clear(latency_site_t* site)
+{
+    site->count = 0;
+    site->min_cycles = 0xFFFFFFFF;
+    site->max_cycles = 0;
+    site->total_cycles = 0;
+    memset(site->histogram, 0, sizeof(site->histogram));
+}
+#endif
@@ -0,0 +1,134 @@
+/**
+ * @file rtos_trace.c
+ * @brief Binary Event Trace Implementation
+ * @author Team Member 6 - System Integration
+ * @date 2024
+ * 
+ * Each event is one 8-byte record written with kernel interrupts briefly
+ * masked; no formatting happens on the target.
+ */
+
+#include "rtos_trace.h"
+#include "scheduler.h"
+#include "arm_cortex_m.h"
+
+/* ============================================================================
+ * GLOBAL VARIABLES
+ * ============================================================================ */
+trace_record_t rtos_trace_buffer[RTOS_TRACE_BUFFER_SIZE];  /* Event ring */
+volatile uint32_t rtos_trace_count = 0;                     /* Events recorded */
+
+/* ============================================================================
+ * PRIVATE FUNCTION PROTOTYPES
+ * ============================================================================ */
+#if RTOS_TRACE_USE_ITM
+static void rtos_trace_stream(const trace_record_t* record);
+#endif
+
+/* ============================================================================
+ * PUBLIC FUNCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Clear the trace ring (scheduler_init() has started the cycle counter)
+ */
+void rtos_trace_init(void)
+{
+    memset(rtos_trace_buffer, 0, sizeof(rtos_trace_buffer));
+    rtos_trace_count = 0;
+}
+
+/**
+ * @brief Record one event
+ */
+void rtos_trace_record(uint8_t event, uint16_t arg)
+{
+    /* Save/restore BASEPRI rather than ENTER_CRITICAL: PendSV records with
+     * BASEPRI raised but the nesting count at zero */
+    uint32_t basepri = cortex_m_raise_basepri();
+    
+    trace_record_t* record = &rtos_trace_buffer[rtos_trace_count & (RTOS_TRACE_BUFFER_SIZE - 1)];
+    tcb_t* current = scheduler_current_tcb;
+    
+    record->timestamp = DWT_CYCCNT_REG;
+    record->event = event;
+    record->task_id = (current != NULL) ? current->task_id : 0xFF;
+    record->arg = arg;
+    rtos_trace_count++;
+    
+#if RTOS_TRACE_USE_ITM
+    rtos_trace_stream(record);
+#endif
+    
+    cortex_m_set_basepri(basepri);
+}
+
+/**
+ * @brief Record an ISR enter/exit event for the active exception
+ */
+void rtos_trace_isr(uint8_t event)
+{
+    rtos_trace_record(event, (uint16_t)(NVIC_INT_CTRL_REG & NVIC_VECTACTIVE_MASK));
+}
+
+/**
+ * @brief Copy recorded events out, oldest first
+ */
+uint32_t rtos_trace_read(trace_record_t* records, uint32_t max_records)
+{
+    if(records == NULL || max_records == 0)
+    {
+        return 0;
+    }
+    
+    ENTER_CRITICAL();
+    
+    uint32_t count = rtos_trace_count;
+    uint32_t available = (count < RTOS_TRACE_BUFFER_SIZE) ? count : RTOS_TRACE_BUFFER_SIZE;
+    uint32_t copied = (available < max_records) ? available : max_records;
+    uint32_t first = count - available;
+    
+    for(uint32_t i = 0; i < copied; i++)
+    {
+        records[i] = rtos_trace_buffer[(first + i) & (RTOS_TRACE_BUFFER_SIZE - 1)];
+    }
+    
+    EXIT_CRITICAL();
+    
+    return copied;
+}
+
+/* ============================================================================
+ * PRIVATE FUNCTIONS
+ * ============================================================================ */
+
+#if RTOS_TRACE_USE_ITM
+/**
+ * @brief Push a record out of the ITM stimulus port (SWO)
+ * @note Dropped if no debugger enabled the port or its FIFO is busy on the
+ *       first word; the RAM ring still holds the event
+ */
+static void rtos_trace_stream(const trace_record_t* record)
+{
+    if((ITM_TCR_REG & ITM_TCR_ITMENA) == 0 || (ITM_TER_REG & (1UL << RTOS_TRACE_ITM_PORT)) == 0)
+    {
+        return;
+    }
+    
+    const uint32_t* words = (const uint32_t*)record;
+    
+    if(ITM_PORT_REG(RTOS_TRACE_ITM_PORT) == 0)
+    {
+        return; /* FIFO busy */
+    }
+    
+    ITM_PORT_REG(RTOS_TRACE_ITM_PORT) = words[0];
+    
+    /* Never split a record on the wire */
+    while(ITM_PORT_REG(RTOS_TRACE_ITM_PORT) == 0)
+    {
+    }
+    
+    ITM_PORT_REG(RTOS_TRACE_ITM_PORT) = words[1];
+}
+#endif
@@ -10,23 +10,45 @@
 
 #include "scheduler.h"
 #include "timer_manager.h"
+#include "arm_cortex_m.h"
+#include "rtos_trace.h"
+#include "rtos_latency.h"
+
+#if SCHEDULER_PRIORITY_LEVELS > 32
+#error "SCHEDULER_PRIORITY_LEVELS must fit in the 32-bit ready bitmap"
+#endif
 
 /* ============================================================================
  * GLOBAL VARIABLES
  * ============================================================================ */
 static tcb_t* ready_queues[SCHEDULER_PRIORITY_LEVELS];  /* Ready task queues by priority */
+static uint32_t ready_priority_bitmap = 0;             /* Bit n set = ready_queues[n] not empty */
 static bool scheduler_running = false;                 /* Scheduler state */
 static bool scheduler_locked = false;                  /* Scheduler lock state */
 static uint8_t current_priority = 0;                   /* Current executing priority */
 static scheduler_stats_t stats;                        /* Scheduler statistics */
 static uint8_t idle_task_id = 0xFF;                   /* Idle task ID */
+static uint32_t idle_task_stack[TASK_STACK_WORDS(IDLE_STACK_SIZE)]; /* Idle stack (no heap at boot) */
+
+#if RTOS_USE_RUNTIME_STATS
+static uint32_t slice_start_cycles = 0;                /* CYCCNT when the running task was switched in */
+#endif
+
+/* Context switch handoff - accessed by PendSV_Handler (startup_ARMCM3.s) */
+tcb_t* volatile scheduler_current_tcb = NULL;          /* Task whose registers are live */
+tcb_t* volatile scheduler_next_tcb = NULL;             /* Task PendSV switches to */
 
 /* ============================================================================
  * PRIVATE FUNCTION PROTOTYPES
  * ============================================================================ */
 static tcb_t* scheduler_find_highest_priority_task(void);
+#if RTOS_USE_STATS
 static void scheduler_update_statistics(void);
+#endif
 static void scheduler_round_robin_next(uint8_t priority);
+#if RTOS_USE_RUNTIME_STATS
+static void scheduler_reset_task_runtime(void);
+#endif
 
 /* ============================================================================
  * PUBLIC FUNCTIONS
@@ -42,6 +64,7 @@ rtos_result_t scheduler_init(void)
     {
         ready_queues[i] = NULL;
     }
+    ready_priority_bitmap = 0;
     
     /* Initialize state */
     scheduler_running = false;
@@ -51,8 +74,23 @@ rtos_result_t scheduler_init(void)
     /* Initialize statistics */
     memset(&stats, 0, sizeof(scheduler_stats_t));
     
+    scheduler_current_tcb = NULL;
+    scheduler_next_tcb = NULL;
+    
+    /* One time base for trace, latency, runtime and timer statistics */
+    cortex_m_cycle_counter_init();
+    
+#if RTOS_USE_TRACE
+    rtos_trace_init();
+#endif
+    
+#if RTOS_USE_LATENCY_STATS
+    rtos_latency_init();
+#endif
+    
     /* Create idle task */
-    idle_task_id = task_create(scheduler_idle_task, "IDLE", PRIORITY_IDLE, MIN_STACK_SIZE);
+    idle_task_id = task_create_static(scheduler_idle_task, "IDLE", PRIORITY_IDLE,
+                                      idle_task_stack, IDLE_STACK_SIZE);
     
     DEBUG_PRINT("Scheduler initialized\n");
     return RTOS_SUCCESS;
@@ -65,27 +103,38 @@ void scheduler_start(void)
 {
     DEBUG_PRINT("Starting scheduler...\n");
     
-    scheduler_running = true;
+    /* PendSV/SysTick at lowest priority */
+    cortex_m_init();
     
     /* Find first task to run */
     tcb_t* first_task = scheduler_get_next_task();
     
-    if(first_task != NULL)
-    {
-        /* Set first task as running */
-        task_set_state(first_task->task_id, TASK_STATE_RUNNING);
-        
-        DEBUG_PRINT("Scheduler started with first task: %s (ID: %d)\n", first_task->task_name, first_task->task_id);
-    }
-    else
+    if(first_task == NULL)
     {
         DEBUG_PRINT("No tasks ready to run!\n");
+        return;
     }
     
-    /* NOTE: In this simplified implementation, we don't call task functions directly.
-     * Instead, the main loop will repeatedly call scheduler_run_next_task() to execute
-     * each task for one iteration. This allows all tasks to run without getting stuck
-     * in infinite loops. */
+    ENTER_CRITICAL();
+    
+    /* Set first task as running */
+    task_set_state(first_task->task_id, TASK_STATE_RUNNING);
+    
+    /* No current task yet, so PendSV only restores the first frame */
+    scheduler_current_tcb = NULL;
+    scheduler_next_tcb = first_task;
+    scheduler_running = true;
+    
+    DEBUG_PRINT("Scheduler started with first task: %s (ID: %d)\n", first_task->task_name, first_task->task_id);
+    
+    cortex_m_trigger_pendsv();
+    
+    EXIT_CRITICAL();
+    
+    /* PendSV switches to the first task on the PSP; main's stack is abandoned */
+    while(1)
+    {
+    }
 }
 
 /**
@@ -121,11 +170,14 @@ void scheduler_switch_context(void)
         return;
     }
     
+    ENTER_CRITICAL();
+    
     tcb_t* current_task = task_get_current();
     tcb_t* next_task = scheduler_get_next_task();
     
     if(next_task == NULL || next_task == current_task)
     {
+        EXIT_CRITICAL();
         return; /* No switch needed */
     }
     
@@ -139,19 +191,20 @@ void scheduler_switch_context(void)
     /* Set next task as running */
     task_set_state(next_task->task_id, TASK_STATE_RUNNING);
     
+#if RTOS_USE_STATS
     /* Update statistics */
     if(current_task != NULL)
     {
         current_task->context_switches++;
     }
     stats.total_context_switches++;
+#endif
     
-    DEBUG_PRINT("Context switch: %s -> %s\n", 
-               current_task ? current_task->task_name : "NULL",
-               next_task->task_name);
+    /* Register save/restore happens in PendSV once no other ISR is active */
+    scheduler_next_tcb = next_task;
+    cortex_m_trigger_pendsv();
     
-    /* In real implementation, this would save/restore CPU context */
-    /* For simulation, we just update the task states */
+    EXIT_CRITICAL();
 }
 
 /**
@@ -166,6 +219,14 @@ void scheduler_yield(void)
         /* Reset time slice */
         current_task->time_slice_remaining = TIME_SLICE_MS;
         
+        /* Let the next task of the same priority go first */
+        ENTER_CRITICAL();
+        if(ready_queues[current_task->priority] == current_task)
+        {
+            scheduler_round_robin_next(current_task->priority);
+        }
+        EXIT_CRITICAL();
+        
         /* Trigger context switch */
         scheduler_switch_context();
     }
@@ -190,6 +251,7 @@ rtos_result_t scheduler_add_ready_task(tcb_t* tcb)
         ready_queues[priority] = tcb;
         tcb->next = tcb;
         tcb->prev = tcb;
+        ready_priority_bitmap |= (1UL << priority);
     }
     else
     {
@@ -225,6 +287,7 @@ rtos_result_t scheduler_remove_ready_task(tcb_t* tcb)
     {
         /* Only task in queue */
         ready_queues[priority] = NULL;
+        ready_priority_bitmap &= ~(1UL << priority);
     }
     else
     {
@@ -254,7 +317,9 @@ void scheduler_tick(void)
         return;
     }
     
+#if RTOS_USE_STATS
     stats.total_scheduler_calls++;
+#endif
     
     /* Update task delays */
     task_update_delays();
@@ -272,12 +337,17 @@ void scheduler_tick(void)
         if(current_task->time_slice_remaining == 0)
         {
             /* Move to next task in round-robin */
+            current_task->time_slice_remaining = TIME_SLICE_MS;
             scheduler_round_robin_next(current_task->priority);
-            scheduler_switch_context();
         }
     }
     
+    /* Preempt if a delay expiry or rotation changed the highest ready task */
+    scheduler_switch_context();
+    
+#if RTOS_USE_STATS
     scheduler_update_statistics();
+#endif
 }
 
 /**
@@ -298,8 +368,87 @@ rtos_result_t scheduler_get_stats(scheduler_stats_t* stats_out)
         return RTOS_INVALID_PARAM;
     }
     
+    ENTER_CRITICAL();
+    
     *stats_out = stats;
+    
+#if RTOS_USE_RUNTIME_STATS
+    /* Cycle-accurate utilization: everything except the idle task's share */
+    tcb_t* idle_task = task_get_tcb(idle_task_id);
+    uint64_t idle_cycles = (idle_task != NULL) ? idle_task->execution_time : 0;
+    uint64_t total_cycles = stats.total_run_cycles;
+    
+    if(scheduler_current_tcb != NULL)
+    {
+        uint32_t running = DWT_CYCCNT_REG - slice_start_cycles;
+        total_cycles += running;
+        
+        if(scheduler_current_tcb == idle_task)
+        {
+            idle_cycles += running;
+        }
+    }
+    
+    stats_out->total_run_cycles = total_cycles;
+    if(total_cycles > 0)
+    {
+        stats_out->cpu_utilization = (uint32_t)(100 - idle_cycles * 100 / total_cycles);
+    }
+#endif
+    
+    EXIT_CRITICAL();
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Get a task's CPU usage and run-slice lengths
+ */
+rtos_result_t scheduler_get_task_runtime(uint8_t task_id, task_runtime_stats_t* stats_out)
+{
+#if RTOS_USE_RUNTIME_STATS
+    tcb_t* tcb = task_get_tcb(task_id);
+    
+    if(tcb == NULL || stats_out == NULL)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    ENTER_CRITICAL();
+    
+    uint64_t run_cycles = tcb->execution_time;
+    uint64_t total_cycles = stats.total_run_cycles;
+    
+    /* Count the slice in progress, without closing it */
+    if(scheduler_current_tcb != NULL)
+    {
+        uint32_t running = DWT_CYCCNT_REG - slice_start_cycles;
+        total_cycles += running;
+        
+        if(scheduler_current_tcb == tcb)
+        {
+            run_cycles += running;
+        }
+    }
+    
+    stats_out->run_cycles = run_cycles;
+    stats_out->slice_count = tcb->slice_count;
+    stats_out->min_slice_cycles = (tcb->slice_count > 0) ? tcb->slice_min_cycles : 0;
+    stats_out->max_slice_cycles = tcb->slice_max_cycles;
+    stats_out->avg_slice_cycles = (tcb->slice_count > 0) ?
+                                  (uint32_t)(tcb->execution_time / tcb->slice_count) : 0;
+    
+    EXIT_CRITICAL();
+    
+    stats_out->cpu_percent_x100 = (total_cycles > 0) ?
+                                  (uint32_t)(run_cycles * 10000 / total_cycles) : 0;
+    
     return RTOS_SUCCESS;
+#else
+    UNUSED(task_id);
+    UNUSED(stats_out);
+    return RTOS_ERROR;
+#endif
 }
 
 /**
@@ -307,7 +456,63 @@ rtos_result_t scheduler_get_stats(scheduler_stats_t* stats_out)
  */
 void scheduler_reset_stats(void)
 {
+    ENTER_CRITICAL();
+    
     memset(&stats, 0, sizeof(scheduler_stats_t));
+    
+#if RTOS_USE_RUNTIME_STATS
+    scheduler_reset_task_runtime();
+#endif
+    
+    EXIT_CRITICAL();
+}
+
+/**
+ * @brief Close the outgoing task's run slice and open the incoming one
+ */
+void scheduler_runtime_switch(void)
+{
+    RTOS_LATENCY_ISR_ENTER(&rtos_latency_pendsv);
+    
+    tcb_t* outgoing = scheduler_current_tcb;
+    
+    /* Two decisions folded into one PendSV can land back on the same task */
+    if(outgoing == scheduler_next_tcb)
+    {
+        return;
+    }
+    
+    if(outgoing != NULL)
+    {
+        RTOS_TRACE(TRACE_EVENT_TASK_SWITCH_OUT, outgoing->task_id);
+    }
+    RTOS_TRACE(TRACE_EVENT_TASK_SWITCH_IN, scheduler_next_tcb->task_id);
+    
+#if RTOS_USE_RUNTIME_STATS
+    uint32_t now = DWT_CYCCNT_REG;
+    
+    if(outgoing != NULL)
+    {
+        /* Unsigned difference survives one CYCCNT wrap */
+        uint32_t slice = now - slice_start_cycles;
+        
+        outgoing->execution_time += slice;
+        outgoing->slice_count++;
+        stats.total_run_cycles += slice;
+        
+        if(slice < outgoing->slice_min_cycles)
+        {
+            outgoing->slice_min_cycles = slice;
+        }
+        
+        if(slice > outgoing->slice_max_cycles)
+        {
+            outgoing->slice_max_cycles = slice;
+        }
+    }
+    
+    slice_start_cycles = now;
+#endif
 }
 
 /**
@@ -341,6 +546,14 @@ bool scheduler_is_locked(void)
     return scheduler_locked;
 }
 
+/**
+ * @brief Get the idle task's ID
+ */
+uint8_t scheduler_get_idle_task_id(void)
+{
+    return idle_task_id;
+}
+
 /**
  * @brief Print scheduler information
  */
@@ -367,63 +580,39 @@ void scheduler_print_info(void)
  */
 void scheduler_idle_task(void)
 {
+#if RTOS_USE_STATS
     /* Idle processing - could include power management */
     stats.idle_time_percentage++;
+#endif
     
-    /* In real system, could enter low power mode */
-    // __WFI(); /* Wait for interrupt */
-    
-    DEBUG_PRINT("[IDLE] Idle task running\n");
-}
-
-/**
- * @brief Run the next ready task for one iteration
- * @note This is a simplified scheduler that runs each task once per call
- */
-void scheduler_run_next_task(void)
-{
-    if(!scheduler_running)
-    {
-        return;
-    }
-    
-    /* Get next task to run */
-    tcb_t* next_task = scheduler_get_next_task();
+    /* Self-deleted tasks are off their stacks by now */
+    task_reclaim_stacks();
     
-    if(next_task == NULL)
+    /* Stack scans are only cheap enough when nothing else wants the CPU */
+    uint8_t overflowed = task_check_stacks();
+    if(overflowed != 0xFF)
     {
-        /* No ready tasks, run idle */
-        scheduler_idle_task();
-        return;
+        rtos_stack_overflow_hook(overflowed);
     }
     
-    /* Check if task is blocked or suspended */
-    if(next_task->state == TASK_STATE_BLOCKED || next_task->state == TASK_STATE_SUSPENDED)
-    {
-        /* Skip this task */
-        return;
-    }
-    
-    /* Set task as running */
-    task_set_state(next_task->task_id, TASK_STATE_RUNNING);
+    DEBUG_PRINT("[IDLE] Idle task running\n");
     
-    /* Execute the task function once */
-    if(next_task->task_function != NULL)
-    {
-        next_task->task_function();
-    }
+    /* PRIMASK rather than ENTER_CRITICAL: WFI still wakes on a masked
+     * interrupt, and no ISR can ready a task between check and sleep */
+    __disable_irq();
     
-    /* Set task back to ready (unless it was blocked/suspended by itself) */
-    if(next_task->state == TASK_STATE_RUNNING)
+    /* Sleep only if nothing else (not even another idle-level task) is ready */
+    tcb_t* idle_task = ready_queues[PRIORITY_IDLE];
+    if(ready_priority_bitmap == (1UL << PRIORITY_IDLE) && idle_task->next == idle_task)
     {
-        next_task->state = TASK_STATE_READY;
+#if RTOS_USE_TICKLESS_IDLE
+        timer_tickless_idle();
+#else
+        __WFI();
+#endif
     }
     
-    /* Move to next task in round-robin */
-    scheduler_round_robin_next(next_task->priority);
-    
-    /* Update statistics */
-    stats.total_context_switches++;
+    __enable_irq();
 }
 
 /* ============================================================================
@@ -432,32 +621,47 @@ void scheduler_run_next_task(void)
 
 /**
  * @brief Find highest priority ready task
+ * @note Ready queues only hold READY/RUNNING tasks, so the head of the
+ *       highest non-empty level is the answer. One CLZ on the bitmap
+ *       finds that level regardless of task or priority count.
  */
 static tcb_t* scheduler_find_highest_priority_task(void)
 {
-    /* Search from highest to lowest priority */
-    for(int i = SCHEDULER_PRIORITY_LEVELS - 1; i >= 0; i--)
+    if(ready_priority_bitmap == 0)
     {
-        if(ready_queues[i] != NULL)
+        return NULL;
+    }
+    
+    uint8_t priority = (uint8_t)(31 - __CLZ(ready_priority_bitmap));
+    
+    return ready_queues[priority];
+}
+
+#if RTOS_USE_RUNTIME_STATS
+/**
+ * @brief Clear every task's runtime counters and restart the current slice
+ * @note Caller holds a critical section
+ */
+static void scheduler_reset_task_runtime(void)
+{
+    for(uint8_t i = 0; i < task_get_capacity(); i++)
+    {
+        tcb_t* tcb = task_get_tcb(i);
+        
+        if(tcb != NULL)
         {
-            /* Check if this task is actually in READY state */
-            tcb_t* task = ready_queues[i];
-            tcb_t* first_task = task;
-            
-            /* Try to find a ready task in this priority level */
-            do {
-                if(task->state == TASK_STATE_READY)
-                {
-                    return task;
-                }
-                task = task->next;
-            } while(task != first_task && task != NULL);
+            tcb->execution_time = 0;
+            tcb->slice_count = 0;
+            tcb->slice_min_cycles = 0xFFFFFFFF;
+            tcb->slice_max_cycles = 0;
         }
     }
     
-    return NULL;
+    slice_start_cycles = DWT_CYCCNT_REG;
 }
+#endif
 
+#if RTOS_USE_STATS
 /**
  * @brief Update scheduler statistics
  */
@@ -469,6 +673,7 @@ static void scheduler_update_statistics(void)
         stats.cpu_utilization = 100 - (stats.idle_time_percentage * 100 / stats.total_scheduler_calls);
     }
 }
+#endif
 
 /**
  * @brief Move to next task in round-robin for given priority
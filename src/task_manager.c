@@ -11,20 +11,51 @@
 #include "task_manager.h"
 #include "memory_manager.h"
 #include "scheduler.h"
+#include "queue_manager.h"
+#include "arm_cortex_m.h"
 
 /* ============================================================================
  * GLOBAL VARIABLES
  * ============================================================================ */
-static tcb_t task_table[MAX_TASKS];     /* Task control block table */
+static object_table_t task_table;       /* Task control blocks, slot index = task ID */
 static uint8_t task_count = 0;          /* Number of active tasks */
 static uint8_t current_task_id = 0xFF;  /* Currently running task ID */
-static uint8_t next_task_id = 0;        /* Next available task ID */
+static tcb_t* current_tcb = NULL;       /* TCB of current_task_id */
+static tcb_t* delay_list = NULL;        /* Delayed tasks, earliest wakeup first */
+
+/* Default table storage (task_manager_init): no heap for MAX_TASKS tasks */
+static uint8_t task_storage[POOL_REGION_SIZE(sizeof(tcb_t), MAX_TASKS)] __attribute__((aligned(MEMORY_ALIGNMENT)));
+static uint16_t task_generations[MAX_TASKS];
+
+#if RTOS_USE_MPU_STACK_GUARD
+static uint8_t task_mpu_regions_used = 0;   /* Bit n set: MPU region n guards a stack */
+#endif
 
 /* ============================================================================
  * PRIVATE FUNCTION PROTOTYPES
  * ============================================================================ */
-static void task_stack_init(tcb_t* tcb, void (*task_function)(void));
-static uint8_t task_get_free_id(void);
+static uint8_t task_create_with_stack(void (*task_function)(void), const char* task_name,
+                                      uint8_t priority, uint32_t* stack, uint32_t stack_size,
+                                      bool owns_stack);
+static void task_stack_init(tcb_t* tcb);
+#if RTOS_USE_STACK_CHECK
+static uint32_t task_stack_scan(const tcb_t* tcb);
+#endif
+static void task_entry(void* arg);
+static void task_exit(void);
+static tcb_t* task_lookup(uint8_t task_id);
+static void task_release_slot(tcb_t* tcb);
+#if RTOS_USE_MPU_STACK_GUARD
+static uint8_t task_mpu_guard_claim(const void* guard);
+#endif
+static bool task_state_is_ready(task_state_t state);
+static void task_apply_state(tcb_t* tcb, task_state_t new_state);
+static void task_delay_list_insert(tcb_t* tcb, uint32_t ticks);
+static void task_delay_list_remove(tcb_t* tcb);
+static void task_wait_list_insert(task_wait_list_t* wait_list, tcb_t* tcb);
+static void task_wait_list_remove(tcb_t* tcb);
+static bool task_notify_apply(tcb_t* tcb, uint32_t value, task_notify_action_t action);
+static bool task_notify_can_block(uint32_t timeout_ticks);
 
 /* ============================================================================
  * PUBLIC FUNCTIONS
@@ -35,21 +66,51 @@ static uint8_t task_get_free_id(void);
  */
 rtos_result_t task_manager_init(void)
 {
-    /* Clear task table */
-    memset(task_table, 0, sizeof(task_table));
+    return task_manager_init_capacity(MAX_TASKS);
+}
+
+/**
+ * @brief Initialize the task manager with a run-time task limit
+ */
+rtos_result_t task_manager_init_capacity(uint8_t max_tasks)
+{
+    if(max_tasks == 0)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    if(task_table.generations != NULL)
+    {
+        object_table_delete(&task_table);
+    }
+    
+    /* Every slot starts free: the pool's free stack hands out IDs in O(1) */
+    rtos_result_t result;
+    if(max_tasks <= MAX_TASKS)
+    {
+        result = object_table_create_static(&task_table, task_storage, task_generations,
+                                            sizeof(tcb_t), max_tasks);
+    }
+    else
+    {
+        result = object_table_create(&task_table, sizeof(tcb_t), max_tasks);
+    }
     
-    /* Initialize all tasks as deleted */
-    for(int i = 0; i < MAX_TASKS; i++)
+    if(result != RTOS_SUCCESS)
     {
-        task_table[i].task_id = 0xFF;
-        task_table[i].state = TASK_STATE_DELETED;
+        return result;
     }
     
     task_count = 0;
     current_task_id = 0xFF;
-    next_task_id = 0;
+    current_tcb = NULL;
+    delay_list = NULL;
     
-    DEBUG_PRINT("Task Manager initialized\n");
+#if RTOS_USE_MPU_STACK_GUARD
+    task_mpu_regions_used = 0;
+#endif
+    
+    DEBUG_PRINT("Task Manager initialized (%u task slots)\n", max_tasks);
     return RTOS_SUCCESS;
 }
 
@@ -61,66 +122,91 @@ uint8_t task_create(void (*task_function)(void),
                    uint8_t priority, 
                    uint32_t stack_size)
 {
-    /* Validate parameters */
-    if(task_function == NULL || task_name == NULL)
+    if(stack_size < MIN_STACK_SIZE)
     {
         return 0xFF;
     }
     
-    if(priority > PRIORITY_CRITICAL || stack_size < MIN_STACK_SIZE)
+    /* Allocate stack memory, zero-wait-state RAM first */
+    uint32_t* stack = (uint32_t*)memory_alloc_prefer(MEMORY_REGION_ATTR_FAST, stack_size + TASK_STACK_GUARD_OVERHEAD);
+    if(stack == NULL)
     {
         return 0xFF;
     }
     
-    if(task_count >= MAX_TASKS)
+    uint8_t task_id = task_create_with_stack(task_function, task_name, priority, stack, stack_size, true);
+    if(task_id == 0xFF)
     {
-        return 0xFF;
+        memory_free(stack);
     }
     
-    /* Get free task ID */
-    uint8_t task_id = task_get_free_id();
-    if(task_id == 0xFF)
+    return task_id;
+}
+
+/**
+ * @brief Create a new task on caller-provided stack storage
+ */
+uint8_t task_create_static(void (*task_function)(void), 
+                          const char* task_name, 
+                          uint8_t priority, 
+                          uint32_t* stack_buffer,
+                          uint32_t stack_size)
+{
+    if(stack_buffer == NULL || stack_size < MIN_STACK_SIZE)
     {
         return 0xFF;
     }
     
-    /* Get TCB pointer */
-    tcb_t* tcb = &task_table[task_id];
+    return task_create_with_stack(task_function, task_name, priority, stack_buffer, stack_size, false);
+}
+
+/**
+ * @brief Create a new task and return its handle
+ */
+task_handle_t task_create_handle(void (*task_function)(void),
+                                 const char* task_name,
+                                 uint8_t priority,
+                                 uint32_t stack_size)
+{
+    uint8_t task_id = task_create(task_function, task_name, priority, stack_size);
     
-    /* Allocate stack memory */
-    uint32_t* stack = (uint32_t*)memory_alloc(stack_size);
-    if(stack == NULL)
+    if(task_id == 0xFF)
     {
-        return 0xFF;
+        return OBJECT_HANDLE_INVALID;
     }
     
-    /* Initialize TCB */
-    tcb->task_id = task_id;
-    strncpy(tcb->task_name, task_name, MAX_TASK_NAME_LENGTH - 1);
-    tcb->task_name[MAX_TASK_NAME_LENGTH - 1] = '\0';
-    tcb->task_function = task_function;
-    tcb->priority = priority;
-    tcb->state = TASK_STATE_READY;
-    tcb->stack_base = stack;
-    tcb->stack_size = stack_size;
-    tcb->time_slice_remaining = TIME_SLICE_MS;
-    tcb->delay_ticks = 0;
-    tcb->execution_time = 0;
-    tcb->context_switches = 0;
-    
-    /* Initialize stack */
-    task_stack_init(tcb, task_function);
+    return task_lookup(task_id)->handle;
+}
+
+/**
+ * @brief Delete a task by handle
+ */
+rtos_result_t task_delete_handle(task_handle_t handle)
+{
+    uint8_t task_id = task_handle_get_id(handle);
     
-    /* Update counters */
-    task_count++;
+    if(task_id == 0xFF)
+    {
+        return RTOS_ERROR;
+    }
     
-    /* Add task to scheduler ready queue */
-    scheduler_add_ready_task(tcb);
+    return task_delete(task_id);
+}
+
+/**
+ * @brief Get the task ID behind a handle
+ */
+uint8_t task_handle_get_id(task_handle_t handle)
+{
+    tcb_t* tcb = (tcb_t*)object_get(&task_table, handle);
     
-    DEBUG_PRINT("Task '%s' created with ID %d, Priority %d\n", 
-                task_name, task_id, priority);
+    /* A self-deleted task keeps its slot until reclaimed, but is gone */
+    if(tcb == NULL || tcb->state == TASK_STATE_DELETED)
+    {
+        return 0xFF;
+    }
     
-    return task_id;
+    return tcb->task_id;
 }
 
 /**
@@ -128,28 +214,46 @@ uint8_t task_create(void (*task_function)(void),
  */
 rtos_result_t task_delete(uint8_t task_id)
 {
-    if(task_id >= MAX_TASKS)
+    if(task_id >= task_table.capacity)
     {
         return RTOS_INVALID_PARAM;
     }
     
-    tcb_t* tcb = &task_table[task_id];
+    tcb_t* tcb = task_lookup(task_id);
     
-    if(tcb->state == TASK_STATE_DELETED)
+    if(tcb == NULL || tcb->state == TASK_STATE_DELETED)
     {
         return RTOS_ERROR;
     }
     
-    /* Free stack memory */
-    if(tcb->stack_base != NULL)
+    ENTER_CRITICAL();
+    
+#if RTOS_USE_MPU_STACK_GUARD
+    if(tcb->mpu_region != TASK_MPU_REGION_NONE)
     {
-        memory_free(tcb->stack_base);
+        cortex_m_mpu_clear_region(tcb->mpu_region);
+        task_mpu_regions_used &= (uint8_t)~(1U << tcb->mpu_region);
+        tcb->mpu_region = TASK_MPU_REGION_NONE;
     }
+#endif
     
-    /* Mark as deleted */
-    tcb->state = TASK_STATE_DELETED;
+    /* Waiters inherit its mutexes; a new task in this slot must not */
+    mutex_release_all(tcb);
+    
+    /* Mark as deleted (also drops it from the ready queue and any wait) */
+    task_set_state(task_id, TASK_STATE_DELETED);
     tcb->task_id = 0xFF;
     
+    EXIT_CRITICAL();
+    
+    /* A running task cannot free its own stack - the idle task does that once
+     * it is switched out (task_reclaim_stacks), and only then is the slot
+     * free for a new task */
+    if(task_id != current_task_id)
+    {
+        task_release_slot(tcb);
+    }
+    
     /* Update counter */
     if(task_count > 0)
     {
@@ -158,6 +262,17 @@ rtos_result_t task_delete(uint8_t task_id)
     
     DEBUG_PRINT("Task %d deleted\n", task_id);
     
+    /* A task deleting itself never runs again */
+    if(task_id == current_task_id)
+    {
+        scheduler_yield();
+    }
+    else
+    {
+        /* A new mutex owner may outrank the caller */
+        scheduler_switch_context();
+    }
+    
     return RTOS_SUCCESS;
 }
 
@@ -166,22 +281,27 @@ rtos_result_t task_delete(uint8_t task_id)
  */
 rtos_result_t task_suspend(uint8_t task_id)
 {
-    if(task_id >= MAX_TASKS)
+    if(task_id >= task_table.capacity)
     {
         return RTOS_INVALID_PARAM;
     }
     
-    tcb_t* tcb = &task_table[task_id];
+    tcb_t* tcb = task_lookup(task_id);
     
-    if(tcb->state == TASK_STATE_DELETED)
+    if(tcb == NULL || tcb->state == TASK_STATE_DELETED)
     {
         return RTOS_ERROR;
     }
     
-    tcb->state = TASK_STATE_SUSPENDED;
+    task_set_state(task_id, TASK_STATE_SUSPENDED);
     
     DEBUG_PRINT("Task %d suspended\n", task_id);
     
+    if(task_id == current_task_id)
+    {
+        scheduler_yield();
+    }
+    
     return RTOS_SUCCESS;
 }
 
@@ -190,19 +310,19 @@ rtos_result_t task_suspend(uint8_t task_id)
  */
 rtos_result_t task_resume(uint8_t task_id)
 {
-    if(task_id >= MAX_TASKS)
+    if(task_id >= task_table.capacity)
     {
         return RTOS_INVALID_PARAM;
     }
     
-    tcb_t* tcb = &task_table[task_id];
+    tcb_t* tcb = task_lookup(task_id);
     
-    if(tcb->state != TASK_STATE_SUSPENDED)
+    if(tcb == NULL || tcb->state != TASK_STATE_SUSPENDED)
     {
         return RTOS_ERROR;
     }
     
-    tcb->state = TASK_STATE_READY;
+    task_set_state(task_id, TASK_STATE_READY);
     
     DEBUG_PRINT("Task %d resumed\n", task_id);
     
@@ -214,46 +334,267 @@ rtos_result_t task_resume(uint8_t task_id)
  */
 void task_delay(uint32_t delay_ticks)
 {
-    if(current_task_id < MAX_TASKS)
+    if(current_tcb != NULL)
     {
-        tcb_t* tcb = &task_table[current_task_id];
-        tcb->delay_ticks = delay_ticks;
-        tcb->state = TASK_STATE_BLOCKED;
+        tcb_t* tcb = current_tcb;
+        
+        if(delay_ticks > 0)
+        {
+            /* Block and queue in one step so a tick cannot miss the task */
+            ENTER_CRITICAL();
+            tcb->wait_result = RTOS_SUCCESS;
+            task_apply_state(tcb, TASK_STATE_BLOCKED);
+            task_delay_list_insert(tcb, delay_ticks);
+            EXIT_CRITICAL();
+        }
         
         /* Trigger context switch */
-        // This would trigger scheduler in real implementation
+        scheduler_yield();
     }
 }
 
 /**
- * @brief Get task control block by ID
+ * @brief Initialize an empty wait list
  */
-tcb_t* task_get_tcb(uint8_t task_id)
+void task_wait_list_init(task_wait_list_t* wait_list)
+{
+    wait_list->head = NULL;
+    wait_list->count = 0;
+}
+
+/**
+ * @brief Block the current task until woken or the timeout expires
+ */
+void task_block_current(task_wait_list_t* wait_list, uint32_t timeout_ticks, void* wait_data)
 {
-    if(task_id >= MAX_TASKS)
+    tcb_t* tcb = current_tcb;
+    
+    if(tcb == NULL)
     {
-        return NULL;
+        return;
     }
     
-    if(task_table[task_id].state == TASK_STATE_DELETED)
+    tcb->wait_data = wait_data;
+    tcb->wait_result = TASK_WAIT_PENDING;
+    task_apply_state(tcb, TASK_STATE_BLOCKED);
+    
+    if(wait_list != NULL)
     {
-        return NULL;
+        task_wait_list_insert(wait_list, tcb);
     }
     
-    return &task_table[task_id];
+    if(timeout_ticks != TASK_WAIT_FOREVER)
+    {
+        task_delay_list_insert(tcb, (timeout_ticks > 0) ? timeout_ticks : 1);
+    }
 }
 
 /**
- * @brief Get current running task
+ * @brief Wake a task blocked by task_block_current()
  */
-tcb_t* task_get_current(void)
+void task_wake_blocked(tcb_t* tcb, int8_t result)
+{
+    if(tcb == NULL || tcb->state != TASK_STATE_BLOCKED)
+    {
+        return;
+    }
+    
+    tcb->wait_result = result;
+    task_apply_state(tcb, TASK_STATE_READY);
+}
+
+/**
+ * @brief Send a notification to a task
+ */
+rtos_result_t task_notify(uint8_t task_id, uint32_t value, task_notify_action_t action)
+{
+    bool task_woken = false;
+    rtos_result_t result = task_notify_from_isr(task_id, value, action, &task_woken);
+    
+    if(task_woken)
+    {
+        scheduler_switch_context();
+    }
+    
+    return result;
+}
+
+/**
+ * @brief Send a notification to a task from an ISR
+ */
+rtos_result_t task_notify_from_isr(uint8_t task_id, uint32_t value, task_notify_action_t action, bool* task_woken)
+{
+    if(task_id >= task_table.capacity || action > TASK_NOTIFY_OVERWRITE)
+    {
+        return RTOS_INVALID_PARAM;
+    }
+    
+    ENTER_CRITICAL();
+    
+    tcb_t* tcb = task_lookup(task_id);
+    
+    if(tcb == NULL || tcb->state == TASK_STATE_DELETED)
+    {
+        EXIT_CRITICAL();
+        return RTOS_ERROR;
+    }
+    
+    bool woken = task_notify_apply(tcb, value, action);
+    
+    EXIT_CRITICAL();
+    
+    /* Accumulate so one ISR can notify several tasks and switch once */
+    if(task_woken != NULL && woken)
+    {
+        *task_woken = true;
+    }
+    
+    return RTOS_SUCCESS;
+}
+
+/**
+ * @brief Wait for a notification to the current task
+ */
+rtos_result_t task_notify_wait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t* value_out, uint32_t timeout_ticks)
+{
+    tcb_t* tcb = current_tcb;
+    
+    if(tcb == NULL)
+    {
+        return RTOS_ERROR;
+    }
+    
+    ENTER_CRITICAL();
+    
+    if(tcb->notify_state != TASK_NOTIFY_RECEIVED)
+    {
+        tcb->notify_value &= ~clear_on_entry;
+        
+        if(task_notify_can_block(timeout_ticks))
+        {
+            tcb->notify_state = TASK_NOTIFY_WAITING;
+            task_block_current(NULL, timeout_ticks, NULL);
+            
+            EXIT_CRITICAL();
+            
+            scheduler_yield();
+            
+            ENTER_CRITICAL();
+        }
+    }
+    
+    /* A notification that raced with the timeout still counts */
+    rtos_result_t result = (tcb->notify_state == TASK_NOTIFY_RECEIVED) ? RTOS_SUCCESS : RTOS_TIMEOUT;
+    
+    if(value_out != NULL)
+    {
+        *value_out = tcb->notify_value;
+    }
+    
+    if(result == RTOS_SUCCESS)
+    {
+        tcb->notify_value &= ~clear_on_exit;
+    }
+    
+    tcb->notify_state = TASK_NOTIFY_NONE;
+    
+    EXIT_CRITICAL();
+    
+    return result;
+}
+
+/**
+ * @brief Take from the notification word used as a counting/binary semaphore
+ */
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout_ticks)
+{
+    tcb_t* tcb = current_tcb;
+    
+    if(tcb == NULL)
+    {
+        return 0;
+    }
+    
+    ENTER_CRITICAL();
+    
+    if(tcb->notify_value == 0 && task_notify_can_block(timeout_ticks))
+    {
+        tcb->notify_state = TASK_NOTIFY_WAITING;
+        task_block_current(NULL, timeout_ticks, NULL);
+        
+        EXIT_CRITICAL();
+        
+        scheduler_yield();
+        
+        ENTER_CRITICAL();
+    }
+    
+    uint32_t count = tcb->notify_value;
+    
+    if(count > 0)
+    {
+        tcb->notify_value = clear_on_exit ? 0 : count - 1;
+    }
+    
+    tcb->notify_state = TASK_NOTIFY_NONE;
+    
+    EXIT_CRITICAL();
+    
+    return count;
+}
+
+/**
+ * @brief Change a task's effective priority
+ */
+void task_change_priority(tcb_t* tcb, uint8_t priority)
+{
+    if(tcb == NULL || priority > PRIORITY_CRITICAL || tcb->priority == priority)
+    {
+        return;
+    }
+    
+    if(task_state_is_ready(tcb->state))
+    {
+        /* Ready queues are indexed by priority - move to the new level */
+        scheduler_remove_ready_task(tcb);
+        tcb->priority = priority;
+        scheduler_add_ready_task(tcb);
+    }
+    else if(tcb->wait_list != NULL)
+    {
+        /* Keep the wait list sorted */
+        task_wait_list_t* wait_list = tcb->wait_list;
+        task_wait_list_remove(tcb);
+        tcb->priority = priority;
+        task_wait_list_insert(wait_list, tcb);
+    }
+    else
+    {
+        tcb->priority = priority;
+    }
+}
+
+/**
+ * @brief Get task control block by ID
+ */
+tcb_t* task_get_tcb(uint8_t task_id)
 {
-    if(current_task_id >= MAX_TASKS)
+    tcb_t* tcb = task_lookup(task_id);
+    
+    if(tcb == NULL || tcb->state == TASK_STATE_DELETED)
     {
         return NULL;
     }
     
-    return &task_table[current_task_id];
+    return tcb;
+}
+
+/**
+ * @brief Get current running task
+ */
+tcb_t* task_get_current(void)
+{
+    return current_tcb;
 }
 
 /**
@@ -261,24 +602,35 @@ tcb_t* task_get_current(void)
  */
 rtos_result_t task_set_state(uint8_t task_id, task_state_t new_state)
 {
-    if(task_id >= MAX_TASKS)
+    if(task_id >= task_table.capacity)
     {
         return RTOS_INVALID_PARAM;
     }
     
-    tcb_t* tcb = &task_table[task_id];
+    tcb_t* tcb = task_lookup(task_id);
     
-    if(tcb->state == TASK_STATE_DELETED)
+    if(tcb == NULL || tcb->state == TASK_STATE_DELETED)
     {
         return RTOS_ERROR;
     }
     
-    tcb->state = new_state;
+    if(task_state_is_ready(tcb->state) && task_state_is_ready(new_state))
+    {
+        /* READY <-> RUNNING: no list changes, safe inside switch path */
+        tcb->state = new_state;
+    }
+    else
+    {
+        ENTER_CRITICAL();
+        task_apply_state(tcb, new_state);
+        EXIT_CRITICAL();
+    }
     
     /* Update current task ID if setting to running */
     if(new_state == TASK_STATE_RUNNING)
     {
         current_task_id = task_id;
+        current_tcb = tcb;
     }
     
     return RTOS_SUCCESS;
@@ -289,12 +641,9 @@ rtos_result_t task_set_state(uint8_t task_id, task_state_t new_state)
  */
 task_state_t task_get_state(uint8_t task_id)
 {
-    if(task_id >= MAX_TASKS)
-    {
-        return TASK_STATE_DELETED;
-    }
+    tcb_t* tcb = task_lookup(task_id);
     
-    return task_table[task_id].state;
+    return (tcb != NULL) ? tcb->state : TASK_STATE_DELETED;
 }
 
 /**
@@ -302,20 +651,44 @@ task_state_t task_get_state(uint8_t task_id)
  */
 void task_update_delays(void)
 {
-    for(int i = 0; i < MAX_TASKS; i++)
+    ENTER_CRITICAL();
+    
+    if(delay_list != NULL)
     {
-        tcb_t* tcb = &task_table[i];
+        /* Only the head counts down; the rest are relative to it */
+        if(delay_list->delay_ticks > 0)
+        {
+            delay_list->delay_ticks--;
+        }
         
-        if(tcb->state == TASK_STATE_BLOCKED && tcb->delay_ticks > 0)
+        /* Wake every task due on this tick (waking unlinks the head) */
+        while(delay_list != NULL && delay_list->delay_ticks == 0)
         {
-            tcb->delay_ticks--;
-            
-            if(tcb->delay_ticks == 0)
-            {
-                tcb->state = TASK_STATE_READY;
-            }
+            task_apply_state(delay_list, TASK_STATE_READY);
         }
     }
+    
+    EXIT_CRITICAL();
+}
+
+/**
+ * @brief Get ticks until the earliest delayed task wakes up
+ */
+uint32_t task_get_next_wakeup(void)
+{
+    return (delay_list != NULL) ? delay_list->delay_ticks : 0xFFFFFFFF;
+}
+
+/**
+ * @brief Advance all task delays by several ticks at once
+ */
+void task_step_delays(uint32_t ticks)
+{
+    /* Deltas: stepping the head steps every entry */
+    if(delay_list != NULL && delay_list->delay_ticks > ticks)
+    {
+        delay_list->delay_ticks -= ticks;
+    }
 }
 
 /**
@@ -326,6 +699,14 @@ uint8_t task_get_count(void)
     return task_count;
 }
 
+/**
+ * @brief Get the task table size
+ */
+uint8_t task_get_capacity(void)
+{
+    return (uint8_t)task_table.capacity;
+}
+
 /**
  * @brief Print task information
  */
@@ -337,61 +718,600 @@ void task_print_info(uint8_t task_id)
         DEBUG_PRINT("=== Task Information ===\n");
         DEBUG_PRINT("Total Tasks: %d\n", task_count);
         
-        for(int i = 0; i < MAX_TASKS; i++)
+        for(uint32_t i = 0; i < task_table.capacity; i++)
         {
-            tcb_t* tcb = &task_table[i];
-            if(tcb->state != TASK_STATE_DELETED)
+            tcb_t* tcb = task_get_tcb((uint8_t)i);
+            if(tcb != NULL)
             {
                 DEBUG_PRINT("ID:%d Name:'%s' Priority:%d State:%d\n",
                            tcb->task_id, tcb->task_name, tcb->priority, tcb->state);
             }
         }
     }
-    else if(task_id < MAX_TASKS)
+    else
     {
-        tcb_t* tcb = &task_table[task_id];
-        if(tcb->state != TASK_STATE_DELETED)
+        tcb_t* tcb = task_get_tcb(task_id);
+        if(tcb != NULL)
         {
             DEBUG_PRINT("Task %d: '%s' Priority:%d State:%d Switches:%u\n",
                        tcb->task_id, tcb->task_name, tcb->priority, 
                        tcb->state, tcb->context_switches);
+#if RTOS_USE_STACK_CHECK
+            DEBUG_PRINT("  Stack: %u bytes, %u never used\n",
+                       tcb->stack_size, task_get_stack_high_water(task_id));
+#endif
         }
     }
 }
 
+/**
+ * @brief Free the stacks of tasks that deleted themselves
+ */
+void task_reclaim_stacks(void)
+{
+    for(uint32_t i = 0; i < task_table.capacity; i++)
+    {
+        tcb_t* tcb = task_lookup((uint8_t)i);
+        
+        /* The caller is running, so no deleted task is on its stack any more */
+        if(tcb != NULL && tcb->state == TASK_STATE_DELETED && i != current_task_id)
+        {
+            task_release_slot(tcb);
+        }
+    }
+}
+
+/**
+ * @brief Measure a task's stack high-water mark
+ */
+uint32_t task_get_stack_high_water(uint8_t task_id)
+{
+#if RTOS_USE_STACK_CHECK
+    tcb_t* tcb = task_get_tcb(task_id);
+    
+    if(tcb == NULL)
+    {
+        return 0xFFFFFFFF;
+    }
+    
+    uint32_t free_bytes = task_stack_scan(tcb);
+    if(free_bytes < tcb->stack_min_free)
+    {
+        tcb->stack_min_free = free_bytes;
+    }
+    
+    return tcb->stack_min_free;
+#else
+    UNUSED(task_id);
+    return 0xFFFFFFFF;
+#endif
+}
+
+/**
+ * @brief Check one task's stack for overflow, round-robin over all tasks
+ */
+uint8_t task_check_stacks(void)
+{
+#if RTOS_USE_STACK_CHECK
+    static uint8_t next_check = 0;
+    
+    for(uint32_t i = 0; i < task_table.capacity; i++)
+    {
+        uint8_t task_id = next_check;
+        next_check = (uint8_t)((next_check + 1) % task_table.capacity);
+        
+        tcb_t* tcb = task_get_tcb(task_id);
+        if(tcb == NULL)
+        {
+            continue;
+        }
+        
+        if(task_get_stack_high_water(task_id) == 0)
+        {
+            DEBUG_PRINT("Stack overflow in task '%s'\n", tcb->task_name);
+            return task_id;
+        }
+        
+        return 0xFF; /* One task per call */
+    }
+#endif
+    
+    return 0xFF;
+}
+
+/**
+ * @brief Default stack overflow hook - stop the task before it corrupts more
+ */
+__attribute__((weak)) void rtos_stack_overflow_hook(uint8_t task_id)
+{
+    if(task_id != current_task_id)
+    {
+        task_suspend(task_id);
+        return;
+    }
+    
+    /* The idle task overflowed: nothing is safe to run any more */
+    __disable_irq();
+    while(1)
+    {
+    }
+}
+
 /* ============================================================================
  * PRIVATE FUNCTIONS
  * ============================================================================ */
 
+/**
+ * @brief Set up a TCB on the given stack storage and make it ready
+ */
+static uint8_t task_create_with_stack(void (*task_function)(void), 
+                                      const char* task_name, 
+                                      uint8_t priority, 
+                                      uint32_t* stack,
+                                      uint32_t stack_size,
+                                      bool owns_stack)
+{
+    /* Validate parameters */
+    if(task_function == NULL || task_name == NULL)
+    {
+        return 0xFF;
+    }
+    
+    if(priority > PRIORITY_CRITICAL)
+    {
+        return 0xFF;
+    }
+    
+    /* Pop a free slot: its index is the task ID. A recycled slot still reads
+     * DELETED, so mark it before task_reclaim_stacks() can see it. */
+    task_handle_t handle;
+    
+    ENTER_CRITICAL();
+    
+    tcb_t* tcb = (tcb_t*)object_alloc(&task_table, &handle);
+    if(tcb != NULL)
+    {
+        tcb->state = TASK_STATE_SUSPENDED;
+    }
+    
+    EXIT_CRITICAL();
+    
+    if(tcb == NULL)
+    {
+        return 0xFF;
+    }
+    
+    uint8_t task_id = (uint8_t)(handle & OBJECT_HANDLE_INDEX_MASK);
+    
+    /* Initialize TCB */
+    memset(tcb, 0, sizeof(tcb_t));
+    tcb->task_id = task_id;
+    tcb->handle = handle;
+    strncpy(tcb->task_name, task_name, MAX_TASK_NAME_LENGTH - 1);
+    tcb->task_name[MAX_TASK_NAME_LENGTH - 1] = '\0';
+    tcb->task_function = task_function;
+    tcb->priority = priority;
+    tcb->base_priority = priority;
+    tcb->state = TASK_STATE_READY;
+    tcb->stack_base = stack;
+    tcb->stack_size = stack_size;
+    tcb->owns_stack = owns_stack;
+    tcb->stack_limit = stack;
+    tcb->stack_min_free = stack_size;
+    tcb->mpu_region = TASK_MPU_REGION_NONE;
+    tcb->time_slice_remaining = TIME_SLICE_MS;
+    tcb->delay_ticks = 0;
+    tcb->delay_next = NULL;
+    tcb->delay_prev = NULL;
+    tcb->wait_list = NULL;
+    tcb->wait_next = NULL;
+    tcb->wait_prev = NULL;
+    tcb->wait_data = NULL;
+    tcb->wait_result = RTOS_SUCCESS;
+    tcb->notify_value = 0;
+    tcb->notify_state = TASK_NOTIFY_NONE;
+    tcb->held_mutexes = NULL;
+    tcb->waiting_mutex = NULL;
+    tcb->execution_time = 0;
+    tcb->context_switches = 0;
+    tcb->slice_count = 0;
+    tcb->slice_min_cycles = 0xFFFFFFFF;
+    tcb->slice_max_cycles = 0;
+    
+#if RTOS_USE_MPU_STACK_GUARD
+    /* The guard is reserved even when no MPU region is left for it */
+    uintptr_t guard = ((uintptr_t)stack + MPU_STACK_GUARD_SIZE - 1) & ~(uintptr_t)(MPU_STACK_GUARD_SIZE - 1);
+    tcb->stack_limit = (uint32_t*)(guard + MPU_STACK_GUARD_SIZE);
+    tcb->mpu_region = task_mpu_guard_claim((const void*)guard);
+#endif
+    
+#if RTOS_USE_STACK_CHECK
+    /* Paint the whole stack; untouched words mark the high-water line */
+    for(uint32_t i = 0; i < stack_size / sizeof(uint32_t); i++)
+    {
+        tcb->stack_limit[i] = TASK_STACK_FILL_PATTERN;
+    }
+#endif
+    
+    /* Initialize stack */
+    task_stack_init(tcb);
+    
+    /* Update counters */
+    task_count++;
+    
+    /* Add task to scheduler ready queue */
+    scheduler_add_ready_task(tcb);
+    
+    DEBUG_PRINT("Task '%s' created with ID %d, Priority %d\n", 
+                task_name, task_id, priority);
+    
+    return task_id;
+}
+
+
+#if RTOS_USE_STACK_CHECK
+/**
+ * @brief Count still-painted bytes from the stack limit upwards
+ */
+static uint32_t task_stack_scan(const tcb_t* tcb)
+{
+    const uint32_t* word = tcb->stack_limit;
+    const uint32_t* end = tcb->stack_limit + tcb->stack_size / sizeof(uint32_t);
+    
+    while(word < end && *word == TASK_STACK_FILL_PATTERN)
+    {
+        word++;
+    }
+    
+    return (uint32_t)(word - tcb->stack_limit) * sizeof(uint32_t);
+}
+#endif
+
 /**
  * @brief Initialize task stack
+ * @note Builds the frame PendSV_Handler expects to restore: R4-R11 at
+ *       the saved stack pointer, followed by the hardware exception frame
+ *       (R0-R3, R12, LR, PC, xPSR) that the exception return unstacks.
+ *       The host port runs the task on its own context instead.
  */
-static void task_stack_init(tcb_t* tcb, void (*task_function)(void))
+static void task_stack_init(tcb_t* tcb)
 {
-    /* For ARM Cortex-M, stack grows downward */
-    uint32_t* stack_top = tcb->stack_base + (tcb->stack_size / sizeof(uint32_t)) - 1;
+#if RTOS_PORT_POSIX
+    cortex_m_host_task_init(tcb->task_id, task_entry, tcb);
+    tcb->stack_pointer = NULL;
+    UNUSED(task_exit); /* task_entry never returns to it here */
+#else
+    /* For ARM Cortex-M, stack grows downward (AAPCS wants 8-byte alignment) */
+    uint32_t* stack_top = tcb->stack_limit + (tcb->stack_size / sizeof(uint32_t));
+    stack_top = (uint32_t*)((uintptr_t)stack_top & ~(uintptr_t)0x7);
+    
+    /* Hardware-stacked frame */
+    *(--stack_top) = CORTEX_M_INITIAL_XPSR;                             /* xPSR */
+    *(--stack_top) = (uint32_t)task_entry & CORTEX_M_START_ADDR_MASK;   /* PC */
+    *(--stack_top) = (uint32_t)task_exit;                               /* LR */
+    *(--stack_top) = 0;                                                 /* R12 */
+    *(--stack_top) = 0;                                                 /* R3 */
+    *(--stack_top) = 0;                                                 /* R2 */
+    *(--stack_top) = 0;                                                 /* R1 */
+    *(--stack_top) = (uint32_t)tcb;                                     /* R0 */
+    
+    /* Software-saved registers R11-R4 */
+    for(int i = 0; i < 8; i++)
+    {
+        *(--stack_top) = 0;
+    }
     
-    /* Initialize stack with task function address */
-    /* This is a simplified version - real implementation would set up
-       proper ARM Cortex-M exception stack frame */
     tcb->stack_pointer = stack_top;
+#endif
+}
+
+/**
+ * @brief First code run by every task (entered from PendSV)
+ * @note Task functions do one iteration of work and return, so the
+ *       entry loop calls the function again after yielding. Functions
+ *       with their own while(1) loop simply never return here.
+ */
+static void task_entry(void* arg)
+{
+    tcb_t* tcb = (tcb_t*)arg;
+    
+    while(1)
+    {
+        tcb->task_function();
+        scheduler_yield();
+    }
+}
+
+/**
+ * @brief Return address of task_entry (should never be reached)
+ */
+static void task_exit(void)
+{
+    task_delete(current_task_id);
+    
+    while(1)
+    {
+        /* Deleted task waits here until switched out */
+    }
+}
+
+/**
+ * @brief Check if a state keeps the task in the scheduler ready queue
+ * @note The running task stays queued so round-robin can rotate past it
+ */
+static bool task_state_is_ready(task_state_t state)
+{
+    return (state == TASK_STATE_READY || state == TASK_STATE_RUNNING);
+}
+
+/**
+ * @brief Change task state and keep the ready queue and delay list in step
+ * @note Caller holds a critical section (or the change touches no list)
+ */
+static void task_apply_state(tcb_t* tcb, task_state_t new_state)
+{
+    bool was_ready = task_state_is_ready(tcb->state);
+    bool is_ready = task_state_is_ready(new_state);
+    
+    if(was_ready && !is_ready)
+    {
+        scheduler_remove_ready_task(tcb);
+    }
+    else if(!was_ready && is_ready)
+    {
+        scheduler_add_ready_task(tcb);
+    }
+    
+    /* Any wakeup (expiry, resume, delete) takes the task off the delay list */
+    if(new_state != TASK_STATE_BLOCKED)
+    {
+        task_delay_list_remove(tcb);
+        task_wait_list_remove(tcb);
+        
+        /* Leaving a wait other than through task_wake_blocked() is a timeout */
+        if(tcb->wait_result == TASK_WAIT_PENDING)
+        {
+            tcb->wait_result = RTOS_TIMEOUT;
+            
+            /* The mutex owner loses our priority now, not when we next run */
+            if(tcb->waiting_mutex != NULL)
+            {
+                mutex_abandon_wait(tcb);
+            }
+        }
+    }
+    
+    tcb->state = new_state;
+}
+
+/**
+ * @brief Insert task into the delta-ordered delay list
+ * @note O(delayed tasks), but runs in task context - never in the tick
+ */
+static void task_delay_list_insert(tcb_t* tcb, uint32_t ticks)
+{
+    tcb_t* prev = NULL;
+    tcb_t* node = delay_list;
+    
+    /* Walk past entries due no later than us (FIFO among equal wakeups) */
+    while(node != NULL && node->delay_ticks <= ticks)
+    {
+        ticks -= node->delay_ticks;
+        prev = node;
+        node = node->delay_next;
+    }
+    
+    tcb->delay_ticks = ticks;
+    tcb->delay_prev = prev;
+    tcb->delay_next = node;
+    
+    if(node != NULL)
+    {
+        node->delay_ticks -= ticks;
+        node->delay_prev = tcb;
+    }
+    
+    if(prev != NULL)
+    {
+        prev->delay_next = tcb;
+    }
+    else
+    {
+        delay_list = tcb;
+    }
+}
+
+/**
+ * @brief Remove task from the delay list (no-op if not delayed)
+ */
+static void task_delay_list_remove(tcb_t* tcb)
+{
+    if(tcb->delay_prev == NULL && delay_list != tcb)
+    {
+        return;
+    }
+    
+    /* Hand our remaining delta on to the successor */
+    if(tcb->delay_next != NULL)
+    {
+        tcb->delay_next->delay_ticks += tcb->delay_ticks;
+        tcb->delay_next->delay_prev = tcb->delay_prev;
+    }
+    
+    if(tcb->delay_prev != NULL)
+    {
+        tcb->delay_prev->delay_next = tcb->delay_next;
+    }
+    else
+    {
+        delay_list = tcb->delay_next;
+    }
+    
+    tcb->delay_next = NULL;
+    tcb->delay_prev = NULL;
+    tcb->delay_ticks = 0;
+}
+
+/**
+ * @brief Insert task into a wait list behind all waiters of equal or higher priority
+ * @note O(waiters) on the blocking side so waking the head stays O(1)
+ */
+static void task_wait_list_insert(task_wait_list_t* wait_list, tcb_t* tcb)
+{
+    tcb_t* prev = NULL;
+    tcb_t* node = wait_list->head;
+    
+    while(node != NULL && node->priority >= tcb->priority)
+    {
+        prev = node;
+        node = node->wait_next;
+    }
+    
+    tcb->wait_prev = prev;
+    tcb->wait_next = node;
+    
+    if(node != NULL)
+    {
+        node->wait_prev = tcb;
+    }
+    
+    if(prev != NULL)
+    {
+        prev->wait_next = tcb;
+    }
+    else
+    {
+        wait_list->head = tcb;
+    }
+    
+    tcb->wait_list = wait_list;
+    wait_list->count++;
+}
+
+/**
+ * @brief Remove task from the wait list it is queued on (if any)
+ */
+static void task_wait_list_remove(tcb_t* tcb)
+{
+    task_wait_list_t* wait_list = tcb->wait_list;
+    
+    if(wait_list == NULL)
+    {
+        return;
+    }
+    
+    if(tcb->wait_next != NULL)
+    {
+        tcb->wait_next->wait_prev = tcb->wait_prev;
+    }
+    
+    if(tcb->wait_prev != NULL)
+    {
+        tcb->wait_prev->wait_next = tcb->wait_next;
+    }
+    else
+    {
+        wait_list->head = tcb->wait_next;
+    }
+    
+    wait_list->count--;
+    
+    tcb->wait_list = NULL;
+    tcb->wait_next = NULL;
+    tcb->wait_prev = NULL;
+}
+
+/**
+ * @brief Apply a notification and wake the task if it is waiting for one
+ * @return bool True if the task was woken
+ * @note Caller holds a critical section
+ */
+static bool task_notify_apply(tcb_t* tcb, uint32_t value, task_notify_action_t action)
+{
+    switch(action)
+    {
+        case TASK_NOTIFY_SET_BITS:
+            tcb->notify_value |= value;
+            break;
+        case TASK_NOTIFY_INCREMENT:
+            tcb->notify_value++;
+            break;
+        case TASK_NOTIFY_OVERWRITE:
+            tcb->notify_value = value;
+            break;
+    }
+    
+    bool was_waiting = (tcb->notify_state == TASK_NOTIFY_WAITING);
+    tcb->notify_state = TASK_NOTIFY_RECEIVED;
     
-    /* Store function pointer at top of stack */
-    *stack_top = (uint32_t)task_function;
+    if(was_waiting && tcb->state == TASK_STATE_BLOCKED)
+    {
+        task_wake_blocked(tcb, RTOS_SUCCESS);
+        return true;
+    }
+    
+    return false;
+}
+
+/**
+ * @brief Check whether the current task may block in a notification wait
+ */
+static bool task_notify_can_block(uint32_t timeout_ticks)
+{
+    return timeout_ticks != 0 &&
+           scheduler_is_running() &&
+           !scheduler_is_locked() &&
+           !cortex_m_in_interrupt();
 }
 
 /**
- * @brief Get next available task ID
+ * @brief Resolve a task ID to its slot (NULL if free or out of range)
+ * @note A self-deleted task keeps its slot, in TASK_STATE_DELETED, until reclaimed
  */
-static uint8_t task_get_free_id(void)
+static tcb_t* task_lookup(uint8_t task_id)
 {
-    for(int i = 0; i < MAX_TASKS; i++)
+    return (tcb_t*)object_get_index(&task_table, task_id);
+}
+
+/**
+ * @brief Free a deleted task's stack and give its slot back to the table
+ * @note Static stacks belong to the caller and are left alone
+ */
+static void task_release_slot(tcb_t* tcb)
+{
+    if(tcb->stack_base != NULL && tcb->owns_stack)
+    {
+        memory_free(tcb->stack_base);
+    }
+    tcb->stack_base = NULL;
+    
+    object_free(&task_table, tcb->handle);
+}
+
+#if RTOS_USE_MPU_STACK_GUARD
+/**
+ * @brief Program a free MPU region as a stack guard
+ * @return uint8_t Region number, TASK_MPU_REGION_NONE once the core runs out
+ */
+static uint8_t task_mpu_guard_claim(const void* guard)
+{
+    uint8_t claimed = TASK_MPU_REGION_NONE;
+    
+    ENTER_CRITICAL();
+    
+    for(uint8_t region = 0; region < TASK_MPU_GUARD_REGIONS; region++)
     {
-        if(task_table[i].state == TASK_STATE_DELETED)
+        if((task_mpu_regions_used & (1U << region)) == 0 &&
+           cortex_m_mpu_set_guard(region, guard) == RTOS_SUCCESS)
         {
-            return i;
+            task_mpu_regions_used |= (uint8_t)(1U << region);
+            claimed = region;
+            break;
         }
     }
     
-    return 0xFF; /* No free slot */
-}
\ No newline at end of file
+    EXIT_CRITICAL();
+    
+    return claimed;
+}
+#endif
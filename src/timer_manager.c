@@ -10,22 +10,67 @@
 
 #include "timer_manager.h"
 #include "scheduler.h"
+#include "arm_cortex_m.h"
+#include "rtos_trace.h"
+#include "rtos_latency.h"
+
+#define TIMER_WHEEL_RANGE   (1UL << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS))   /* Ticks covered without parking */
+
+#if (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS) >= 32
+#error "Timer wheel range must fit in a 32-bit tick count"
+#endif
 
 /* ============================================================================
  * GLOBAL VARIABLES
  * ============================================================================ */
-static software_timer_t software_timers[MAX_SOFTWARE_TIMERS];   /* Software timer array */
 static timer_stats_t stats;                                    /* Timer statistics */
 static volatile uint32_t system_tick_counter = 0;              /* System tick counter */
 static volatile bool timer_running = false;                    /* Timer running state */
 static bool timer_initialized = false;                         /* Initialization state */
 
+#if RTOS_USE_TIMERS
+static object_table_t software_timers;                         /* Software timers, slot index = timer ID */
+static software_timer_t* timer_wheel[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS]; /* Timer wheel buckets */
+static uint32_t timer_wheel_ticks = 0;                         /* Last tick processed by the wheel */
+static uint32_t timer_wheel_count = 0;                         /* Timers linked into the wheel */
+
+/* Default table storage (timer_init): no heap for MAX_SOFTWARE_TIMERS timers */
+static uint8_t timer_storage[POOL_REGION_SIZE(sizeof(software_timer_t), MAX_SOFTWARE_TIMERS)] __attribute__((aligned(MEMORY_ALIGNMENT)));
+static uint16_t timer_generations[MAX_SOFTWARE_TIMERS];
+#endif
+
+#if RTOS_USE_TIMER_DAEMON
+/* One expiration handed from the tick to the daemon */
+typedef struct {
+    uint8_t timer_id;                       /* Expired timer */
+    uint8_t generation;                     /* Timer generation when it expired */
+} timer_command_t;
+
+static timer_command_t timer_command_queue[TIMER_COMMAND_QUEUE_LENGTH];  /* Expired timers */
+static uint32_t timer_command_head = 0;                        /* Next entry written by the ISR */
+static uint32_t timer_command_tail = 0;                        /* Next entry read by the daemon */
+static uint8_t timer_daemon_id = 0xFF;                         /* Timer daemon task ID */
+static uint32_t timer_daemon_stack[TASK_STACK_WORDS(TIMER_DAEMON_STACK_SIZE)]; /* Daemon stack */
+#endif
+
 /* ============================================================================
  * PRIVATE FUNCTION PROTOTYPES
  * ============================================================================ */
-static uint8_t timer_find_free_slot(void);
+#if RTOS_USE_TIMERS
+static software_timer_t* timer_lookup(uint8_t timer_id);
 static void timer_process_software_timers(void);
 static void timer_execute_callback(uint8_t timer_id);
+static uint32_t timer_get_next_expiry(void);
+static void timer_step_software_timers(uint32_t ticks);
+static uint32_t timer_period_ticks(const software_timer_t* timer);
+static void timer_arm(software_timer_t* timer);
+static void timer_wheel_insert(software_timer_t* timer);
+static void timer_wheel_remove(software_timer_t* timer);
+static void timer_wheel_cascade(uint32_t level);
+#endif
+#if RTOS_USE_TIMER_DAEMON
+static void timer_daemon_task(void);
+#endif
 
 /* ============================================================================
  * PUBLIC FUNCTIONS - SYSTEM TIMER
@@ -35,25 +80,51 @@ static void timer_execute_callback(uint8_t timer_id);
  * @brief Initialize the timer manager
  */
 rtos_result_t timer_init(void)
+{
+    return timer_init_capacity(MAX_SOFTWARE_TIMERS);
+}
+
+/**
+ * @brief Initialize the timer manager with a run-time software timer limit
+ */
+rtos_result_t timer_init_capacity(uint8_t max_timers)
 {
     if(timer_initialized)
     {
         return RTOS_SUCCESS;
     }
     
-    /* Initialize software timers */
-    for(int i = 0; i < MAX_SOFTWARE_TIMERS; i++)
+#if RTOS_USE_TIMERS
+    if(max_timers == 0)
     {
-        software_timers[i].timer_id = i;
-        software_timers[i].type = TIMER_TYPE_ONE_SHOT;
-        software_timers[i].state = TIMER_STATE_STOPPED;
-        software_timers[i].period_ms = 0;
-        software_timers[i].remaining_ms = 0;
-        software_timers[i].callback = NULL;
-        software_timers[i].user_data = NULL;
-        software_timers[i].is_active = false;
+        return RTOS_INVALID_PARAM;
     }
     
+    /* Every slot starts free: the pool's free stack hands out IDs in O(1) */
+    rtos_result_t result;
+    if(max_timers <= MAX_SOFTWARE_TIMERS)
+    {
+        result = object_table_create_static(&software_timers, timer_storage, timer_generations,
+                                            sizeof(software_timer_t), max_timers);
+    }
+    else
+    {
+        result = object_table_create(&software_timers, sizeof(software_timer_t), max_timers);
+    }
+    
+    if(result != RTOS_SUCCESS)
+    {
+        return result;
+    }
+    
+    /* Empty timer wheel */
+    memset(timer_wheel, 0, sizeof(timer_wheel));
+    timer_wheel_ticks = 0;
+    timer_wheel_count = 0;
+#else
+    UNUSED(max_timers);
+#endif
+    
     /* Initialize statistics */
     memset(&stats, 0, sizeof(timer_stats_t));
     
@@ -61,6 +132,18 @@ rtos_result_t timer_init(void)
     system_tick_counter = 0;
     timer_running = false;
     
+#if RTOS_USE_TIMER_DAEMON
+    /* Callbacks run in their own task, fed from the tick ISR */
+    timer_command_head = 0;
+    timer_command_tail = 0;
+    timer_daemon_id = task_create_static(timer_daemon_task, "TMR", TIMER_DAEMON_PRIORITY,
+                                         timer_daemon_stack, TIMER_DAEMON_STACK_SIZE);
+    if(timer_daemon_id == 0xFF)
+    {
+        return RTOS_ERROR;
+    }
+#endif
+    
     timer_initialized = true;
     
     DEBUG_PRINT("Timer Manager initialized\n");
@@ -78,8 +161,12 @@ rtos_result_t timer_start(void)
         return RTOS_ERROR;
     }
     
-    /* In real implementation, this would configure hardware timer */
-    /* For simulation, we'll just set the running flag */
+    /* Drive the system tick from SysTick */
+    if(cortex_m_systick_config(SYSTEM_CLOCK_HZ / TICK_RATE_HZ) != RTOS_SUCCESS)
+    {
+        return RTOS_ERROR;
+    }
+    
     timer_running = true;
     
     DEBUG_PRINT("System timer started\n");
@@ -97,6 +184,7 @@ rtos_result_t timer_stop(void)
         return RTOS_ERROR;
     }
     
+    cortex_m_systick_stop();
     timer_running = false;
     
     DEBUG_PRINT("System timer stopped\n");
@@ -146,16 +234,17 @@ void timer_interrupt_handler(void)
         return;
     }
     
-    uint32_t interrupt_start_time = system_tick_counter;
+#if RTOS_USE_STATS
+    uint32_t interrupt_start_time = DWT_CYCCNT_REG;
+#endif
     
     /* Increment system tick counter */
     system_tick_counter++;
     
-    /* Update statistics */
-    stats.timer_interrupts++;
-    
+#if RTOS_USE_TIMERS
     /* Process software timers */
     timer_process_software_timers();
+#endif
     
     /* Call scheduler tick */
     if(scheduler_is_running())
@@ -163,16 +252,116 @@ void timer_interrupt_handler(void)
         scheduler_tick();
     }
     
+#if RTOS_USE_STATS
     /* Update interrupt timing statistics */
-    uint32_t interrupt_time = system_tick_counter - interrupt_start_time;
+    uint32_t interrupt_time = DWT_CYCCNT_REG - interrupt_start_time;
+    stats.timer_interrupts++;
     stats.total_interrupt_time += interrupt_time;
     
     if(interrupt_time > stats.max_interrupt_time)
     {
         stats.max_interrupt_time = interrupt_time;
     }
+#endif
+}
+
+/**
+ * @brief SysTick exception handler (overrides weak handler in startup_ARMCM3.s)
+ */
+void SysTick_Handler(void)
+{
+    RTOS_TRACE_ISR_ENTER();
+    RTOS_LATENCY_ISR_ENTER(&rtos_latency_systick);
+    
+    timer_interrupt_handler();
+    
+    RTOS_LATENCY_ISR_EXIT(&rtos_latency_systick);
+    RTOS_TRACE_ISR_EXIT();
+}
+
+/**
+ * @brief Sleep until the next task delay or software timer deadline
+ */
+void timer_tickless_idle(void)
+{
+    const uint32_t cycles_per_tick = SYSTEM_CLOCK_HZ / TICK_RATE_HZ;
+    const uint32_t max_idle_ticks = 0x00FFFFFF / cycles_per_tick;
+    
+    /* Nearest deadline decides how long we may sleep */
+    uint32_t idle_ticks = task_get_next_wakeup();
+    
+#if RTOS_USE_TIMERS
+    uint32_t timer_ticks = timer_get_next_expiry();
+    
+    if(timer_ticks < idle_ticks)
+    {
+        idle_ticks = timer_ticks;
+    }
+#endif
+    
+    if(!timer_running || idle_ticks < TICKLESS_MIN_IDLE_TICKS)
+    {
+        /* Not worth it - just sleep until the next tick */
+        __WFI();
+        return;
+    }
+    
+    if(idle_ticks > max_idle_ticks)
+    {
+        idle_ticks = max_idle_ticks;
+    }
+    
+    /* Stop the tick and note how much of the current tick is left */
+    cortex_m_systick_stop();
+    uint32_t tick_remaining = SYSTICK_VAL_REG;
+    if(tick_remaining == 0 || tick_remaining > cycles_per_tick)
+    {
+        tick_remaining = cycles_per_tick;
+    }
+    
+    /* One long SysTick period ending on the deadline tick */
+    uint32_t sleep_cycles = tick_remaining + (idle_ticks - 1) * cycles_per_tick;
+    cortex_m_systick_config(sleep_cycles);
+    
+    __WFI();
+    
+    /* Read CTRL once: reading it clears COUNTFLAG */
+    uint32_t ctrl = SYSTICK_CTRL_REG;
+    uint32_t remaining_cycles = SYSTICK_VAL_REG;
+    cortex_m_systick_stop();
+    
+    uint32_t complete_ticks;
+    uint32_t next_period;
+    
+    if(ctrl & SYSTICK_COUNTFLAG)
+    {
+        /* Slept to the deadline. The pending SysTick interrupt accounts
+         * for the last tick, so only step the ones before it. */
+        complete_ticks = idle_ticks - 1;
+        uint32_t since_wrap = (sleep_cycles - 1) - remaining_cycles;
+        next_period = (since_wrap < cycles_per_tick) ? (cycles_per_tick - since_wrap) : cycles_per_tick;
+    }
+    else
+    {
+        /* Woken early by another interrupt */
+        uint32_t elapsed = (cycles_per_tick - tick_remaining) + (sleep_cycles - remaining_cycles);
+        complete_ticks = elapsed / cycles_per_tick;
+        next_period = cycles_per_tick - (elapsed % cycles_per_tick);
+    }
+    
+    /* Catch up on the ticks that never fired (no deadline lies inside them) */
+    system_tick_counter += complete_ticks;
+    task_step_delays(complete_ticks);
+#if RTOS_USE_TIMERS
+    timer_step_software_timers(complete_ticks);
+#endif
+    
+    /* Finish the current tick, then fall back to the normal period */
+    cortex_m_systick_config(next_period);
+    SYSTICK_LOAD_REG = cycles_per_tick - 1;
 }
 
+#if RTOS_USE_TIMERS
 /* ============================================================================
  * SOFTWARE TIMER FUNCTIONS
  * ============================================================================ */
@@ -190,21 +379,28 @@ uint8_t timer_create(timer_type_t type,
         return TIMER_INVALID_ID;
     }
     
-    uint8_t timer_id = timer_find_free_slot();
-    if(timer_id == TIMER_INVALID_ID)
+    /* Pop a free slot: its index is the timer ID */
+    timer_handle_t handle;
+    software_timer_t* timer = (software_timer_t*)object_alloc(&software_timers, &handle);
+    if(timer == NULL)
     {
         return TIMER_INVALID_ID;
     }
     
-    software_timer_t* timer = &software_timers[timer_id];
+    uint8_t timer_id = (uint8_t)(handle & OBJECT_HANDLE_INDEX_MASK);
     
-    /* Initialize timer */
+    /* Initialize timer (generation carries on across reuse of the slot) */
+    timer->timer_id = timer_id;
+    timer->handle = handle;
     timer->type = type;
     timer->state = TIMER_STATE_STOPPED;
     timer->period_ms = period_ms;
-    timer->remaining_ms = period_ms;
+    timer->expiry_tick = 0;
     timer->callback = callback;
     timer->user_data = user_data;
+    timer->wheel_slot = NULL;
+    timer->wheel_next = NULL;
+    timer->wheel_prev = NULL;
     timer->is_active = true;
     
     DEBUG_PRINT("Software timer %d created (%s, %u ms)\n", 
@@ -215,28 +411,85 @@ uint8_t timer_create(timer_type_t type,
     return timer_id;
 }
 
+/**
+ * @brief Create a software timer and return its handle
+ */
+timer_handle_t timer_create_handle(timer_type_t type,
+                                   uint32_t period_ms,
+                                   timer_callback_t callback,
+                                   void* user_data)
+{
+    uint8_t timer_id = timer_create(type, period_ms, callback, user_data);
+    
+    if(timer_id == TIMER_INVALID_ID)
+    {
+        return OBJECT_HANDLE_INVALID;
+    }
+    
+    return timer_lookup(timer_id)->handle;
+}
+
+/**
+ * @brief Delete a software timer by handle
+ */
+rtos_result_t timer_delete_handle(timer_handle_t handle)
+{
+    uint8_t timer_id = timer_handle_get_id(handle);
+    
+    if(timer_id == TIMER_INVALID_ID)
+    {
+        return RTOS_ERROR;
+    }
+    
+    return timer_delete(timer_id);
+}
+
+/**
+ * @brief Get the timer ID behind a handle
+ */
+uint8_t timer_handle_get_id(timer_handle_t handle)
+{
+    software_timer_t* timer = (software_timer_t*)object_get(&software_timers, handle);
+    
+    if(timer == NULL || !timer->is_active)
+    {
+        return TIMER_INVALID_ID;
+    }
+    
+    return timer->timer_id;
+}
+
 /**
  * @brief Delete a software timer
  */
 rtos_result_t timer_delete(uint8_t timer_id)
 {
-    if(!timer_initialized || timer_id >= MAX_SOFTWARE_TIMERS)
+    if(!timer_initialized || timer_id >= software_timers.capacity)
     {
         return RTOS_INVALID_PARAM;
     }
     
-    software_timer_t* timer = &software_timers[timer_id];
+    software_timer_t* timer = timer_lookup(timer_id);
     
-    if(!timer->is_active)
+    if(timer == NULL || !timer->is_active)
     {
         return RTOS_ERROR;
     }
     
+    ENTER_CRITICAL();
+    
+    timer_wheel_remove(timer);
+    timer->generation++; /* Expirations already posted to the daemon are void */
+    
     /* Mark timer as inactive */
     timer->is_active = false;
     timer->state = TIMER_STATE_STOPPED;
     timer->callback = NULL;
     
+    EXIT_CRITICAL();
+    
+    object_free(&software_timers, timer->handle);
+    
     DEBUG_PRINT("Software timer %d deleted\n", timer_id);
     
     return RTOS_SUCCESS;
@@ -247,22 +500,21 @@ rtos_result_t timer_delete(uint8_t timer_id)
  */
 rtos_result_t timer_start_timer(uint8_t timer_id)
 {
-    if(!timer_initialized || timer_id >= MAX_SOFTWARE_TIMERS)
+    if(!timer_initialized || timer_id >= software_timers.capacity)
     {
         return RTOS_INVALID_PARAM;
     }
     
-    software_timer_t* timer = &software_timers[timer_id];
+    software_timer_t* timer = timer_lookup(timer_id);
     
-    if(!timer->is_active)
+    if(timer == NULL || !timer->is_active)
     {
         return RTOS_ERROR;
     }
     
     ENTER_CRITICAL();
     
-    timer->state = TIMER_STATE_RUNNING;
-    timer->remaining_ms = timer->period_ms;
+    timer_arm(timer);
     
     EXIT_CRITICAL();
     
@@ -276,21 +528,23 @@ rtos_result_t timer_start_timer(uint8_t timer_id)
  */
 rtos_result_t timer_stop_timer(uint8_t timer_id)
 {
-    if(!timer_initialized || timer_id >= MAX_SOFTWARE_TIMERS)
+    if(!timer_initialized || timer_id >= software_timers.capacity)
     {
         return RTOS_INVALID_PARAM;
     }
     
-    software_timer_t* timer = &software_timers[timer_id];
+    software_timer_t* timer = timer_lookup(timer_id);
     
-    if(!timer->is_active)
+    if(timer == NULL || !timer->is_active)
     {
         return RTOS_ERROR;
     }
     
     ENTER_CRITICAL();
     
+    timer_wheel_remove(timer);
     timer->state = TIMER_STATE_STOPPED;
+    timer->generation++; /* Expirations already posted to the daemon are void */
     
     EXIT_CRITICAL();
     
@@ -304,22 +558,21 @@ rtos_result_t timer_stop_timer(uint8_t timer_id)
  */
 rtos_result_t timer_reset_timer(uint8_t timer_id)
 {
-    if(!timer_initialized || timer_id >= MAX_SOFTWARE_TIMERS)
+    if(!timer_initialized || timer_id >= software_timers.capacity)
     {
         return RTOS_INVALID_PARAM;
     }
     
-    software_timer_t* timer = &software_timers[timer_id];
+    software_timer_t* timer = timer_lookup(timer_id);
     
-    if(!timer->is_active)
+    if(timer == NULL || !timer->is_active)
     {
         return RTOS_ERROR;
     }
     
     ENTER_CRITICAL();
     
-    timer->remaining_ms = timer->period_ms;
-    timer->state = TIMER_STATE_RUNNING;
+    timer_arm(timer);
     
     EXIT_CRITICAL();
     
@@ -333,14 +586,14 @@ rtos_result_t timer_reset_timer(uint8_t timer_id)
  */
 rtos_result_t timer_change_period(uint8_t timer_id, uint32_t new_period_ms)
 {
-    if(!timer_initialized || timer_id >= MAX_SOFTWARE_TIMERS || new_period_ms == 0)
+    if(!timer_initialized || timer_id >= software_timers.capacity || new_period_ms == 0)
     {
         return RTOS_INVALID_PARAM;
     }
     
-    software_timer_t* timer = &software_timers[timer_id];
+    software_timer_t* timer = timer_lookup(timer_id);
     
-    if(!timer->is_active)
+    if(timer == NULL || !timer->is_active)
     {
         return RTOS_ERROR;
     }
@@ -349,10 +602,10 @@ rtos_result_t timer_change_period(uint8_t timer_id, uint32_t new_period_ms)
     
     timer->period_ms = new_period_ms;
     
-    /* If timer is running, update remaining time */
+    /* If timer is running, restart it with the new period */
     if(timer->state == TIMER_STATE_RUNNING)
     {
-        timer->remaining_ms = new_period_ms;
+        timer_arm(timer);
     }
     
     EXIT_CRITICAL();
@@ -367,17 +620,14 @@ rtos_result_t timer_change_period(uint8_t timer_id, uint32_t new_period_ms)
  */
 timer_state_t timer_get_state(uint8_t timer_id)
 {
-    if(!timer_initialized || timer_id >= MAX_SOFTWARE_TIMERS)
-    {
-        return TIMER_STATE_STOPPED;
-    }
+    software_timer_t* timer = timer_initialized ? timer_lookup(timer_id) : NULL;
     
-    if(!software_timers[timer_id].is_active)
+    if(timer == NULL || !timer->is_active)
     {
         return TIMER_STATE_STOPPED;
     }
     
-    return software_timers[timer_id].state;
+    return timer->state;
 }
 
 /**
@@ -385,19 +635,18 @@ timer_state_t timer_get_state(uint8_t timer_id)
  */
 uint32_t timer_get_remaining_time(uint8_t timer_id)
 {
-    if(!timer_initialized || timer_id >= MAX_SOFTWARE_TIMERS)
-    {
-        return 0;
-    }
+    software_timer_t* timer = timer_initialized ? timer_lookup(timer_id) : NULL;
     
-    if(!software_timers[timer_id].is_active)
+    if(timer == NULL || !timer->is_active || timer->state != TIMER_STATE_RUNNING)
     {
         return 0;
     }
     
-    return software_timers[timer_id].remaining_ms;
+    return timer_ticks_to_ms(timer->expiry_tick - timer_wheel_ticks);
 }
 
+#endif /* RTOS_USE_TIMERS */
+
 /* ============================================================================
  * DELAY FUNCTIONS
  * ============================================================================ */
@@ -505,6 +754,7 @@ void timer_reset_stats(void)
     stats.max_interrupt_time = 0;
     stats.total_interrupt_time = 0;
     stats.software_timer_expirations = 0;
+    stats.daemon_queue_overflows = 0;
     /* Keep system_ticks running */
     
     EXIT_CRITICAL();
@@ -529,8 +779,10 @@ void timer_print_info(void)
     DEBUG_PRINT("Missed Ticks: %u\n", stats.missed_ticks);
     DEBUG_PRINT("Max Interrupt Time: %u\n", stats.max_interrupt_time);
     DEBUG_PRINT("Software Timer Expirations: %u\n", stats.software_timer_expirations);
+    DEBUG_PRINT("Daemon Queue Overflows: %u\n", stats.daemon_queue_overflows);
 }
 
+#if RTOS_USE_TIMERS
 /**
  * @brief Print software timers status
  */
@@ -543,11 +795,11 @@ void timer_print_software_timers(void)
     
     DEBUG_PRINT("=== Software Timers ===\n");
     
-    for(int i = 0; i < MAX_SOFTWARE_TIMERS; i++)
+    for(uint32_t i = 0; i < software_timers.capacity; i++)
     {
-        software_timer_t* timer = &software_timers[i];
+        software_timer_t* timer = timer_lookup((uint8_t)i);
         
-        if(timer->is_active)
+        if(timer != NULL && timer->is_active)
         {
             const char* type_str = (timer->type == TIMER_TYPE_ONE_SHOT) ? "One-shot" : "Periodic";
             const char* state_str;
@@ -561,29 +813,134 @@ void timer_print_software_timers(void)
             }
             
             DEBUG_PRINT("Timer %d: %s, %s, Period: %u ms, Remaining: %u ms\n",
-                       i, type_str, state_str, timer->period_ms, timer->remaining_ms);
+                       i, type_str, state_str, timer->period_ms, timer_get_remaining_time((uint8_t)i));
         }
     }
 }
+#endif
 
 /* ============================================================================
  * PRIVATE FUNCTIONS
  * ============================================================================ */
 
+#if RTOS_USE_TIMERS
+/**
+ * @brief Resolve a timer ID to its slot (NULL if free or out of range)
+ */
+static software_timer_t* timer_lookup(uint8_t timer_id)
+{
+    return (software_timer_t*)object_get_index(&software_timers, timer_id);
+}
+
 /**
- * @brief Find free timer slot
+ * @brief Timer period in ticks (never less than one tick)
  */
-static uint8_t timer_find_free_slot(void)
+static uint32_t timer_period_ticks(const software_timer_t* timer)
 {
-    for(int i = 0; i < MAX_SOFTWARE_TIMERS; i++)
+    uint32_t ticks = timer_ms_to_ticks(timer->period_ms);
+    
+    return (ticks > 0) ? ticks : 1;
+}
+
+/**
+ * @brief (Re)start a timer one period from now
+ * @note Must be called inside a critical section
+ */
+static void timer_arm(software_timer_t* timer)
+{
+    timer_wheel_remove(timer);
+    
+    timer->expiry_tick = timer_wheel_ticks + timer_period_ticks(timer);
+    timer->state = TIMER_STATE_RUNNING;
+    
+    timer_wheel_insert(timer);
+}
+
+/**
+ * @brief Link a timer into the wheel bucket matching its expiry tick
+ * @note Must be called inside a critical section
+ */
+static void timer_wheel_insert(software_timer_t* timer)
+{
+    uint32_t delta = timer->expiry_tick - timer_wheel_ticks;
+    uint32_t when = timer->expiry_tick;
+    uint32_t level = 0;
+    
+    /* Lowest level whose range still covers the timeout */
+    while(level < (TIMER_WHEEL_LEVELS - 1) &&
+          delta >= (1UL << ((level + 1) * TIMER_WHEEL_BITS)))
     {
-        if(!software_timers[i].is_active)
-        {
-            return i;
-        }
+        level++;
+    }
+    
+    /* Out of range: park in the farthest slot, it is re-placed on cascade */
+    if(delta >= TIMER_WHEEL_RANGE)
+    {
+        when = timer_wheel_ticks + TIMER_WHEEL_RANGE - 1;
+    }
+    
+    software_timer_t** slot = &timer_wheel[level][(when >> (level * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK];
+    
+    timer->wheel_slot = slot;
+    timer->wheel_prev = NULL;
+    timer->wheel_next = *slot;
+    
+    if(*slot != NULL)
+    {
+        (*slot)->wheel_prev = timer;
     }
     
-    return TIMER_INVALID_ID;
+    *slot = timer;
+    timer_wheel_count++;
+}
+
+/**
+ * @brief Unlink a timer from its wheel bucket (no-op if not linked)
+ * @note Must be called inside a critical section
+ */
+static void timer_wheel_remove(software_timer_t* timer)
+{
+    if(timer->wheel_slot == NULL)
+    {
+        return;
+    }
+    
+    if(timer->wheel_prev != NULL)
+    {
+        timer->wheel_prev->wheel_next = timer->wheel_next;
+    }
+    else
+    {
+        *timer->wheel_slot = timer->wheel_next;
+    }
+    
+    if(timer->wheel_next != NULL)
+    {
+        timer->wheel_next->wheel_prev = timer->wheel_prev;
+    }
+    
+    timer->wheel_slot = NULL;
+    timer->wheel_next = NULL;
+    timer->wheel_prev = NULL;
+    timer_wheel_count--;
+}
+
+/**
+ * @brief Redistribute the current slot of a higher level into the levels below
+ * @note Must be called inside a critical section
+ */
+static void timer_wheel_cascade(uint32_t level)
+{
+    uint32_t index = (timer_wheel_ticks >> (level * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+    software_timer_t** slot = &timer_wheel[level][index];
+    software_timer_t* timer;
+    
+    /* Re-inserted timers always land in a different slot */
+    while((timer = *slot) != NULL)
+    {
+        timer_wheel_remove(timer);
+        timer_wheel_insert(timer);
+    }
 }
 
 /**
@@ -591,50 +948,181 @@ static uint8_t timer_find_free_slot(void)
  */
 static void timer_process_software_timers(void)
 {
-    for(int i = 0; i < MAX_SOFTWARE_TIMERS; i++)
+    ENTER_CRITICAL();
+    
+    timer_wheel_ticks++;
+    
+    /* Each level cascades when all the levels below it wrap */
+    for(uint32_t level = 1; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        if((timer_wheel_ticks & ((1UL << (level * TIMER_WHEEL_BITS)) - 1)) != 0)
+        {
+            break;
+        }
+        
+        timer_wheel_cascade(level);
+    }
+    
+    /* Everything in the current level 0 slot expires now */
+    software_timer_t** slot = &timer_wheel[0][timer_wheel_ticks & TIMER_WHEEL_MASK];
+    software_timer_t* timer;
+    bool posted = false;
+    
+    while((timer = *slot) != NULL)
+    {
+        timer_wheel_remove(timer);
+#if RTOS_USE_STATS
+        stats.software_timer_expirations++;
+#endif
+        
+        if(timer->type == TIMER_TYPE_PERIODIC)
+        {
+            /* Restart periodic timer relative to its expiry, so it does not drift */
+            timer->expiry_tick += timer_period_ticks(timer);
+            timer_wheel_insert(timer);
+        }
+        else
+        {
+            /* One-shot timer - stop it */
+            timer->state = TIMER_STATE_EXPIRED;
+        }
+        
+#if RTOS_USE_TIMER_DAEMON
+        /* Hand the callback to the daemon task */
+        uint32_t next_head = (timer_command_head + 1) % TIMER_COMMAND_QUEUE_LENGTH;
+        if(next_head != timer_command_tail)
+        {
+            timer_command_queue[timer_command_head].timer_id = timer->timer_id;
+            timer_command_queue[timer_command_head].generation = timer->generation;
+            timer_command_head = next_head;
+            posted = true;
+        }
+        else
+        {
+#if RTOS_USE_STATS
+            stats.daemon_queue_overflows++;
+#endif
+        }
+#else
+        /* Execute callback outside critical section */
+        EXIT_CRITICAL();
+        timer_execute_callback(timer->timer_id);
+        ENTER_CRITICAL();
+#endif
+    }
+    
+    EXIT_CRITICAL();
+    
+#if RTOS_USE_TIMER_DAEMON
+    /* Wake the daemon if it went to sleep on an empty queue */
+    if(posted)
+    {
+        task_resume(timer_daemon_id);
+    }
+#else
+    UNUSED(posted);
+#endif
+}
+
+/**
+ * @brief Get ticks until the wheel next has work to do (expiry or cascade)
+ * @note Cascades of empty slots are skipped, so this is the real deadline for
+ *       timers in level 0 and a safe lower bound for the others
+ */
+static uint32_t timer_get_next_expiry(void)
+{
+    uint32_t next_expiry = 0xFFFFFFFF;
+    
+    if(timer_wheel_count == 0)
+    {
+        return next_expiry;
+    }
+    
+    for(uint32_t level = 0; level < TIMER_WHEEL_LEVELS; level++)
     {
-        software_timer_t* timer = &software_timers[i];
+        uint32_t shift = level * TIMER_WHEEL_BITS;
+        uint32_t index = (timer_wheel_ticks >> shift) & TIMER_WHEEL_MASK;
         
-        if(timer->is_active && timer->state == TIMER_STATE_RUNNING)
+        for(uint32_t k = 1; k <= TIMER_WHEEL_SLOTS; k++)
         {
-            if(timer->remaining_ms > 0)
+            if(timer_wheel[level][(index + k) & TIMER_WHEEL_MASK] != NULL)
             {
-                timer->remaining_ms--;
+                uint32_t event_tick = ((timer_wheel_ticks >> shift) + k) << shift;
+                uint32_t ticks = event_tick - timer_wheel_ticks;
                 
-                if(timer->remaining_ms == 0)
+                if(ticks < next_expiry)
                 {
-                    /* Timer expired */
-                    stats.software_timer_expirations++;
-                    
-                    if(timer->type == TIMER_TYPE_PERIODIC)
-                    {
-                        /* Restart periodic timer */
-                        timer->remaining_ms = timer->period_ms;
-                    }
-                    else
-                    {
-                        /* One-shot timer - stop it */
-                        timer->state = TIMER_STATE_EXPIRED;
-                    }
-                    
-                    /* Execute callback outside critical section */
-                    timer_execute_callback(i);
+                    next_expiry = ticks;
                 }
+                break;
             }
         }
     }
+    
+    return next_expiry;
 }
 
+/**
+ * @brief Advance the timer wheel by several ticks (tickless idle)
+ * @note ticks is always less than timer_get_next_expiry(), so no slot on the
+ *       way expires or needs cascading
+ */
+static void timer_step_software_timers(uint32_t ticks)
+{
+    timer_wheel_ticks += ticks;
+}
+
+#if RTOS_USE_TIMER_DAEMON
+/**
+ * @brief Timer daemon task - runs callbacks posted by the tick ISR
+ */
+static void timer_daemon_task(void)
+{
+    while(1)
+    {
+        ENTER_CRITICAL();
+        
+        if(timer_command_tail == timer_command_head)
+        {
+            /* Nothing queued: suspend until the ISR resumes us. The state
+             * change happens before interrupts are re-enabled, so a post
+             * cannot slip in between the check and the suspend. */
+            task_suspend(timer_daemon_id);
+            EXIT_CRITICAL();
+            continue;
+        }
+        
+        timer_command_t command = timer_command_queue[timer_command_tail];
+        timer_command_tail = (timer_command_tail + 1) % TIMER_COMMAND_QUEUE_LENGTH;
+        
+        /* A task that outranks us may have stopped, deleted or re-created
+         * the timer since the tick posted this: then the expiry is stale */
+        software_timer_t* timer = timer_lookup(command.timer_id);
+        bool current = timer != NULL && timer->is_active && timer->generation == command.generation;
+        
+        EXIT_CRITICAL();
+        
+        if(current)
+        {
+            timer_execute_callback(command.timer_id);
+        }
+    }
+}
+#endif
+
 /**
  * @brief Execute timer callback
  */
 static void timer_execute_callback(uint8_t timer_id)
 {
-    software_timer_t* timer = &software_timers[timer_id];
+    software_timer_t* timer = timer_lookup(timer_id);
     
-    if(timer->callback != NULL)
+    if(timer != NULL && timer->callback != NULL)
     {
+        RTOS_TRACE(TRACE_EVENT_TIMER_FIRE, timer_id);
+        
         /* Call callback function */
         timer->callback(timer_id, timer->user_data);
     }
-}
\ No newline at end of file
+}
+#endif /* RTOS_USE_TIMERS */
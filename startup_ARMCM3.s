@@ -154,8 +154,40 @@ DebugMon_Handler\
                 B       .
                 ENDP
 PendSV_Handler  PROC
-                EXPORT  PendSV_Handler            [WEAK]
-                B       .
+                EXPORT  PendSV_Handler
+                IMPORT  scheduler_current_tcb
+                IMPORT  scheduler_next_tcb
+                IMPORT  scheduler_runtime_switch
+                IMPORT  rtos_latency_pendsv_exit
+                IMPORT  cortex_m_syscall_basepri
+                LDR     R0, =cortex_m_syscall_basepri
+                LDR     R0, [R0]
+                MSR     BASEPRI, R0               ; Keep TCB pointers stable (kernel IRQs only)
+                DSB
+                ISB
+                PUSH    {R0, LR}                  ; Keep EXC_RETURN, 8-byte aligned
+                BL      scheduler_runtime_switch  ; Close outgoing run slice
+                POP     {R0, LR}
+                LDR     R2, =scheduler_current_tcb
+                LDR     R1, [R2]                  ; R1 = current TCB
+                CBZ     R1, PendSV_Restore        ; First switch: nothing to save
+                MRS     R0, PSP
+                STMDB   R0!, {R4-R11}             ; Save callee-saved registers
+                STR     R0, [R1]                  ; current->stack_pointer = PSP
+PendSV_Restore
+                LDR     R3, =scheduler_next_tcb
+                LDR     R1, [R3]                  ; R1 = next TCB
+                STR     R1, [R2]                  ; current = next
+                LDR     R0, [R1]                  ; R0 = next->stack_pointer
+                LDMIA   R0!, {R4-R11}             ; Restore callee-saved registers
+                MSR     PSP, R0
+                ORR     LR, LR, #0x04             ; Return to thread mode on PSP
+                PUSH    {R0, LR}
+                BL      rtos_latency_pendsv_exit  ; Close PendSV measurement
+                POP     {R0, LR}
+                MOV     R0, #0
+                MSR     BASEPRI, R0               ; PendSV only runs outside critical sections
+                BX      LR
                 ENDP
 SysTick_Handler PROC
                 EXPORT  SysTick_Handler           [WEAK]